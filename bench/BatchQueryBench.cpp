@@ -0,0 +1,61 @@
+#include <vector>
+#include "BatchQuery.hpp"
+#include "Bench.hpp"
+#include "ExecutorPool.hpp"
+
+namespace
+{
+constexpr std::size_t FLEET_SIZE = 100000;
+
+struct Fleet
+{
+    Fleet(void) : pool(FLEET_SIZE)
+    {
+        for (std::size_t i = 0; i < FLEET_SIZE; ++i) {
+            handles.push_back(pool.Acquire({static_cast<int>(i), 0, 'N'}));
+            executors.push_back(handles.back().get());
+        }
+    }
+
+    adas::ExecutorPool pool;
+    std::vector<adas::ExecutorPool::Handle> handles;
+    std::vector<const adas::Executor*> executors;
+};
+}  // namespace
+
+BENCHMARK(QueryVirtualPerExecutor)
+{
+    state.PauseTiming();
+    Fleet fleet;
+    std::vector<int> x(FLEET_SIZE);
+    std::vector<int> y(FLEET_SIZE);
+    std::vector<char> heading(FLEET_SIZE);
+    state.ResumeTiming();
+
+    state.SetItemsPerIteration(FLEET_SIZE);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (std::size_t j = 0; j < FLEET_SIZE; ++j) {
+            const adas::Pose pose = fleet.executors[j]->Query();
+            x[j] = pose.x;
+            y[j] = pose.y;
+            heading[j] = pose.heading;
+        }
+        adas::bench::DoNotOptimize(x.back());
+    }
+}
+
+BENCHMARK(QueryBatchColumns)
+{
+    state.PauseTiming();
+    Fleet fleet;
+    std::vector<int> x(FLEET_SIZE);
+    std::vector<int> y(FLEET_SIZE);
+    std::vector<char> heading(FLEET_SIZE);
+    state.ResumeTiming();
+
+    state.SetItemsPerIteration(FLEET_SIZE);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        adas::QueryBatch(fleet.executors.data(), FLEET_SIZE, adas::PoseColumns{x.data(), y.data(), heading.data()});
+        adas::bench::DoNotOptimize(x.back());
+    }
+}
@@ -0,0 +1,182 @@
+#include "Bench.hpp"
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "PerfCounters.hpp"
+
+namespace adas
+{
+namespace bench
+{
+namespace
+{
+struct Scenario
+{
+    const char* name;
+    BenchFunction function;
+};
+
+std::vector<Scenario>& Scenarios(void)
+{
+    static std::vector<Scenario> scenarios;
+    return scenarios;
+}
+
+struct Options
+{
+    std::string filter;
+    double minSeconds{0.5};
+    bool perf{false};
+};
+
+Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--filter=", 9) == 0) {
+            options.filter = arg + 9;
+        } else if (std::strncmp(arg, "--min-time=", 11) == 0) {
+            options.minSeconds = std::atof(arg + 11);
+        } else if (std::strcmp(arg, "--perf") == 0) {
+            options.perf = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter=substr] [--min-time=seconds] [--perf]\n", argv[0]);
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+BenchState RunOnce(const Scenario& scenario, const std::uint64_t iterations, PerfCounters* perf)
+{
+    if (perf != nullptr) {
+        perf->Reset();
+    }
+    BenchState state(iterations, perf);
+    state.ResumeTiming();
+    scenario.function(state);
+    state.PauseTiming();
+    return state;
+}
+
+// 不可用的计数器输出n/a
+void PrintPerf(const PerfSample& sample, const double items)
+{
+    std::printf("%-40s", "");
+    if (sample.valid[PERF_CYCLES] && sample.valid[PERF_INSTRUCTIONS] && sample.values[PERF_CYCLES] != 0) {
+        std::printf(" IPC %5.2f", static_cast<double>(sample.values[PERF_INSTRUCTIONS]) / sample.values[PERF_CYCLES]);
+    } else {
+        std::printf(" IPC   n/a");
+    }
+    for (unsigned i = 0; i < PERF_EVENT_COUNT; ++i) {
+        const PerfEvent event = static_cast<PerfEvent>(i);
+        if (sample.valid[event] && items > 0) {
+            std::printf("  %s/item %.3f", PerfCounters::Name(event), sample.values[event] / items);
+        } else {
+            std::printf("  %s/item n/a", PerfCounters::Name(event));
+        }
+    }
+    std::printf("\n");
+}
+
+void Run(const Scenario& scenario, const Options& options, PerfCounters* perf)
+{
+    // 迭代次数逐步放大，直到单次运行超过最短时间
+    std::uint64_t iterations = 1;
+    for (;;) {
+        const BenchState state = RunOnce(scenario, iterations, perf);
+        const double seconds = std::chrono::duration<double>(state.Elapsed()).count();
+        if (seconds >= options.minSeconds || iterations >= (1ull << 40)) {
+            const double items = static_cast<double>(iterations * state.ItemsPerIteration());
+            std::printf("%-40s %12llu iters %12.1f ns/iter %14.0f items/s\n", scenario.name,
+                        static_cast<unsigned long long>(iterations), seconds * 1e9 / iterations,
+                        seconds > 0 ? items / seconds : 0.0);
+            if (perf != nullptr) {
+                PrintPerf(perf->Read(), items);
+            }
+            return;
+        }
+        const double scale = seconds > 0 ? options.minSeconds * 1.4 / seconds : 10.0;
+        iterations = static_cast<std::uint64_t>(iterations * (scale > 10.0 ? 10.0 : scale)) + 1;
+    }
+}
+}  // namespace
+
+BenchState::BenchState(const std::uint64_t iterations, PerfCounters* perf) noexcept
+    : iterations(iterations), perf(perf), running(false)
+{
+}
+
+std::uint64_t BenchState::Iterations(void) const noexcept
+{
+    return iterations;
+}
+
+void BenchState::SetItemsPerIteration(const std::uint64_t items) noexcept
+{
+    itemsPerIteration = items;
+}
+
+std::uint64_t BenchState::ItemsPerIteration(void) const noexcept
+{
+    return itemsPerIteration;
+}
+
+void BenchState::PauseTiming(void) noexcept
+{
+    if (running) {
+        elapsed += std::chrono::steady_clock::now() - start;
+        if (perf != nullptr) {
+            perf->Disable();
+        }
+        running = false;
+    }
+}
+
+void BenchState::ResumeTiming(void) noexcept
+{
+    if (!running) {
+        if (perf != nullptr) {
+            perf->Enable();
+        }
+        start = std::chrono::steady_clock::now();
+        running = true;
+    }
+}
+
+std::chrono::nanoseconds BenchState::Elapsed(void) const noexcept
+{
+    return elapsed;
+}
+
+BenchRegistrar::BenchRegistrar(const char* name, BenchFunction function) noexcept
+{
+    Scenarios().push_back({name, function});
+}
+}  // namespace bench
+}  // namespace adas
+
+int main(int argc, char** argv)
+{
+    using namespace adas::bench;
+    const Options options = ParseOptions(argc, argv);
+    // 计数器不可用(非Linux、权限不足、虚拟机未透传PMU)时只报告耗时
+    std::unique_ptr<PerfCounters> perf;
+    if (options.perf) {
+        perf.reset(new PerfCounters());
+        if (!perf->Open()) {
+            std::fprintf(stderr, "perf counters unavailable (%s), reporting timings only\n", perf->Error().c_str());
+            perf.reset();
+        }
+    }
+    for (const Scenario& scenario : Scenarios()) {
+        if (options.filter.empty() || std::string(scenario.name).find(options.filter) != std::string::npos) {
+            Run(scenario, options, perf.get());
+        }
+    }
+    return 0;
+}
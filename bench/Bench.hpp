@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace adas
+{
+namespace bench
+{
+class PerfCounters;
+
+class BenchState final
+{
+public:
+    // perf非空时，硬件计数器与计时同步启停
+    explicit BenchState(const std::uint64_t iterations, PerfCounters* perf = nullptr) noexcept;
+
+public:
+    std::uint64_t Iterations(void) const noexcept;
+
+    // 每轮迭代处理的条目数(指令数、执行器数等)，用于计算吞吐
+    void SetItemsPerIteration(const std::uint64_t items) noexcept;
+    std::uint64_t ItemsPerIteration(void) const noexcept;
+
+    // 计时默认覆盖整个场景函数，准备工作用Pause/Resume排除
+    void PauseTiming(void) noexcept;
+    void ResumeTiming(void) noexcept;
+    std::chrono::nanoseconds Elapsed(void) const noexcept;
+
+private:
+    std::uint64_t iterations;
+    std::uint64_t itemsPerIteration{1};
+    std::chrono::nanoseconds elapsed{0};
+    std::chrono::steady_clock::time_point start;
+    PerfCounters* perf;
+    bool running{true};
+};
+
+using BenchFunction = void (*)(BenchState&);
+
+class BenchRegistrar final
+{
+public:
+    BenchRegistrar(const char* name, BenchFunction function) noexcept;
+};
+
+template <typename T>
+inline void DoNotOptimize(const T& value) noexcept
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+}  // namespace bench
+}  // namespace adas
+
+#define BENCHMARK(name)                                                           \
+    static void name(adas::bench::BenchState& state);                             \
+    static const adas::bench::BenchRegistrar name##Registrar(#name, name);        \
+    static void name(adas::bench::BenchState& state)
@@ -0,0 +1,43 @@
+#include <string>
+#include "Bench.hpp"
+#include "CommandScanner.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+// 256MB的生成语料，多轮迭代后扫描总量达到GB级
+constexpr std::size_t CORPUS_SIZE = 1 << 28;
+
+const std::string& Corpus(void)
+{
+    static const std::string corpus = adas::WorkloadGenerator().Generate(CORPUS_SIZE);
+    return corpus;
+}
+
+void Scan(adas::bench::BenchState& state, const adas::ScanIsa isa)
+{
+    const std::string& corpus = Corpus();
+    const adas::CommandScanner scanner(isa);
+    std::size_t segments = 0;
+    state.SetItemsPerIteration(corpus.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        scanner.ForEachSegment(corpus.data(), corpus.size(), [&segments](const adas::CommandSegment&) { ++segments; });
+    }
+    adas::bench::DoNotOptimize(segments);
+}
+}  // namespace
+
+BENCHMARK(ScanSegmentsScalar)
+{
+    Scan(state, adas::ScanIsa::SCALAR);
+}
+
+BENCHMARK(ScanSegmentsSse2)
+{
+    Scan(state, adas::ScanIsa::SSE2);
+}
+
+BENCHMARK(ScanSegmentsAvx2)
+{
+    Scan(state, adas::ScanIsa::AVX2);
+}
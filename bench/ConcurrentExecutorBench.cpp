@@ -0,0 +1,75 @@
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Bench.hpp"
+#include "ConcurrentExecutor.hpp"
+
+namespace
+{
+constexpr int PRODUCERS = 4;
+constexpr std::uint64_t BATCHES_PER_PRODUCER = 20000;
+const std::string BATCH = "MMRMMLMM";
+
+template <typename Submit>
+void RunProducers(Submit submit)
+{
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&submit] {
+            for (std::uint64_t i = 0; i < BATCHES_PER_PRODUCER; ++i) {
+                submit();
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+}
+}  // namespace
+
+// 原来的做法：每次Execute都在互斥锁内调用
+BENCHMARK(MutexExecute4Producers)
+{
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    std::mutex mutex;
+    state.SetItemsPerIteration(PRODUCERS * BATCHES_PER_PRODUCER);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        RunProducers([&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            executor->Execute(BATCH);
+        });
+    }
+    adas::bench::DoNotOptimize(executor->Query());
+}
+
+// 提交到无锁队列，后台消费者执行；计时到所有批次执行完
+BENCHMARK(ConcurrentSubmit4Producers)
+{
+    adas::ConcurrentExecutor executor;
+    executor.Start();
+    state.SetItemsPerIteration(PRODUCERS * BATCHES_PER_PRODUCER);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        RunProducers([&] { executor.Submit(BATCH); });
+        while (executor.Executed() < (i + 1) * PRODUCERS * BATCHES_PER_PRODUCER) {
+            std::this_thread::yield();
+        }
+    }
+    executor.Stop();
+    adas::bench::DoNotOptimize(executor.Vehicle().Query());
+}
+
+// 单个生产者提交一个批次并等它执行完的往返时间，消费者空闲时处于自旋阶段
+BENCHMARK(ConcurrentRoundTrip)
+{
+    adas::ConcurrentExecutor executor;
+    executor.Start();
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor.Submit(BATCH);
+        while (executor.Executed() <= i) {
+            std::this_thread::yield();
+        }
+    }
+    executor.Stop();
+}
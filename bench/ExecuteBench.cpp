@@ -0,0 +1,120 @@
+#include <memory>
+#include <string>
+#include "Bench.hpp"
+#include "Executor.hpp"
+#include "ExecutorListener.hpp"
+#include "VehicleTypes.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 20;
+
+// 以M为主、夹杂转向/加速/倒车/车型切换的固定指令串
+const std::string& MixedCommands(void)
+{
+    static const std::string commands = [] {
+        static const char alphabet[] = "MMMMMMLRFBMMNUTRX";
+        std::string result;
+        result.reserve(COMMAND_COUNT);
+        std::uint32_t seed = 12345;
+        while (result.size() < COMMAND_COUNT) {
+            seed = seed * 1103515245u + 12345u;
+            result.push_back(alphabet[(seed >> 16) % (sizeof(alphabet) - 1)]);
+        }
+        return result;
+    }();
+    return commands;
+}
+
+// 默认配置的马尔可夫指令流，比MixedCommands更接近线上的游程和切换分布
+const std::string& GeneratedCommands(void)
+{
+    static const std::string commands = adas::WorkloadGenerator().Generate(COMMAND_COUNT);
+    return commands;
+}
+
+class CountingListener final : public adas::ExecutorListener
+{
+public:
+    void OnEvents(const adas::ExecutorEvent*, const std::size_t count) noexcept override
+    {
+        events += count;
+    }
+
+    std::size_t events{0};
+};
+}  // namespace
+
+BENCHMARK(ExecuteMixed)
+{
+    const std::string& commands = MixedCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Execute(commands);
+    }
+    adas::bench::DoNotOptimize(executor->Query());
+}
+
+BENCHMARK(ExecuteGenerated)
+{
+    const std::string& commands = GeneratedCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Execute(commands);
+    }
+    adas::bench::DoNotOptimize(executor->Query());
+}
+
+// 配置加载的车型与内置车型走同一张表驱动的循环，吞吐应与ExecuteGenerated一致
+BENCHMARK(ExecuteGeneratedCustomType)
+{
+    static const bool registered = [] {
+        adas::VehicleSpec truck;
+        truck.name = "BENCH_TRUCK";
+        truck.turnBefore[0] = 1;
+        truck.turnAfter[1] = 2;
+        truck.onN = "BENCH_TRUCK";
+        truck.onU = "BENCH_TRUCK";
+        std::string error;
+        return adas::RegisterVehicleTypes({truck}, error);
+    }();
+    adas::CarType truck = adas::CarType::NORMAL;
+    adas::FindCarType("BENCH_TRUCK", truck);
+    adas::bench::DoNotOptimize(registered);
+
+    const std::string& commands = GeneratedCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor({0, 0, 'N'}, {truck, false, false}));
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Execute(commands);
+    }
+    adas::bench::DoNotOptimize(executor->Query());
+}
+
+// 短指令串：每次Execute的固定开销(计数合并等)占比最高的场景
+BENCHMARK(ExecuteShort)
+{
+    const std::string commands("MLMR");
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Execute(commands);
+    }
+    adas::bench::DoNotOptimize(executor->Query());
+}
+
+BENCHMARK(ExecuteMixedWithListener)
+{
+    const std::string& commands = MixedCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    CountingListener listener;
+    executor->SetListener(&listener);
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Execute(commands);
+    }
+    adas::bench::DoNotOptimize(listener.events);
+}
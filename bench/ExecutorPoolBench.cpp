@@ -0,0 +1,44 @@
+#include <memory>
+#include <vector>
+#include "Bench.hpp"
+#include "ExecutorPool.hpp"
+
+namespace
+{
+constexpr std::size_t BATCH = 1024;
+}
+
+// 现有路径：每个执行器单独new/delete
+BENCHMARK(NewExecutorConstructDestroy)
+{
+    state.SetItemsPerIteration(BATCH);
+    std::vector<std::unique_ptr<adas::Executor>> executors(BATCH);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (auto& executor : executors) {
+            executor.reset(adas::Executor::NewExecutor({0, 0, 'N'}));
+        }
+        adas::bench::DoNotOptimize(executors.back().get());
+        for (auto& executor : executors) {
+            executor.reset();
+        }
+    }
+}
+
+BENCHMARK(ExecutorPoolAcquireRelease)
+{
+    state.PauseTiming();
+    adas::ExecutorPool pool(BATCH);
+    std::vector<adas::ExecutorPool::Handle> executors(BATCH);
+    state.ResumeTiming();
+
+    state.SetItemsPerIteration(BATCH);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (auto& executor : executors) {
+            executor = pool.Acquire({0, 0, 'N'});
+        }
+        adas::bench::DoNotOptimize(executors.back().get());
+        for (auto& executor : executors) {
+            executor.reset();
+        }
+    }
+}
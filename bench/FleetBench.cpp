@@ -0,0 +1,121 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Bench.hpp"
+#include "Fleet.hpp"
+
+namespace
+{
+constexpr std::size_t VEHICLE_COUNT = 1 << 20;
+constexpr int AREA = 1 << 14;  // 车辆分布在[-AREA, AREA)^2内，每个64x64格平均4辆
+constexpr std::size_t QUERY_COUNT = 1024;
+
+adas::Fleet& LargeFleet(void)
+{
+    static adas::Fleet fleet;
+    static const bool filled = [] {
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> coordinate(-AREA, AREA - 1);
+        for (std::size_t i = 0; i < VEHICLE_COUNT; ++i) {
+            fleet.Add({coordinate(random), coordinate(random), "ESWN"[i % 4]});
+        }
+        return true;
+    }();
+    (void)filled;
+    return fleet;
+}
+
+std::vector<adas::GridPoint> QueryCenters(void)
+{
+    std::mt19937 random(2);
+    std::uniform_int_distribution<int> coordinate(-AREA, AREA - 1);
+    std::vector<adas::GridPoint> centers(QUERY_COUNT);
+    for (adas::GridPoint& center : centers) {
+        center = adas::GridPoint{coordinate(random), coordinate(random)};
+    }
+    return centers;
+}
+}  // namespace
+
+// 每辆车执行一条短指令串并更新索引，大约一半的车会换格子
+BENCHMARK(FleetUpdate)
+{
+    // 首次调用时建立车队，不计时
+    state.PauseTiming();
+    adas::Fleet& fleet = LargeFleet();
+    state.ResumeTiming();
+    const std::string commands[] = {"MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMR", "LMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM"};
+    state.SetItemsPerIteration(VEHICLE_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (adas::VehicleId id = 0; id < VEHICLE_COUNT; ++id) {
+            fleet.Execute(id, commands[(id ^ i) & 1]);
+        }
+    }
+}
+
+// 每辆车一条指令串，并行执行、更新索引并检测碰撞；每个64x64格平均4辆，碰撞很少
+BENCHMARK(FleetTickWithCollisions)
+{
+    state.PauseTiming();
+    adas::Fleet& fleet = LargeFleet();
+    std::vector<std::string> commands(VEHICLE_COUNT);
+    for (std::size_t id = 0; id < VEHICLE_COUNT; ++id) {
+        commands[id] = id % 2 == 0 ? "MMMMMMMMR" : "LMMMMMMMM";
+    }
+    std::vector<adas::Collision> collisions;
+    state.ResumeTiming();
+    state.SetItemsPerIteration(VEHICLE_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        fleet.Tick(commands, collisions);
+        adas::bench::DoNotOptimize(collisions.data());
+    }
+}
+
+// 256x256的矩形，平均命中64辆车
+BENCHMARK(FleetQueryRect)
+{
+    const adas::Fleet& fleet = LargeFleet();
+    const std::vector<adas::GridPoint> centers = QueryCenters();
+    std::vector<adas::VehicleId> result;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (const adas::GridPoint& center : centers) {
+            fleet.QueryRect({center.x - 128, center.y - 128}, {center.x + 127, center.y + 127}, result);
+            adas::bench::DoNotOptimize(result.data());
+        }
+    }
+}
+
+BENCHMARK(FleetQueryNearest16)
+{
+    const adas::Fleet& fleet = LargeFleet();
+    const std::vector<adas::GridPoint> centers = QueryCenters();
+    std::vector<adas::VehicleId> result;
+    state.SetItemsPerIteration(QUERY_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (const adas::GridPoint& center : centers) {
+            fleet.QueryNearest(center, 16, result);
+            adas::bench::DoNotOptimize(result.data());
+        }
+    }
+}
+
+// 原来的做法：对每辆车调用Query过滤
+BENCHMARK(FleetQueryRectByQuery)
+{
+    const adas::Fleet& fleet = LargeFleet();
+    const adas::GridPoint center = QueryCenters()[0];
+    std::vector<adas::VehicleId> result;
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        result.clear();
+        for (adas::VehicleId id = 0; id < VEHICLE_COUNT; ++id) {
+            const adas::Pose pose = fleet.Vehicle(id).Query();
+            if (pose.x >= center.x - 128 && pose.x <= center.x + 127 && pose.y >= center.y - 128 &&
+                pose.y <= center.y + 127) {
+                result.push_back(id);
+            }
+        }
+        adas::bench::DoNotOptimize(result.data());
+    }
+}
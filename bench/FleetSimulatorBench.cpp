@@ -0,0 +1,69 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "Bench.hpp"
+#include "FleetSimulator.hpp"
+
+namespace
+{
+constexpr std::size_t VEHICLE_COUNT = 1 << 20;
+
+std::vector<std::string> TickCommands(void)
+{
+    std::vector<std::string> commands(VEHICLE_COUNT);
+    for (std::size_t i = 0; i < VEHICLE_COUNT; ++i) {
+        commands[i] = i % 2 == 0 ? "MMMMRMMMM" : "LMMFMMMBM";
+    }
+    return commands;
+}
+
+void RunTicks(adas::bench::BenchState& state, const adas::FleetSimulatorOptions& options)
+{
+    state.PauseTiming();
+    adas::FleetSimulator simulator(std::vector<adas::Pose>(VEHICLE_COUNT, adas::Pose{0, 0, 'N'}), options);
+    const std::vector<std::string> commands = TickCommands();
+    state.ResumeTiming();
+    state.SetItemsPerIteration(VEHICLE_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        simulator.Tick(commands);
+        const adas::FleetSimulator::Snapshot snapshot = simulator.Read();
+        adas::bench::DoNotOptimize(snapshot.X()[VEHICLE_COUNT - 1]);
+    }
+}
+}  // namespace
+
+// 一个tick：所有车辆执行一批指令，按列发布位姿
+BENCHMARK(FleetSimulatorTick)
+{
+    RunTicks(state, adas::FleetSimulatorOptions{});
+}
+
+BENCHMARK(FleetSimulatorTickDeterministic)
+{
+    adas::FleetSimulatorOptions options;
+    options.deterministic = true;
+    RunTicks(state, options);
+}
+
+// 原来的做法：逐个执行器Execute，再逐个Query
+BENCHMARK(FleetTickPerExecutor)
+{
+    state.PauseTiming();
+    std::vector<std::unique_ptr<adas::Executor>> executors;
+    for (std::size_t i = 0; i < VEHICLE_COUNT; ++i) {
+        executors.emplace_back(adas::Executor::NewExecutor());
+    }
+    const std::vector<std::string> commands = TickCommands();
+    std::vector<adas::Pose> poses(VEHICLE_COUNT);
+    state.ResumeTiming();
+    state.SetItemsPerIteration(VEHICLE_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (std::size_t j = 0; j < VEHICLE_COUNT; ++j) {
+            executors[j]->Execute(commands[j]);
+        }
+        for (std::size_t j = 0; j < VEHICLE_COUNT; ++j) {
+            poses[j] = executors[j]->Query();
+        }
+        adas::bench::DoNotOptimize(poses.back());
+    }
+}
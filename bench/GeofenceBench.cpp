@@ -0,0 +1,70 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "Bench.hpp"
+#include "Executor.hpp"
+#include "Geofence.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 20;
+
+const std::string& LongRunCommands(void)
+{
+    static const std::string commands = [] {
+        adas::WorkloadConfig config;
+        config.meanRunLength = 200.0;
+        return adas::WorkloadGenerator(config).Generate(COMMAND_COUNT);
+    }();
+    return commands;
+}
+
+// 足够大的凹多边形，整串指令都不会驶出
+const adas::Geofence& LargePolygon(void)
+{
+    static const adas::Geofence fence = [] {
+        adas::Geofence polygon;
+        adas::Geofence::Polygon(
+            {{-40000, -40000}, {40000, -40000}, {40000, 40000}, {1000, 40000}, {0, 35000}, {-40000, 40000}}, polygon);
+        return polygon;
+    }();
+    return fence;
+}
+}  // namespace
+
+// 直行段整段查一次围栏
+BENCHMARK(GeofenceExecuteWithin)
+{
+    const std::string& commands = LongRunCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Reset({0, 0, 'N'});
+        adas::bench::DoNotOptimize(executor->ExecuteWithin(commands, LargePolygon()));
+    }
+}
+
+// 原来的做法：逐条执行并在每条之后查询位姿，只能检查终点
+BENCHMARK(GeofenceByQuery)
+{
+    const std::string& commands = LongRunCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    std::string command;
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Reset({0, 0, 'N'});
+        std::size_t pos = 0;
+        for (; pos < commands.size(); ++pos) {
+            const bool turnRound = commands[pos] == 'T' && pos + 1 < commands.size() && commands[pos + 1] == 'R';
+            command.assign(commands, pos, turnRound ? 2 : 1);
+            executor->Execute(command);
+            const adas::Pose pose = executor->Query();
+            if (!LargePolygon().Contains({pose.x, pose.y})) {
+                break;
+            }
+            pos += turnRound ? 1 : 0;
+        }
+        adas::bench::DoNotOptimize(pos);
+    }
+}
@@ -0,0 +1,56 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "Bench.hpp"
+#include "Executor.hpp"
+#include "LazyExecutor.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 20;
+constexpr std::size_t COMMAND_LENGTH = 8;
+// 每执行这么多次Execute查询一次位姿
+constexpr std::size_t QUERY_INTERVAL = 4096;
+
+// 把生成的指令流切成短指令，模拟持续下发、偶尔查询的车辆
+const std::vector<std::string>& ShortCommands(void)
+{
+    static const std::vector<std::string> commands = [] {
+        const std::string stream = adas::WorkloadGenerator().Generate(COMMAND_COUNT);
+        std::vector<std::string> result;
+        for (std::size_t pos = 0; pos < stream.size(); pos += COMMAND_LENGTH) {
+            result.push_back(stream.substr(pos, COMMAND_LENGTH));
+        }
+        return result;
+    }();
+    return commands;
+}
+
+void WriteHeavy(adas::bench::BenchState& state, adas::Executor& executor)
+{
+    const std::vector<std::string>& commands = ShortCommands();
+    state.SetItemsPerIteration(COMMAND_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (std::size_t j = 0; j < commands.size(); ++j) {
+            executor.Execute(commands[j]);
+            if (j % QUERY_INTERVAL == QUERY_INTERVAL - 1) {
+                adas::bench::DoNotOptimize(executor.Query());
+            }
+        }
+    }
+    adas::bench::DoNotOptimize(executor.Query());
+}
+}  // namespace
+
+BENCHMARK(WriteHeavyEager)
+{
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    WriteHeavy(state, *executor);
+}
+
+BENCHMARK(WriteHeavyLazy)
+{
+    std::unique_ptr<adas::LazyExecutor> executor(adas::LazyExecutor::NewLazyExecutor());
+    WriteHeavy(state, *executor);
+}
@@ -0,0 +1,80 @@
+#include <memory>
+#include <random>
+#include <string>
+#include "Bench.hpp"
+#include "Executor.hpp"
+#include "ObstacleMap.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 20;
+constexpr std::uint64_t SCAN_LENGTH = 4096;
+
+const std::string& LongRunCommands(void)
+{
+    static const std::string commands = [] {
+        adas::WorkloadConfig config;
+        config.meanRunLength = 200.0;
+        return adas::WorkloadGenerator(config).Generate(COMMAND_COUNT);
+    }();
+    return commands;
+}
+
+// 稀疏障碍：大约每20个64x64块有一个障碍
+const adas::ObstacleMap& SparseMap(void)
+{
+    static const adas::ObstacleMap map = [] {
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> coordinate(-20000, 20000);
+        adas::ObstacleMap result;
+        for (int i = 0; i < 20000; ++i) {
+            result.Block({coordinate(random), coordinate(random)});
+        }
+        result.Unblock({0, 0});
+        return result;
+    }();
+    return map;
+}
+}  // namespace
+
+BENCHMARK(ObstacleExecuteLongRuns)
+{
+    const std::string& commands = LongRunCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Reset({0, 0, 'N'});
+        executor->SetObstacleMap(&SparseMap());
+        executor->Execute(commands);
+        adas::bench::DoNotOptimize(executor->Query());
+    }
+}
+
+// 按64位字扫描一行
+BENCHMARK(ObstacleScanWords)
+{
+    const adas::ObstacleMap& map = SparseMap();
+    state.SetItemsPerIteration(SCAN_LENGTH * 64);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (int row = 0; row < 64; ++row) {
+            adas::bench::DoNotOptimize(map.FreeSteps({-2048, row * 97}, 1, 0, SCAN_LENGTH));
+        }
+    }
+}
+
+// 逐格检查同样的行
+BENCHMARK(ObstacleScanCells)
+{
+    const adas::ObstacleMap& map = SparseMap();
+    state.SetItemsPerIteration(SCAN_LENGTH * 64);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (int row = 0; row < 64; ++row) {
+            std::uint64_t free = 0;
+            while (free < SCAN_LENGTH && !map.Blocked({-2048 + static_cast<int>(free) + 1, row * 97})) {
+                ++free;
+            }
+            adas::bench::DoNotOptimize(free);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "Bench.hpp"
+#include "Executor.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 20;
+
+// 长游程的指令流，大部分块整块相同，按闭式结果折叠
+const std::string& LongRunCommands(void)
+{
+    static const std::string commands = [] {
+        adas::WorkloadConfig config;
+        config.meanRunLength = 200.0;
+        return adas::WorkloadGenerator(config).Generate(COMMAND_COUNT);
+    }();
+    return commands;
+}
+}  // namespace
+
+// 执行时增量维护统计，执行完查询一次
+BENCHMARK(PathStatsIncremental)
+{
+    const std::string& commands = LongRunCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->ResetStats();
+        executor->Execute(commands);
+        adas::bench::DoNotOptimize(executor->QueryStats());
+    }
+}
+
+// 原来的做法：逐条执行并在每条之后查询位姿
+BENCHMARK(PathStatsByQuery)
+{
+    const std::string& commands = LongRunCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    std::string command;
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        adas::Pose last = executor->Query();
+        adas::PathStats stats{0, last.x, last.y, last.x, last.y, 0, 0};
+        for (std::size_t pos = 0; pos < commands.size(); ++pos) {
+            const bool turnRound = commands[pos] == 'T' && pos + 1 < commands.size() && commands[pos + 1] == 'R';
+            command.assign(commands, pos, turnRound ? 2 : 1);
+            pos += turnRound ? 1 : 0;
+            executor->Execute(command);
+            const adas::Pose current = executor->Query();
+            stats.distance += std::abs(current.x - last.x) + std::abs(current.y - last.y);
+            stats.minX = std::min(stats.minX, current.x);
+            stats.minY = std::min(stats.minY, current.y);
+            stats.maxX = std::max(stats.maxX, current.x);
+            stats.maxY = std::max(stats.maxY, current.y);
+            last = current;
+        }
+        adas::bench::DoNotOptimize(stats);
+    }
+}
@@ -0,0 +1,143 @@
+#include "PerfCounters.hpp"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace adas
+{
+namespace bench
+{
+namespace
+{
+#ifdef __linux__
+struct EventSpec
+{
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+const EventSpec SPECS[PERF_EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+int OpenEvent(const EventSpec& spec) noexcept
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+}  // namespace
+
+PerfCounters::~PerfCounters() noexcept
+{
+#ifdef __linux__
+    for (const int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::Open(void) noexcept
+{
+#ifdef __linux__
+    bool opened = false;
+    for (unsigned i = 0; i < PERF_EVENT_COUNT; ++i) {
+        fds[i] = OpenEvent(SPECS[i]);
+        if (fds[i] >= 0) {
+            opened = true;
+        } else if (error.empty()) {
+            error = std::string("perf_event_open: ") + std::strerror(errno);
+        }
+    }
+    return opened;
+#else
+    error = "perf_event_open is only available on Linux";
+    return false;
+#endif
+}
+
+const std::string& PerfCounters::Error(void) const noexcept
+{
+    return error;
+}
+
+void PerfCounters::Reset(void) noexcept
+{
+#ifdef __linux__
+    for (const int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::Enable(void) noexcept
+{
+#ifdef __linux__
+    for (const int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::Disable(void) noexcept
+{
+#ifdef __linux__
+    for (const int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+#endif
+}
+
+PerfSample PerfCounters::Read(void) const noexcept
+{
+    PerfSample sample;
+#ifdef __linux__
+    for (unsigned i = 0; i < PERF_EVENT_COUNT; ++i) {
+        std::uint64_t data[3] = {0, 0, 0};  // value, time_enabled, time_running
+        if (fds[i] < 0 || read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+        const double scale = data[2] < data[1] ? static_cast<double>(data[1]) / data[2] : 1.0;
+        sample.values[i] = static_cast<std::uint64_t>(data[0] * scale);
+        sample.valid[i] = true;
+    }
+#endif
+    return sample;
+}
+
+const char* PerfCounters::Name(const PerfEvent event) noexcept
+{
+    static const char* names[PERF_EVENT_COUNT] = {"cycles", "instructions", "branch-misses", "L1d-misses",
+                                                  "LLC-misses"};
+    return names[event];
+}
+}  // namespace bench
+}  // namespace adas
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace adas
+{
+namespace bench
+{
+enum PerfEvent : unsigned {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_EVENT_COUNT
+};
+
+struct PerfSample
+{
+    std::uint64_t values[PERF_EVENT_COUNT]{};
+    bool valid[PERF_EVENT_COUNT]{};
+};
+
+// 通过Linux perf_event_open读取硬件计数器。每个事件单独打开，
+// 内核/虚拟机不支持的事件自动跳过；非Linux平台上Open总是失败
+class PerfCounters final
+{
+public:
+    PerfCounters(void) noexcept = default;
+    ~PerfCounters() noexcept;
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+public:
+    // 至少一个事件可用时返回true；失败原因见Error()
+    bool Open(void) noexcept;
+    const std::string& Error(void) const noexcept;
+
+    void Reset(void) noexcept;
+    void Enable(void) noexcept;
+    void Disable(void) noexcept;
+    // 计数器被复用(multiplexing)时按启用/运行时间比例放大
+    PerfSample Read(void) const noexcept;
+
+    static const char* Name(const PerfEvent event) noexcept;
+
+private:
+    int fds[PERF_EVENT_COUNT]{-1, -1, -1, -1, -1};
+    std::string error;
+};
+}  // namespace bench
+}  // namespace adas
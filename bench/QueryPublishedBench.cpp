@@ -0,0 +1,22 @@
+#include <memory>
+#include "Bench.hpp"
+#include "Executor.hpp"
+
+// 读者一侧的开销：无写者竞争时读一次已发布状态
+BENCHMARK(QueryPublished)
+{
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    executor->Execute("MMRMM");
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        adas::bench::DoNotOptimize(executor->QueryPublished());
+    }
+}
+
+BENCHMARK(QueryDirect)
+{
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    executor->Execute("MMRMM");
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        adas::bench::DoNotOptimize(executor->Query());
+    }
+}
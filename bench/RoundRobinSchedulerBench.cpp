@@ -0,0 +1,58 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "Bench.hpp"
+#include "Executor.hpp"
+#include "RoundRobinScheduler.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 20;
+constexpr std::size_t LIGHT_VEHICLES = 1023;
+constexpr std::size_t LIGHT_LENGTH = 16;
+
+const std::string& GeneratedCommands(void)
+{
+    static const std::string commands = adas::WorkloadGenerator().Generate(COMMAND_COUNT);
+    return commands;
+}
+}  // namespace
+
+// 分片执行相对一次Execute的额外开销
+BENCHMARK(ExecuteSomeQuantum4096)
+{
+    const std::string& commands = GeneratedCommands();
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        adas::ExecuteCursor cursor(commands);
+        while (!cursor.Done()) {
+            executor->ExecuteSome(cursor, 4096);
+        }
+    }
+    adas::bench::DoNotOptimize(executor->Query());
+}
+
+// 一辆车提交1M条指令，另外1023辆各提交16条：轻载车辆在第一轮内全部完成
+BENCHMARK(ScheduleFleetWithHeavyVehicle)
+{
+    const std::string& heavy = GeneratedCommands();
+    const std::string light = heavy.substr(0, LIGHT_LENGTH);
+    std::vector<std::unique_ptr<adas::Executor>> executors;
+    for (std::size_t i = 0; i <= LIGHT_VEHICLES; ++i) {
+        executors.emplace_back(adas::Executor::NewExecutor());
+    }
+    adas::RoundRobinScheduler scheduler(4096);
+    state.SetItemsPerIteration(heavy.size() + LIGHT_VEHICLES * LIGHT_LENGTH);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        state.PauseTiming();
+        scheduler.Submit(*executors[0], heavy);
+        for (std::size_t j = 1; j <= LIGHT_VEHICLES; ++j) {
+            scheduler.Submit(*executors[j], light);
+        }
+        state.ResumeTiming();
+        scheduler.RunAll();
+    }
+    adas::bench::DoNotOptimize(executors[0]->Query());
+}
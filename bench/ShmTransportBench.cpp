@@ -0,0 +1,149 @@
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include "Bench.hpp"
+#include "CommandServer.hpp"
+#include "ShmTransport.hpp"
+
+namespace
+{
+const std::string BATCH = "MMRMMLMMFMMBMMLR";
+constexpr std::size_t PIPELINE = 64;
+
+// 阻塞套接字上的客户端，与ShmCommandClient的用法对应
+class SocketClient final
+{
+public:
+    explicit SocketClient(const adas::CommandServerOptions& options, const std::uint16_t port)
+    {
+        if (options.unixPath.empty()) {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        } else {
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            options.unixPath.copy(address.sun_path, options.unixPath.size());
+            ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        }
+    }
+    ~SocketClient()
+    {
+        ::close(fd);
+    }
+
+    // 发出count个EXECUTE帧，再收齐全部应答
+    void RoundTrip(const std::size_t count)
+    {
+        frames.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            adas::AppendExecute(frames, i % 8, i, BATCH);
+        }
+        ::send(fd, frames.data(), frames.size(), MSG_NOSIGNAL);
+        std::size_t remaining = count * sizeof(adas::Response);
+        while (remaining > 0) {
+            const ssize_t received = ::recv(fd, buffer, std::min(remaining, sizeof(buffer)), 0);
+            if (received <= 0) {
+                return;
+            }
+            remaining -= static_cast<std::size_t>(received);
+        }
+    }
+
+private:
+    int fd;
+    std::string frames;
+    char buffer[PIPELINE * sizeof(adas::Response)];
+};
+
+void SocketRoundTrips(adas::bench::BenchState& state, const adas::CommandServerOptions& options,
+                      const std::size_t count)
+{
+    state.PauseTiming();
+    adas::CommandServer server(options);
+    server.Listen();
+    std::thread loop([&server] { server.Run(); });
+    {
+        SocketClient client(options, server.Port());
+        client.RoundTrip(count);
+        state.ResumeTiming();
+        state.SetItemsPerIteration(count);
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            client.RoundTrip(count);
+        }
+        state.PauseTiming();
+    }
+    server.Stop();
+    loop.join();
+    state.ResumeTiming();
+}
+
+void ShmRoundTrips(adas::bench::BenchState& state, const std::size_t count)
+{
+    state.PauseTiming();
+    const std::string name = "/training_bench_" + std::to_string(::getpid());
+    adas::ShmCommandServer server(name);
+    server.Create();
+    std::thread loop([&server] { server.Run(); });
+    {
+        adas::ShmCommandClient client;
+        client.Attach(name);
+        adas::Response responses[PIPELINE];
+        state.ResumeTiming();
+        state.SetItemsPerIteration(count);
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            for (std::size_t n = 0; n < count; ++n) {
+                client.SubmitExecute(n % 8, n, BATCH);
+            }
+            for (std::size_t received = 0; received < count;) {
+                received += client.Receive(responses, PIPELINE, 1000000000);
+            }
+        }
+        state.PauseTiming();
+    }
+    server.Stop();
+    loop.join();
+    state.ResumeTiming();
+}
+}  // namespace
+
+// 单个请求的往返：客户端等到应答再发下一个
+BENCHMARK(ShmRoundTrip)
+{
+    ShmRoundTrips(state, 1);
+}
+
+BENCHMARK(UnixSocketRoundTrip)
+{
+    adas::CommandServerOptions options;
+    options.unixPath = "/tmp/training_bench_" + std::to_string(::getpid()) + ".sock";
+    SocketRoundTrips(state, options, 1);
+}
+
+BENCHMARK(TcpLoopbackRoundTrip)
+{
+    SocketRoundTrips(state, adas::CommandServerOptions{}, 1);
+}
+
+// 一次发出PIPELINE个请求再收齐应答，按帧计吞吐
+BENCHMARK(ShmPipelined)
+{
+    ShmRoundTrips(state, PIPELINE);
+}
+
+BENCHMARK(UnixSocketPipelined)
+{
+    adas::CommandServerOptions options;
+    options.unixPath = "/tmp/training_bench_" + std::to_string(::getpid()) + ".sock";
+    SocketRoundTrips(state, options, PIPELINE);
+}
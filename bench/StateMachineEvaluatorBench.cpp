@@ -0,0 +1,41 @@
+#include <memory>
+#include <string>
+#include "Bench.hpp"
+#include "Executor.hpp"
+#include "StateMachineEvaluator.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 20;
+
+// 同一份默认配置的生成指令流，分别用三种实现执行
+void ExecuteWith(adas::bench::BenchState& state, const adas::EvaluatorIsa isa)
+{
+    static const std::string commands = adas::WorkloadGenerator().Generate(COMMAND_COUNT);
+    const adas::EvaluatorIsa saved = adas::GetEvaluatorIsa();
+    adas::SetEvaluatorIsa(isa);
+    std::unique_ptr<adas::Executor> executor(adas::Executor::NewExecutor());
+    state.SetItemsPerIteration(commands.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        executor->Execute(commands);
+    }
+    adas::bench::DoNotOptimize(executor->Query());
+    adas::SetEvaluatorIsa(saved);
+}
+}  // namespace
+
+BENCHMARK(EvaluateGeneratedScalar)
+{
+    ExecuteWith(state, adas::EvaluatorIsa::SCALAR);
+}
+
+BENCHMARK(EvaluateGeneratedSsse3)
+{
+    ExecuteWith(state, adas::EvaluatorIsa::SSSE3);
+}
+
+BENCHMARK(EvaluateGeneratedAvx2)
+{
+    ExecuteWith(state, adas::EvaluatorIsa::AVX2);
+}
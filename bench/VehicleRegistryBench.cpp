@@ -0,0 +1,121 @@
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Bench.hpp"
+#include "VehicleRegistry.hpp"
+
+namespace
+{
+constexpr std::uint64_t VEHICLE_COUNT = 1 << 20;
+constexpr std::size_t LOOKUP_COUNT = 1 << 16;
+
+std::uint64_t IdOf(const std::uint64_t index)
+{
+    return index * 0x9E3779B97F4A7C15ull;
+}
+
+std::string NameOf(const std::uint64_t index)
+{
+    return "vehicle-" + std::to_string(index);
+}
+
+adas::VehicleRegistry& LargeRegistry(void)
+{
+    static adas::VehicleRegistry registry;
+    static const bool filled = [] {
+        for (std::uint64_t i = 0; i < VEHICLE_COUNT; ++i) {
+            registry.Insert(IdOf(i), {static_cast<int>(i), 0, 'N'});
+        }
+        return true;
+    }();
+    (void)filled;
+    return registry;
+}
+
+std::vector<std::uint64_t> LookupIndexes(void)
+{
+    std::mt19937_64 random(3);
+    std::vector<std::uint64_t> indexes(LOOKUP_COUNT);
+    for (std::uint64_t& index : indexes) {
+        index = random() % VEHICLE_COUNT;
+    }
+    return indexes;
+}
+}  // namespace
+
+// 每次查找各自进入读临界区，与服务中每批指令查一次的用法相同
+BENCHMARK(RegistryLookupById)
+{
+    state.PauseTiming();
+    const adas::VehicleRegistry& registry = LargeRegistry();
+    const std::vector<std::uint64_t> indexes = LookupIndexes();
+    state.ResumeTiming();
+    state.SetItemsPerIteration(LOOKUP_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (const std::uint64_t index : indexes) {
+            const adas::VehicleRegistry::Guard guard;
+            adas::bench::DoNotOptimize(registry.Find(guard, IdOf(index)));
+        }
+    }
+}
+
+BENCHMARK(RegistryLookupByName)
+{
+    state.PauseTiming();
+    adas::VehicleRegistry registry;
+    std::vector<std::string> names;
+    for (const std::uint64_t index : LookupIndexes()) {
+        names.push_back(NameOf(index));
+        registry.Insert(names.back(), {0, 0, 'N'});
+    }
+    state.ResumeTiming();
+    state.SetItemsPerIteration(names.size());
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (const std::string& name : names) {
+            const adas::VehicleRegistry::Guard guard;
+            adas::bench::DoNotOptimize(registry.Find(guard, name));
+        }
+    }
+}
+
+// 原来的做法：全局互斥锁保护的unordered_map
+BENCHMARK(MutexMapLookupById)
+{
+    state.PauseTiming();
+    static std::unordered_map<std::uint64_t, std::unique_ptr<adas::Executor>> map;
+    if (map.empty()) {
+        for (std::uint64_t i = 0; i < VEHICLE_COUNT; ++i) {
+            map.emplace(IdOf(i), std::unique_ptr<adas::Executor>(adas::Executor::NewExecutor()));
+        }
+    }
+    std::mutex mutex;
+    const std::vector<std::uint64_t> indexes = LookupIndexes();
+    state.ResumeTiming();
+    state.SetItemsPerIteration(LOOKUP_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (const std::uint64_t index : indexes) {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto found = map.find(IdOf(index));
+            adas::bench::DoNotOptimize(found == map.end() ? nullptr : found->second.get());
+        }
+    }
+}
+
+// 移除后立即以同一编号重新加入，执行器经纪元回收后归还到分片的池中复用
+BENCHMARK(RegistryRemoveInsert)
+{
+    state.PauseTiming();
+    adas::VehicleRegistry& registry = LargeRegistry();
+    const std::vector<std::uint64_t> indexes = LookupIndexes();
+    state.ResumeTiming();
+    state.SetItemsPerIteration(LOOKUP_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (const std::uint64_t index : indexes) {
+            registry.Remove(IdOf(index));
+            registry.Insert(IdOf(index), {static_cast<int>(index), 0, 'N'});
+        }
+    }
+}
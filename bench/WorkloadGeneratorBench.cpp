@@ -0,0 +1,19 @@
+#include <memory>
+#include "Bench.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+constexpr std::size_t COMMAND_COUNT = 1 << 24;
+}  // namespace
+
+BENCHMARK(GenerateWorkload)
+{
+    const adas::WorkloadGenerator generator;
+    std::unique_ptr<char[]> buffer(new char[COMMAND_COUNT]);
+    state.SetItemsPerIteration(COMMAND_COUNT);
+    for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+        generator.Generate(buffer.get(), COMMAND_COUNT);
+    }
+    adas::bench::DoNotOptimize(buffer[COMMAND_COUNT - 1]);
+}
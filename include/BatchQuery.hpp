@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include "Executor.hpp"
+
+namespace adas
+{
+// 调用方持有的按列(SoA)输出缓冲，每列至少容纳count个元素
+struct PoseColumns
+{
+    int* x{nullptr};
+    int* y{nullptr};
+    char* heading{nullptr};
+    CarMode* mode{nullptr};  // 可选：为空时不输出车型与加速/倒车状态
+};
+
+// 一次查询一组执行器的位姿，并预取后续执行器。由Executor::NewExecutor或ExecutorPool创建的执行器
+// 直接读取状态，不经过虚函数Query；其他执行器(如惰性执行器)逐个调用Query、QueryMode，结果相同。
+void QueryBatch(const Executor* const* executors, const std::size_t count, const PoseColumns& columns) noexcept;
+void QueryBatch(const Executor* const* executors, const std::size_t count, Pose* poses,
+                CarMode* modes = nullptr) noexcept;
+}  // namespace adas
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "Executor.hpp"
+
+namespace adas
+{
+// training_server的帧格式，只用于本机通信，整数按本机字节序。
+// 请求是固定长度的RequestHeader加length字节的负载；每个请求对应一个固定长度的Response，
+// 同一连接上的应答按请求顺序返回，客户端可以不等应答连续发送多个请求
+enum class FrameType : std::uint16_t {
+    EXECUTE = 1,  // 负载为指令串，应答带执行后的位姿；车辆不存在时先在原点朝北创建
+    QUERY = 2,    // 无负载
+    RESET = 3,    // 负载为ResetPayload；车辆不存在时以该位姿创建
+    REMOVE = 4,   // 无负载，应答带移除前的位姿
+};
+
+enum class FrameStatus : std::uint16_t {
+    OK = 0,
+    UNKNOWN_VEHICLE = 1,  // QUERY、REMOVE的车辆不存在
+    BAD_FRAME = 2,        // 未知类型或负载长度不符，连接保持
+    NO_MEMORY = 3,
+};
+
+// 负载超过该长度时服务端直接关闭连接
+constexpr std::uint32_t MAX_FRAME_PAYLOAD = 1 << 20;
+
+struct RequestHeader
+{
+    std::uint32_t length;  // 负载字节数
+    std::uint16_t type;    // FrameType
+    std::uint16_t reserved;
+    std::uint64_t vehicle;
+    std::uint64_t tag;  // 原样带回应答，供客户端匹配请求
+};
+
+struct ResetPayload
+{
+    std::int32_t x;
+    std::int32_t y;
+    char heading;
+    std::uint8_t carType;  // CarType
+    std::uint8_t fast;
+    std::uint8_t reverse;
+};
+
+struct Response
+{
+    std::uint16_t type;    // 请求的FrameType
+    std::uint16_t status;  // FrameStatus，不为OK时位姿无意义
+    std::int32_t x;
+    std::int32_t y;
+    char heading;
+    std::uint8_t carType;
+    std::uint8_t fast;
+    std::uint8_t reverse;
+    std::uint64_t vehicle;
+    std::uint64_t tag;
+};
+
+static_assert(sizeof(RequestHeader) == 24, "RequestHeader must have no padding");
+static_assert(sizeof(ResetPayload) == 12, "ResetPayload must have no padding");
+static_assert(sizeof(Response) == 32, "Response must have no padding");
+
+inline void AppendRequest(std::string& out, const FrameType type, const std::uint64_t vehicle,
+                          const std::uint64_t tag, const char* payload = nullptr, const std::size_t length = 0)
+{
+    const RequestHeader header{static_cast<std::uint32_t>(length), static_cast<std::uint16_t>(type), 0, vehicle, tag};
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(payload, length);
+}
+
+inline void AppendExecute(std::string& out, const std::uint64_t vehicle, const std::uint64_t tag,
+                          const std::string& commands)
+{
+    AppendRequest(out, FrameType::EXECUTE, vehicle, tag, commands.data(), commands.size());
+}
+
+inline void AppendReset(std::string& out, const std::uint64_t vehicle, const std::uint64_t tag, const Pose& pose,
+                        const CarMode& mode = CarMode{})
+{
+    const ResetPayload payload{pose.x,
+                               pose.y,
+                               pose.heading,
+                               static_cast<std::uint8_t>(mode.carType),
+                               static_cast<std::uint8_t>(mode.fast),
+                               static_cast<std::uint8_t>(mode.reverse)};
+    AppendRequest(out, FrameType::RESET, vehicle, tag, reinterpret_cast<const char*>(&payload), sizeof(payload));
+}
+
+inline Pose PoseOf(const Response& response) noexcept
+{
+    return Pose{response.x, response.y, response.heading};
+}
+
+inline CarMode ModeOf(const Response& response) noexcept
+{
+    return CarMode{static_cast<CarType>(response.carType), response.fast != 0, response.reverse != 0};
+}
+}  // namespace adas
@@ -0,0 +1,192 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace adas
+{
+enum class ScanIsa : unsigned char {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// 一个64字节块的分类位图，第i位对应块内第i个字节，块尾之后的位为0
+struct ClassMasks
+{
+    std::uint64_t move;       // M
+    std::uint64_t turn;       // L、R(不含TR中的R)
+    std::uint64_t toggle;     // F、B
+    std::uint64_t carSwitch;  // N、U
+    std::uint64_t turnRound;  // TR中T的位置，R的位置为turnRound << 1
+    std::uint64_t junk;       // 未知字符，含单独的T
+};
+
+enum class SegmentKind : unsigned char {
+    MIXED,   // 不含N/U的任意指令，按字节执行
+    MOVES,   // 全部为M
+    SKIP,    // 全部为未知字符
+    SWITCH,  // 单个N或U
+};
+
+struct CommandSegment
+{
+    std::size_t offset;
+    std::size_t length;
+    SegmentKind kind;
+};
+
+// 用SIMD按64字节块给指令分类，再把指令串切分成同质的段：车型切换(N/U)单独成段，
+// 长度不小于MIN_RUN的M游程和未知字符游程各自成段，其余归入MIXED。
+// TR不会被切开，MIXED段可以独立执行
+class CommandScanner final
+{
+public:
+    static constexpr std::size_t BLOCK = 64;
+    static constexpr std::size_t MIN_RUN = 32;
+
+    // 当前CPU支持的最快实现
+    static ScanIsa BestIsa(void) noexcept;
+
+public:
+    explicit CommandScanner(const ScanIsa isa = BestIsa()) noexcept;
+
+public:
+    ScanIsa Isa(void) const noexcept;
+
+    // length不超过BLOCK；continuesTurnRound表示块首字节是上一块末尾T对应的R，
+    // nextIsR表示块后紧跟的字符是否为R
+    void Classify(const char* block, const std::size_t length, const bool continuesTurnRound, const bool nextIsR,
+                  ClassMasks& masks) const noexcept;
+
+    // 按顺序回调visitor(const CommandSegment&)，各段首尾相接覆盖整个指令串；
+    // splitSwitches为false时N/U留在MIXED段中，只切出长游程
+    template <typename Visitor>
+    void ForEachSegment(const char* data, const std::size_t size, Visitor&& visitor,
+                        const bool splitSwitches = true) const;
+
+    std::vector<CommandSegment> Segments(const char* data, const std::size_t size) const;
+
+private:
+    ScanIsa isa;
+};
+
+namespace detail
+{
+// 位图中长度不小于CommandScanner::MIN_RUN的1游程的起点集合(非空即存在长游程)
+inline std::uint64_t LongRunStarts(std::uint64_t bits) noexcept
+{
+    bits &= bits >> 1;
+    bits &= bits >> 2;
+    bits &= bits >> 4;
+    bits &= bits >> 8;
+    bits &= bits >> 16;
+    return bits;
+}
+
+inline unsigned OnesFrom(const std::uint64_t bits, const unsigned position) noexcept
+{
+    const std::uint64_t rest = ~(bits >> position);
+    return rest == 0 ? 64 - position : static_cast<unsigned>(__builtin_ctzll(rest));
+}
+
+inline std::uint64_t BitsBelow(const unsigned count) noexcept
+{
+    return count >= 64 ? ~0ull : (1ull << count) - 1;
+}
+}  // namespace detail
+
+template <typename Visitor>
+void CommandScanner::ForEachSegment(const char* data, const std::size_t size, Visitor&& visitor,
+                                    const bool splitSwitches) const
+{
+    std::size_t gapStart = 0;
+    auto emit = [&gapStart, &visitor](const std::size_t offset, const std::size_t length, const SegmentKind kind) {
+        if (offset > gapStart) {
+            visitor(CommandSegment{gapStart, offset - gapStart, SegmentKind::MIXED});
+        }
+        visitor(CommandSegment{offset, length, kind});
+        gapStart = offset + length;
+    };
+
+    std::size_t moveCarry = 0;
+    std::size_t junkCarry = 0;
+    bool continuesTurnRound = false;
+    for (std::size_t base = 0; base < size; base += BLOCK) {
+        const std::size_t length = size - base < BLOCK ? size - base : BLOCK;
+        const bool nextIsR = base + length < size && data[base + length] == 'R';
+        ClassMasks masks;
+        Classify(data + base, length, continuesTurnRound, nextIsR, masks);
+        continuesTurnRound = (masks.turnRound >> 63) != 0;
+        std::uint64_t move = masks.move;
+        std::uint64_t junk = masks.junk;
+
+        // 块首的游程接上一块末尾的游程；两个游程首尾相接时先输出结束于块首的那个
+        const unsigned moveLead = detail::OnesFrom(move, 0);
+        const unsigned junkLead = detail::OnesFrom(junk, 0);
+        const std::size_t moveRun = moveCarry + moveLead;
+        const std::size_t junkRun = junkCarry + junkLead;
+        const bool moveEnds = moveLead < BLOCK && moveRun >= MIN_RUN;
+        const bool junkEnds = junkLead < BLOCK && junkRun >= MIN_RUN;
+        if (junkEnds && junkLead == 0) {
+            emit(base - junkRun, junkRun, SegmentKind::SKIP);
+        }
+        if (moveEnds) {
+            emit(base + moveLead - moveRun, moveRun, SegmentKind::MOVES);
+        }
+        if (junkEnds && junkLead != 0) {
+            emit(base + junkLead - junkRun, junkRun, SegmentKind::SKIP);
+        }
+        if (moveLead == BLOCK) {
+            moveCarry += BLOCK;
+            junkCarry = 0;
+            continue;
+        }
+        if (junkLead == BLOCK) {
+            junkCarry += BLOCK;
+            moveCarry = 0;
+            continue;
+        }
+        move &= ~detail::BitsBelow(moveLead);
+        junk &= ~detail::BitsBelow(junkLead);
+
+        // 块尾的游程留给下一块；最后一块之后的位为0，不会有尾游程
+        const unsigned moveTail = static_cast<unsigned>(__builtin_clzll(~move | 1));
+        const unsigned junkTail = static_cast<unsigned>(__builtin_clzll(~junk | 1));
+        moveCarry = length == BLOCK ? moveTail : 0;
+        junkCarry = length == BLOCK ? junkTail : 0;
+        if (length == BLOCK) {
+            move &= detail::BitsBelow(static_cast<unsigned>(BLOCK) - moveTail);
+            junk &= detail::BitsBelow(static_cast<unsigned>(BLOCK) - junkTail);
+        }
+
+        // 块内的长游程与车型切换按位置顺序输出
+        std::uint64_t longMove = detail::LongRunStarts(move);
+        std::uint64_t longJunk = detail::LongRunStarts(junk);
+        std::uint64_t carSwitch = splitSwitches ? masks.carSwitch : 0;
+        while ((longMove | longJunk | carSwitch) != 0) {
+            const unsigned position = static_cast<unsigned>(__builtin_ctzll(longMove | longJunk | carSwitch));
+            if ((carSwitch >> position) & 1) {
+                emit(base + position, 1, SegmentKind::SWITCH);
+                carSwitch &= carSwitch - 1;
+                continue;
+            }
+            const bool isMove = (longMove >> position) & 1;
+            const unsigned run = detail::OnesFrom(isMove ? move : junk, position);
+            emit(base + position, run, isMove ? SegmentKind::MOVES : SegmentKind::SKIP);
+            const std::uint64_t done = ~detail::BitsBelow(position + run);
+            longMove &= done;
+            longJunk &= done;
+        }
+    }
+
+    if (moveCarry >= MIN_RUN) {
+        emit(size - moveCarry, moveCarry, SegmentKind::MOVES);
+    } else if (junkCarry >= MIN_RUN) {
+        emit(size - junkCarry, junkCarry, SegmentKind::SKIP);
+    }
+    if (size > gapStart) {
+        visitor(CommandSegment{gapStart, size - gapStart, SegmentKind::MIXED});
+    }
+}
+}  // namespace adas
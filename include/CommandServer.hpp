@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CommandProtocol.hpp"
+
+namespace adas
+{
+class FrameHandler;
+
+struct CommandServerOptions
+{
+    std::string unixPath;               // 非空时监听该路径的Unix域套接字(已存在的文件先删除)，否则监听回环TCP
+    std::uint16_t port{0};              // 回环TCP端口，0由内核分配
+    std::size_t maxConnections{16384};  // 超出时新连接立即关闭
+};
+
+// 服务的累计计数
+struct CommandServerStats
+{
+    std::uint64_t accepted{0};
+    std::uint64_t rejected{0};  // 超过maxConnections被关闭的连接
+    std::uint64_t closed{0};
+    std::uint64_t frames{0};
+    std::uint64_t commandBytes{0};  // EXECUTE负载的总字节数
+    std::uint64_t badFrames{0};
+};
+
+// 本机指令服务：单线程epoll事件循环复用所有连接，按CommandProtocol.hpp的帧格式解析请求，
+// 在注册表中按车辆编号找到执行器执行。对端读应答太慢时暂停读取该连接，发送缓冲排空后恢复
+class CommandServer final
+{
+public:
+    explicit CommandServer(const CommandServerOptions& options = CommandServerOptions{}) noexcept;
+    // 关闭所有连接，删除Unix域套接字文件。调用时Run必须已经返回
+    ~CommandServer() noexcept;
+
+    CommandServer(const CommandServer&) = delete;
+    CommandServer& operator=(const CommandServer&) = delete;
+
+public:
+    // 创建监听套接字和epoll实例；失败返回false并保留errno
+    bool Listen(void) noexcept;
+    // Listen之后TCP监听的实际端口
+    std::uint16_t Port(void) const noexcept
+    {
+        return port;
+    }
+
+    // 在调用线程上运行事件循环直到Stop；epoll出错返回false
+    bool Run(void) noexcept;
+    // Listen之后可在任意线程或信号处理函数中调用，Run尚未开始时之后的Run立即返回
+    void Stop(void) noexcept;
+
+    // 只能在运行事件循环的线程上，或Run返回之后读取
+    const CommandServerStats& Stats(void) const noexcept
+    {
+        return stats;
+    }
+    std::size_t Vehicles(void) const noexcept;
+
+private:
+    struct Connection;
+
+    void Accept(void) noexcept;
+    void Close(Connection& connection) noexcept;
+    // 读取并处理已收到的完整帧；连接被关闭时返回false
+    bool OnReadable(Connection& connection) noexcept;
+    // 处理data中的完整帧，发送缓冲积压过多时提前停下；consumed为处理掉的字节数
+    bool ProcessFrames(Connection& connection, const char* data, const std::size_t size,
+                       std::size_t& consumed) noexcept;
+    // 处理连接输入缓冲中残留的帧
+    bool ProcessPending(Connection& connection) noexcept;
+    // 尽量发出应答，并按发送缓冲的积压调整关注的事件；连接被关闭时返回false
+    bool Flush(Connection& connection) noexcept;
+
+private:
+    CommandServerOptions options;
+    int listenFd{-1};
+    int epollFd{-1};
+    int wakeFd{-1};
+    std::uint16_t port{0};
+    std::vector<std::unique_ptr<Connection>> connections;  // 按文件描述符索引
+    std::size_t open{0};
+    std::unique_ptr<FrameHandler> handler;
+    std::vector<char> buffer;  // 所有连接共用的读缓冲
+    CommandServerStats stats;
+};
+}  // namespace adas
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Executor.hpp"
+#include "ExecutorProfiler.hpp"
+
+namespace adas
+{
+// 多个生产者并发提交指令批次的执行前端。批次进入无锁的多生产者单消费者队列(Vyukov侵入式链表)，
+// 由唯一的消费者按入队顺序逐批Execute；同一生产者提交的批次保持提交顺序。
+// 消费者可以是Start启动的后台线程，也可以是自行调用Drain的线程，二者不能同时存在
+class ConcurrentExecutor final
+{
+public:
+    // 内存不足抛出std::bad_alloc
+    explicit ConcurrentExecutor(const Pose& pose = {0, 0, 'N'}, const CarMode& mode = CarMode{});
+    // 先Stop，再释放未执行的批次
+    ~ConcurrentExecutor() noexcept;
+
+    ConcurrentExecutor(const ConcurrentExecutor&) = delete;
+    ConcurrentExecutor& operator=(const ConcurrentExecutor&) = delete;
+
+public:
+    // 任意线程调用，入队是一次原子交换；内存不足返回false
+    bool Submit(const std::string& commands) noexcept;
+
+    // 消费者调用：执行队列中已有的批次，返回执行的批次数
+    std::size_t Drain(void) noexcept;
+    // 启动后台消费线程，空闲时阻塞等待，不忙等；已启动或创建线程失败返回false
+    bool Start(void) noexcept;
+    // 停止后台消费线程，返回前执行完所有已入队的批次。调用前生产者应已停止提交
+    void Stop(void) noexcept;
+
+    // 已执行完的批次数，任意线程可读；读到的值对应的批次效果对读者可见
+    std::uint64_t Executed(void) const noexcept
+    {
+        return executed.load(std::memory_order_acquire);
+    }
+    // 任意线程调用，不阻塞消费者：最近执行完的批次之后的位姿和车辆状态
+    PublishedState Query(void) const noexcept
+    {
+        return executor->QueryPublished();
+    }
+    // 只能在消费者线程上，或Stop之后访问
+    Executor& Vehicle(void) noexcept
+    {
+        return *executor;
+    }
+    // 从入队到开始执行的排队时间(纳秒)，访问限制同Vehicle
+    const LatencyHistogram& QueueLatency(void) const noexcept
+    {
+        return queueLatency;
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        std::string commands;
+        std::uint64_t enqueuedNs{0};
+    };
+
+    void Push(Node* node) noexcept;
+    // 队列暂时取不出时返回nullptr：为空，或者有生产者交换了head但还没链上next
+    Node* Pop(void) noexcept;
+    bool Empty(void) const noexcept;
+    void Consume(void) noexcept;
+
+private:
+    std::unique_ptr<Executor> executor;
+    Node stub;
+    alignas(64) std::atomic<Node*> head;  // 生产者写入端
+    alignas(64) Node* tail;               // 消费者读取端
+    std::atomic<std::uint64_t> executed{0};
+    LatencyHistogram queueLatency;
+
+    // 后台消费线程空闲时在条件变量上睡眠；生产者只在它睡眠时才加锁唤醒
+    std::thread consumer;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> sleeping{false};
+    std::mutex mutex;
+    std::condition_variable wakeup;
+};
+}  // namespace adas
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+
+namespace adas
+{
+struct EngineState
+{
+    Pose pose;
+    CarMode mode;
+};
+
+bool SameState(const EngineState& lhs, const EngineState& rhs) noexcept;
+std::string FormatState(const EngineState& state);
+
+// 被校验的执行引擎：从initial出发在一次调用中执行完commands，返回最终状态。
+// 差分校验会在多个线程上同时调用，必须可重入
+using EngineRunner = std::function<EngineState(const EngineState& initial, const std::string& commands)>;
+
+// 冻结的参考实现，见ReferenceExecutor.hpp
+EngineState RunReference(const EngineState& initial, const std::string& commands);
+
+// 按执行单位切分指令串：TR为一个单位，其余每个字符一个
+std::vector<std::string> Tokenize(const std::string& commands);
+
+struct DifferentialOptions
+{
+    std::uint64_t seed{1};
+    std::uint64_t cases{10000};
+    std::size_t maxLength{256};
+    unsigned threads{0};        // 0为全部硬件线程
+    double generatedShare{0.5};  // 取自马尔可夫生成语料的比例，其余为均匀随机字符
+};
+
+struct Divergence
+{
+    std::string engine;
+    std::uint64_t caseIndex{0};
+    EngineState initial{};
+    std::string commands;
+    // 前step个单位的结果一致，执行到第step+1个单位token时出现分歧
+    std::size_t step{0};
+    std::size_t offset{0};  // token在commands中的偏移
+    std::string token;
+    EngineState expected{};  // 参考实现执行完前step+1个单位后的状态
+    EngineState actual{};
+    std::string reproducer;  // 最小化后仍能复现分歧的指令串
+};
+
+std::string FormatDivergence(const Divergence& divergence);
+
+struct DifferentialReport
+{
+    std::uint64_t cases{0};
+    std::uint64_t commands{0};  // 所有引擎累计校验的字符数
+    std::vector<Divergence> divergences;  // 每个引擎最多一条，按注册顺序
+};
+
+// 差分校验：把随机和生成的指令串同时交给参考实现和各个优化引擎，
+// 比较最终状态；不一致时定位第一个分歧的执行单位并用ddmin最小化复现串
+class DifferentialHarness final
+{
+public:
+    // 内置引擎的唯一注册点，diff_check和测试都用这一组。每种执行路径(新的执行入口、调用方式、
+    // 求值实现)都要在这里注册一个引擎，否则随机校验覆盖不到它
+    static DifferentialHarness WithBuiltinEngines(void);
+
+public:
+    void AddEngine(const std::string& name, EngineRunner runner);
+    // 按注册顺序
+    std::vector<std::string> EngineNames(void) const;
+
+    DifferentialReport Run(const DifferentialOptions& options) const;
+    // 校验一条指定的指令串，返回各个出现分歧的引擎
+    std::vector<Divergence> Check(const EngineState& initial, const std::string& commands) const;
+
+private:
+    struct Engine
+    {
+        std::string name;
+        EngineRunner runner;
+    };
+
+    static bool Diverges(const Engine& engine, const EngineState& initial, const std::string& commands);
+    static Divergence Explain(const Engine& engine, const EngineState& initial, const std::string& commands);
+
+private:
+    std::vector<Engine> engines;
+};
+}  // namespace adas
@@ -1,8 +1,15 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace adas
 {
+class ExecutorListener;
+class Geofence;
+class ObstacleMap;
+struct ExecutorCounters;
+
 struct Pose
 {
     int x;
@@ -10,13 +17,97 @@ struct Pose
     char heading;
 };
 
+struct GridPoint
+{
+    int x;
+    int y;
+};
+
+enum class CarType : unsigned char {
+    NORMAL,
+    SPORTS,
+    BUS
+};
+
+// 车辆的初始类型与状态，用于直接构造处于任意模式的执行器
+struct CarMode
+{
+    CarType carType{CarType::NORMAL};
+    bool fast{false};
+    bool reverse{false};
+};
+
+// 自创建、Reset或ResetStats以来的行驶路径统计，用于计费和地理围栏
+struct PathStats
+{
+    std::uint64_t distance;  // 行驶的总格数，倒车和掉头的移动都计入
+    int minX;                // 路径经过的所有格子(含起点)的外接矩形
+    int minY;
+    int maxX;
+    int maxY;
+    int dx;  // 净位移
+    int dy;
+};
+
+// 执行器发布的状态，见Executor::QueryPublished
+struct PublishedState
+{
+    Pose pose;
+    CarMode mode;
+    std::uint64_t version;  // 发布次数，构造后为0
+};
+
+// 可恢复的执行位置，见Executor::ExecuteSome。指令串在执行完之前必须保持有效且不被修改
+struct ExecuteCursor
+{
+    ExecuteCursor(void) noexcept = default;
+    explicit ExecuteCursor(const std::string& commands) noexcept : commands(&commands)
+    {
+    }
+
+    bool Done(void) const noexcept
+    {
+        return commands == nullptr || finished;
+    }
+
+    const std::string* commands{nullptr};
+    std::size_t offset{0};  // 下一条待执行指令的位置，不会停在TR的T和R之间
+    bool finished{false};   // 已执行完并计为一次Execute
+};
+
 class Executor
 {
 public:
     virtual ~Executor() = default;
     virtual void Execute(const std::string& command) noexcept = 0;
+    // 从cursor处最多执行maxCommands条指令(TR算一条)，前移cursor并返回实际执行的条数。
+    // 车型、加速、倒车状态保存在执行器中；分多次执行完与一次Execute结果相同，执行完时计一次Execute
+    virtual std::size_t ExecuteSome(ExecuteCursor& cursor, const std::size_t maxCommands) noexcept = 0;
+    // 执行到第一条会驶出围栏的指令之前停下，返回该指令在串中的位置，全部执行完返回commands.size()。
+    // 会驶出围栏的指令整条不执行；起点不在围栏内时不执行任何指令。计一次Execute
+    virtual std::size_t ExecuteWithin(const std::string& commands, const Geofence& fence) noexcept = 0;
     virtual Pose Query(void) const noexcept = 0;
-    
+    // 查询Pose中不可见的车型与加速/倒车状态
+    virtual CarMode QueryMode(void) const noexcept = 0;
+    // 可在任意线程与执行并发调用，不阻塞执行线程：返回最近一次发布的位姿和车辆状态，两者来自同一次发布。
+    // Execute、ExecuteSome、ExecuteWithin和Reset在返回前各发布一次；执行到一半的状态不可见
+    virtual PublishedState QueryPublished(void) const noexcept = 0;
+    // 复用执行器：恢复到给定位姿和车辆状态，不释放内存
+    virtual void Reset(const Pose& pose, const CarMode& mode = CarMode{}) noexcept = 0;
+    // 安装事件监听器，传入nullptr卸载；Reset会卸载监听器
+    virtual void SetListener(ExecutorListener* listener) noexcept = 0;
+    // 安装障碍物地图，传入nullptr卸载；Reset会卸载地图。移动撞上障碍时停在障碍前一格，
+    // 指令的其余部分(转向、转向后的移动)照常执行。执行期间不能修改地图
+    virtual void SetObstacleMap(const ObstacleMap* map) noexcept = 0;
+    // 本执行器自创建或上次Reset以来的执行计数，定义见ExecutorMetrics.hpp
+    virtual ExecutorCounters QueryCounters(void) const noexcept = 0;
+    // 与Query一样是执行到当前为止的结果，统计在执行时增量维护，查询是O(1)的
+    virtual PathStats QueryStats(void) const noexcept = 0;
+    // 从当前位置重新开始统计，不影响位姿和计数
+    virtual void ResetStats(void) noexcept = 0;
+
     static Executor* NewExecutor(const Pose& pose = {0, 0, 'N'}) noexcept;
+    // 直接以指定车型和状态构造，无需回放"NFB"之类的切换指令
+    static Executor* NewExecutor(const Pose& pose, const CarMode& mode) noexcept;
 };
 }  // namespace adas
\ No newline at end of file
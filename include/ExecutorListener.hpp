@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include "Executor.hpp"
+
+namespace adas
+{
+enum class ExecutorEventType : unsigned char {
+    MOVE,             // M
+    TURN,             // L、R、TR
+    MODE_TOGGLE,      // F、B
+    CAR_TYPE_SWITCH,  // 实际发生切换的N、U
+};
+
+struct ExecutorEvent
+{
+    ExecutorEventType type;
+    char command;     // 触发事件的指令，掉头为'T'
+    unsigned repeat;  // 合并的连续同向移动次数，其他事件为1
+    Pose from;
+    Pose to;
+    CarMode mode;  // 事件发生后的车辆状态
+};
+
+// 位姿变化监听器。事件按批投递，连续的同向移动合并为一个事件，
+// 每次Execute至少在结束时投递一次剩余事件；events指针仅在回调期间有效
+class ExecutorListener
+{
+public:
+    virtual ~ExecutorListener() = default;
+    virtual void OnEvents(const ExecutorEvent* events, const std::size_t count) noexcept = 0;
+};
+}  // namespace adas
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace adas
+{
+enum class ExecutorCounter : unsigned char {
+    COMMAND_M,  // 按指令统计实际执行的次数
+    COMMAND_L,
+    COMMAND_R,
+    COMMAND_F,
+    COMMAND_B,
+    COMMAND_N,
+    COMMAND_U,
+    COMMAND_TR,
+    UNKNOWN_SKIPPED,        // 跳过的未知字符
+    TR_IGNORED_IN_REVERSE,  // 倒车状态下忽略的TR
+    N_REFUSED_IN_BUS,       // Bus状态下拒绝的N
+    CAR_TYPE_SWITCHES,      // 车型切换次数
+    GRID_STEPS,             // 累计移动格数
+    EXECUTE_CALLS,          // Execute调用次数
+    COUNT
+};
+
+struct ExecutorCounters
+{
+    static constexpr std::size_t SIZE = static_cast<std::size_t>(ExecutorCounter::COUNT);
+
+    std::uint64_t& operator[](const ExecutorCounter counter) noexcept
+    {
+        return values[static_cast<std::size_t>(counter)];
+    }
+    std::uint64_t operator[](const ExecutorCounter counter) const noexcept
+    {
+        return values[static_cast<std::size_t>(counter)];
+    }
+    ExecutorCounters& operator+=(const ExecutorCounters& rhs) noexcept
+    {
+        for (std::size_t i = 0; i < SIZE; ++i) {
+            values[i] += rhs.values[i];
+        }
+        return *this;
+    }
+
+    std::uint64_t values[SIZE]{};
+};
+
+// 进程级计数：各线程的分片(含已退出线程)之和。
+// 执行器每32次Execute、Reset和析构时把计数并入所在线程的分片，
+// 因此快照对每个存活的执行器最多滞后32次Execute调用
+ExecutorCounters SnapshotGlobalCounters(void) noexcept;
+
+// 以Prometheus文本格式输出计数
+std::string FormatPrometheus(const ExecutorCounters& counters);
+
+// 将进程级计数快照写入文件：先写临时文件再改名，采集方不会读到半个文件
+bool WritePrometheus(const std::string& path) noexcept;
+}  // namespace adas
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Executor.hpp"
+
+namespace adas
+{
+class ExecutorImpl;
+
+// 执行器对象池：按slab批量预分配内存，在其中原地构造执行器。
+// 归还的执行器不析构，下次Acquire时通过Reset复用。
+// 池本身不是线程安全的，每个工作线程应持有自己的池；池的生命周期必须长于其发出的所有句柄。
+class ExecutorPool final
+{
+public:
+    class Deleter final
+    {
+    public:
+        Deleter(void) noexcept = default;
+        explicit Deleter(ExecutorPool* pool) noexcept;
+        void operator()(Executor* executor) const noexcept;
+
+    private:
+        ExecutorPool* pool{nullptr};
+    };
+
+    using Handle = std::unique_ptr<Executor, Deleter>;
+
+public:
+    explicit ExecutorPool(const std::size_t slabSize = 1024) noexcept;
+    ~ExecutorPool() noexcept;
+
+    ExecutorPool(const ExecutorPool&) = delete;
+    ExecutorPool& operator=(const ExecutorPool&) = delete;
+
+public:
+    // 内存不足时返回空句柄
+    Handle Acquire(const Pose& pose = {0, 0, 'N'}, const CarMode& mode = CarMode{}) noexcept;
+    void Release(Executor* executor) noexcept;
+
+    std::size_t Capacity(void) const noexcept;
+    std::size_t InUse(void) const noexcept;
+
+private:
+    struct Slab;
+
+    ExecutorImpl* Construct(const Pose& pose, const CarMode& mode) noexcept;
+
+private:
+    std::size_t slabSize;
+    std::vector<std::unique_ptr<Slab>> slabs;
+    std::vector<ExecutorImpl*> freeList;  // 已构造、等待复用的执行器
+    std::size_t used{0};                  // 最后一个slab中已构造的槽位数
+    std::size_t inUse{0};
+};
+}  // namespace adas
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Executor.hpp"
+
+namespace adas
+{
+// HDR风格的对数分桶直方图：每个2的幂区间再分16个子桶，相对误差不超过1/16
+class LatencyHistogram final
+{
+public:
+    static constexpr unsigned SUB_BUCKETS = 16;
+    static constexpr std::size_t BUCKETS = 61 * SUB_BUCKETS;
+
+    static std::size_t IndexOf(const std::uint64_t value) noexcept;
+    // 桶内最大值，分位数按此保守上报
+    static std::uint64_t UpperBound(const std::size_t index) noexcept;
+
+public:
+    void Record(const std::uint64_t value) noexcept;
+    void Merge(const LatencyHistogram& rhs) noexcept;
+
+    std::uint64_t Count(void) const noexcept;
+    std::uint64_t Max(void) const noexcept;
+    // quantile取值[0, 1]，无样本时返回0
+    std::uint64_t Percentile(const double quantile) const noexcept;
+
+    std::uint64_t buckets[BUCKETS]{};
+};
+
+enum ProfilingMode : unsigned {
+    PROFILE_NONE = 0,
+    PROFILE_LATENCY = 1,  // 按车型记录每次Execute的耗时
+    PROFILE_TRACE = 2,    // 记录Chrome trace事件
+};
+
+// 打开/关闭插桩，mode为ProfilingMode按位或；关闭时每次Execute只多一次原子读
+void SetProfilingMode(const unsigned mode) noexcept;
+unsigned GetProfilingMode(void) noexcept;
+
+// 清空所有线程已记录的直方图和trace事件
+void ResetProfiling(void) noexcept;
+
+// 按Execute开始时的车型汇总各线程的耗时直方图(纳秒)
+LatencyHistogram SnapshotLatency(const CarType carType) noexcept;
+
+// 写出各车型的p50/p99/p999/max文本报告
+bool WriteLatencyReport(const std::string& path) noexcept;
+
+// 写出Chrome trace-event JSON，可用chrome://tracing或Perfetto打开。
+// 包含Execute、命令表切换(含车型注册时的编译)和车型切换的耗时区间
+bool WriteChromeTrace(const std::string& path) noexcept;
+}  // namespace adas
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+#include "ExecutorPool.hpp"
+
+namespace adas
+{
+using VehicleId = std::uint32_t;
+constexpr VehicleId INVALID_VEHICLE = 0xFFFFFFFF;
+
+// 一个tick内车辆的起点和终点
+struct VehicleMove
+{
+    GridPoint from;
+    GridPoint to;
+    VehicleId id;
+};
+
+enum class CollisionKind : std::uint8_t {
+    SAME_CELL,  // tick结束时在同一格
+    SWAP,       // 这个tick互换了位置
+};
+
+// first < second；cell为同在的格子，互换时为first的终点
+struct Collision
+{
+    VehicleId first;
+    VehicleId second;
+    CollisionKind kind;
+    GridPoint cell;
+};
+
+class CollisionDetector;
+
+// 车队：在对象池中持有执行器，按均匀网格维护车辆位置的空间索引。
+// 通过Fleet::Execute执行时增量更新索引，区域和最近邻查询只访问网格，不调用执行器的Query。
+// 车队不是线程安全的
+class Fleet final
+{
+public:
+    // 网格边长为2^cellBits格；每格的平均车辆数在几辆到几十辆之间时查询最快
+    explicit Fleet(const unsigned cellBits = 6) noexcept;
+    ~Fleet() noexcept;
+
+    Fleet(const Fleet&) = delete;
+    Fleet& operator=(const Fleet&) = delete;
+
+public:
+    // 内存不足时返回INVALID_VEHICLE；移除的车辆编号会被复用
+    VehicleId Add(const Pose& pose, const CarMode& mode = CarMode{}) noexcept;
+    void Remove(const VehicleId id) noexcept;
+    bool Contains(const VehicleId id) const noexcept;
+    std::size_t Size(void) const noexcept
+    {
+        return size;
+    }
+
+    // 执行后把车辆移到新位置所在的格子。索引扩容时内存不足抛出std::bad_alloc，此时索引中仍是执行前的位置
+    void Execute(const VehicleId id, const std::string& commands);
+    // 执行一个tick：commands[id]为车辆id本tick的指令，超出范围或编号未使用的忽略。
+    // 各车辆在threads个线程上并行执行(0取硬件线程数)，然后更新索引，最后按起止位置检测车辆间的碰撞：
+    // 结束时同在一格，或者互换了位置(只看起止位置，不看途中经过的格子)。同一格的n辆车报告n(n-1)/2对。
+    // 内存不足抛出std::bad_alloc、创建线程失败抛出std::system_error，此时车辆已执行，部分车辆在索引中可能仍是执行前的位置
+    void Tick(const std::vector<std::string>& commands, std::vector<Collision>& collisions,
+              const unsigned threads = 0);
+    // 只读访问，用于查询状态和统计；不要绕过Fleet::Execute移动车辆
+    const Executor& Vehicle(const VehicleId id) const noexcept;
+    GridPoint Position(const VehicleId id) const noexcept;
+
+    // 安装到所有现有和之后加入的车辆，见Executor::SetObstacleMap
+    void SetObstacleMap(const ObstacleMap* map) noexcept;
+
+    // 矩形(含边界)内的所有车辆，顺序不定
+    void QueryRect(const GridPoint& corner, const GridPoint& opposite, std::vector<VehicleId>& result) const;
+    // 曼哈顿距离(没有障碍时的行驶格数)最近的k辆车，由近到远，距离相同时编号小的在前
+    void QueryNearest(const GridPoint& center, const std::size_t k, std::vector<VehicleId>& result) const;
+
+private:
+    struct Entry
+    {
+        int x;
+        int y;
+        VehicleId id;
+    };
+
+    // 格子空了也保留：车辆常在相邻格子间往返，不反复分配和释放
+    struct Cell
+    {
+        std::int64_t x;
+        std::int64_t y;
+        std::vector<Entry> entries;
+    };
+
+    struct Slot
+    {
+        ExecutorPool::Handle executor;  // 空表示编号未使用
+        std::uint32_t cell{0};          // cells下标
+        std::uint32_t index{0};         // 在所在格子中的下标
+    };
+
+    // 格子坐标到cells下标的开放寻址哈希表，线性探测，装载率不超过1/2
+    struct Bucket
+    {
+        std::uint64_t key;
+        std::uint32_t cell;  // NO_CELL表示空桶
+    };
+
+    static constexpr std::uint32_t NO_CELL = 0xFFFFFFFF;
+
+    std::uint32_t FindCell(const std::int64_t cellX, const std::int64_t cellY) const noexcept;
+    // 没有就创建；内存不足时抛出std::bad_alloc，此时不做任何修改
+    std::uint32_t FindOrAddCell(const std::int64_t cellX, const std::int64_t cellY);
+
+    // 加入(x, y)所在的格子并记录在slots[id]中
+    void Insert(const VehicleId id, const int x, const int y);
+    // 移除第cell个格子中的第index项
+    void Erase(const std::uint32_t cell, const std::uint32_t index) noexcept;
+    // 执行一辆车并记录到moves[id]；没换格子时顺便更新索引项。不同车辆可以并发调用
+    void TickOne(const VehicleId id, const std::string* commands) noexcept;
+
+private:
+    unsigned cellBits;
+    ExecutorPool pool;  // 必须先于slots构造、后于slots析构
+    std::vector<Slot> slots;
+    std::vector<VehicleId> freeIds;
+    std::size_t size{0};
+    std::vector<Cell> cells;
+    std::vector<Bucket> buckets;
+    // 所有格子的外接范围，限定最近邻搜索的圈数
+    std::int64_t minCellX{0};
+    std::int64_t maxCellX{-1};
+    std::int64_t minCellY{0};
+    std::int64_t maxCellY{-1};
+    const ObstacleMap* obstacles{nullptr};
+    std::vector<VehicleMove> moves;  // Tick的缓冲区，按编号存放
+    std::unique_ptr<CollisionDetector> detector;
+};
+}  // namespace adas
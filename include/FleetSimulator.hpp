@@ -0,0 +1,137 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+#include "ExecutorPool.hpp"
+
+namespace adas
+{
+struct FleetSimulatorOptions
+{
+    unsigned threads{0};        // 0取硬件线程数
+    bool deterministic{false};  // 在调用Tick的线程上按编号顺序执行，执行器的副作用(计数、剖析)顺序可复现
+};
+
+// 最近一次Tick和累计的耗时，单位纳秒。等待时间是等读者释放后台缓冲的时间
+struct FleetTickStats
+{
+    std::uint64_t ticks{0};
+    std::uint64_t commands{0};  // 累计指令串的总字节数
+    std::uint64_t lastNs{0};
+    std::uint64_t minNs{0};
+    std::uint64_t maxNs{0};
+    std::uint64_t totalNs{0};
+    std::uint64_t lastWaitNs{0};
+    std::uint64_t totalWaitNs{0};
+};
+
+// 按tick推进的车队模拟：每个tick所有车辆并行执行一批指令，位姿按列写入后台缓冲，
+// 写完后原子地切换前后台。读者通过Snapshot读取最近一个完整的tick，不加锁，也不会读到执行到一半的状态。
+// 车辆集合在构造时确定；Tick只能由一个线程调用，Read可以在任意线程并发调用
+class FleetSimulator final
+{
+private:
+    struct Buffer
+    {
+        std::uint64_t tick{0};
+        std::vector<int> x;
+        std::vector<int> y;
+        std::vector<char> heading;
+        std::vector<CarMode> mode;
+        mutable std::atomic<std::uint32_t> readers{0};  // 持有本缓冲快照的读者数
+    };
+
+public:
+    // 某个tick的只读视图，存在期间对应的缓冲不会被改写。不要长期持有：Tick会等待它释放后才能复用该缓冲
+    class Snapshot final
+    {
+    public:
+        Snapshot(Snapshot&& other) noexcept;
+        Snapshot& operator=(Snapshot&&) = delete;
+        ~Snapshot() noexcept;
+
+        // 构造后为第0个tick，之后每次Tick加一
+        std::uint64_t Tick(void) const noexcept
+        {
+            return buffer->tick;
+        }
+        std::size_t Size(void) const noexcept
+        {
+            return buffer->x.size();
+        }
+        Pose At(const std::size_t vehicle) const noexcept
+        {
+            return Pose{buffer->x[vehicle], buffer->y[vehicle], buffer->heading[vehicle]};
+        }
+        CarMode Mode(const std::size_t vehicle) const noexcept
+        {
+            return buffer->mode[vehicle];
+        }
+        const int* X(void) const noexcept
+        {
+            return buffer->x.data();
+        }
+        const int* Y(void) const noexcept
+        {
+            return buffer->y.data();
+        }
+        const char* Heading(void) const noexcept
+        {
+            return buffer->heading.data();
+        }
+        const CarMode* Modes(void) const noexcept
+        {
+            return buffer->mode.data();
+        }
+
+    private:
+        friend class FleetSimulator;
+        explicit Snapshot(const Buffer* buffer) noexcept : buffer(buffer)
+        {
+        }
+
+        const Buffer* buffer;
+    };
+
+public:
+    // 内存不足抛出std::bad_alloc
+    explicit FleetSimulator(const std::vector<Pose>& poses, const FleetSimulatorOptions& options = {});
+    FleetSimulator(const std::vector<Pose>& poses, const std::vector<CarMode>& modes,
+                   const FleetSimulatorOptions& options = {});
+
+    FleetSimulator(const FleetSimulator&) = delete;
+    FleetSimulator& operator=(const FleetSimulator&) = delete;
+
+public:
+    std::size_t Size(void) const noexcept
+    {
+        return vehicles.size();
+    }
+
+    // commands[i]是第i辆车本tick的指令，缺少的车辆本tick不动
+    // 创建线程失败抛出std::system_error，此时车辆已执行，但本tick没有发布
+    void Tick(const std::vector<std::string>& commands);
+    Snapshot Read(void) const noexcept;
+
+    // 只能在调用Tick的线程读取
+    const FleetTickStats& Stats(void) const noexcept
+    {
+        return stats;
+    }
+
+private:
+    void Publish(Buffer& buffer, const std::size_t begin, const std::size_t end) noexcept;
+
+private:
+    FleetSimulatorOptions options;
+    ExecutorPool pool;  // 必须先于vehicles构造、后于vehicles析构
+    std::vector<ExecutorPool::Handle> vehicles;
+    std::vector<const Executor*> executors;  // 与vehicles相同，供QueryBatch按列读取
+    Buffer buffers[2];
+    std::atomic<unsigned> front{0};
+    FleetTickStats stats;
+};
+}  // namespace adas
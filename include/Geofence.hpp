@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Executor.hpp"
+
+namespace adas
+{
+// 允许行驶的区域，按格点判断：边界上的格点算在围栏内。
+// 多边形在构造时按行和按列编译成格点区间，沿坐标轴走一段只需查一次区间，与段长无关
+class Geofence final
+{
+public:
+    // 编译多边形的上限：外接矩形的宽高之和决定区间表的行数，再乘以边数是编译的耗时
+    static constexpr std::uint64_t MAX_POLYGON_LINES = 1 << 21;
+    static constexpr std::uint64_t MAX_POLYGON_COST = 1 << 27;
+
+    // 不含任何格点的空围栏
+    Geofence(void) noexcept = default;
+
+    // 以两个对角为边界的矩形
+    static Geofence Rectangle(const GridPoint& corner, const GridPoint& opposite) noexcept;
+    // 顶点按顺序首尾相连，自交时按奇偶规则判断内外；不足3个顶点时只含折线经过的格点。
+    // 成功时把fence替换为该多边形；超出上面两个上限或内存不足时返回false，fence不变
+    static bool Polygon(const std::vector<GridPoint>& vertices, Geofence& fence) noexcept;
+
+public:
+    bool Contains(const GridPoint& point) const noexcept;
+
+    // 从from出发沿(dirX, dirY)(坐标轴方向的单位向量)最多走steps步，返回不离开围栏能走的步数；
+    // from不在围栏内时返回0
+    std::uint64_t StepsInside(const GridPoint& from, const int dirX, const int dirY,
+                              const std::uint64_t steps) const noexcept;
+
+private:
+    struct Interval
+    {
+        int low;
+        int high;
+    };
+
+    // 每行(或每列)围栏内格点的有序区间，相邻区间之间至少隔一个围栏外的格点
+    struct Lines
+    {
+        // 查找第line行包含pos的区间，不在围栏内返回nullptr
+        const Interval* Find(const int line, const int pos) const noexcept;
+
+        int first{0};
+        std::vector<std::size_t> offsets;  // 第first + i行的区间为intervals[offsets[i], offsets[i + 1])
+        std::vector<Interval> intervals;
+    };
+
+private:
+    bool rectangle{true};
+    Interval xRange{0, -1};  // 外接矩形
+    Interval yRange{0, -1};
+    Lines rows;  // 按y分行，区间为x
+    Lines columns;
+};
+}  // namespace adas
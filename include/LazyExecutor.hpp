@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include "Executor.hpp"
+
+namespace adas
+{
+struct LazyOptions
+{
+    // 待执行日志的上限，追加会超出时先把日志执行掉
+    std::size_t maxPendingBytes{64 * 1024};
+};
+
+// 惰性执行器：Execute只把指令追加到待执行日志，Query、QueryMode、QueryCounters或Flush时
+// 才把日志拼成一条长指令串一次执行，长指令串走向量化求值并折叠整块相同的指令。
+// 结果与逐次Execute完全一致；监听器的事件在日志执行时才投递，QueryPublished也只反映已执行的日志。
+// 可以传给QueryBatch，它对惰性执行器调用Query，待执行的日志先被执行
+class LazyExecutor : public Executor
+{
+public:
+    // 立即执行全部待执行指令
+    virtual void Flush(void) noexcept = 0;
+    // 待执行日志当前占用的字节数
+    virtual std::size_t PendingBytes(void) const noexcept = 0;
+
+    static LazyExecutor* NewLazyExecutor(const Pose& pose = {0, 0, 'N'}, const CarMode& mode = CarMode{},
+                                         const LazyOptions& options = LazyOptions{}) noexcept;
+};
+}  // namespace adas
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Executor.hpp"
+
+namespace adas
+{
+// 障碍物栅格：按64x64格分块的位图，只为有障碍的块分配内存。
+// 每块同时按行和按列各存一份，沿任一坐标轴都按64位字扫描，一个空块整块跳过
+class ObstacleMap final
+{
+public:
+    static constexpr int TILE_BITS = 6;
+    static constexpr int TILE_SIZE = 1 << TILE_BITS;
+
+public:
+    // 内存不足时抛出std::bad_alloc
+    void Block(const GridPoint& cell);
+    void Unblock(const GridPoint& cell) noexcept;
+    bool Blocked(const GridPoint& cell) const noexcept;
+
+    // 从from(不检查from本身)沿(dirX, dirY)(坐标轴方向的单位向量)最多走steps步，
+    // 返回撞上障碍前能走的步数；耗时与距离/64成正比
+    std::uint64_t FreeSteps(const GridPoint& from, const int dirX, const int dirY,
+                            const std::uint64_t steps) const noexcept;
+
+    // 已分配的块数
+    std::size_t TileCount(void) const noexcept
+    {
+        return tiles.size();
+    }
+
+private:
+    struct Tile
+    {
+        std::uint64_t rows[TILE_SIZE];     // rows[y]的第x位
+        std::uint64_t columns[TILE_SIZE];  // columns[x]的第y位
+    };
+
+    const Tile* Find(const std::int64_t tileX, const std::int64_t tileY) const noexcept;
+
+    // 沿一行(或一列)扫描：line为行号(列号)，pos为起点，返回[1, steps]内第一个障碍的距离，没有返回steps + 1
+    std::uint64_t Scan(const bool horizontal, const std::int64_t line, const std::int64_t pos, const int dir,
+                       const std::uint64_t steps) const noexcept;
+
+private:
+    std::unordered_map<std::uint64_t, std::size_t> index;  // 块坐标 -> tiles下标
+    std::vector<Tile> tiles;
+};
+}  // namespace adas
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include "Executor.hpp"
+
+namespace adas
+{
+// 冻结的参考实现：逐字符解释指令，语义与最初的ExecutorImpl/Command.hpp保持一致，
+// 包括加速转向先走一步、跑车转向后再走一步、Bus先走再转、倒车忽略TR等特殊行为。
+// 只用于差分校验，不要为性能修改
+class ReferenceExecutor final
+{
+public:
+    explicit ReferenceExecutor(const Pose& pose = {0, 0, 'N'}, const CarMode& mode = CarMode{}) noexcept;
+
+public:
+    void Execute(const std::string& commands) noexcept;
+    Pose Query(void) const noexcept;
+    CarMode QueryMode(void) const noexcept;
+
+private:
+    void Step(const int count) noexcept;
+    void Turn(const bool left) noexcept;
+    void TurnCommand(const bool left) noexcept;
+    void SwitchTo(const CarType type) noexcept;
+
+private:
+    int x;
+    int y;
+    unsigned heading;  // 0E 1S 2W 3N
+    CarMode mode;
+};
+}  // namespace adas
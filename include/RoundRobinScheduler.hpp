@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Executor.hpp"
+
+namespace adas
+{
+// 轮转调度：每轮给每个有待执行指令的执行器最多quantum条指令的时间片，
+// 超长指令串分成多片执行，不会阻塞其他执行器。同一执行器提交的指令串按提交顺序执行。
+// 一个执行器两次时间片之间最多等待(活跃执行器数 - 1) * quantum条指令。
+// 调度器不是线程安全的，由一个调度线程使用。
+// 调度器只在执行器有待执行任务时引用它：任务执行完或被Remove丢弃后不再记录该执行器，
+// 销毁执行器或把它归还ExecutorPool之前，要么等它的任务执行完，要么先调用Remove；
+// 池复用同一地址的执行器再提交时按新的执行器处理
+class RoundRobinScheduler final
+{
+public:
+    explicit RoundRobinScheduler(const std::size_t quantum = 4096) noexcept;
+
+public:
+    // 复制指令串入队；内存不足时返回false
+    bool Submit(Executor& executor, std::string commands) noexcept;
+
+    // 丢弃执行器尚未执行的任务，执行到一半的指令串停在当前位置；返回丢弃的指令串数。
+    // 复杂度与有待执行指令的执行器数成正比
+    std::size_t Remove(Executor& executor) noexcept;
+
+    // 执行一轮，返回执行的指令数
+    std::size_t RunRound(void) noexcept;
+
+    // 反复执行时间片直到全部完成或到达deadline；每片之后检查一次时间，最多超出一片的耗时
+    std::size_t RunUntil(const std::chrono::steady_clock::time_point deadline) noexcept;
+
+    // 执行完所有已提交的指令串
+    std::size_t RunAll(void) noexcept;
+
+    bool Idle(void) const noexcept;
+    // 有待执行指令的执行器数
+    std::size_t ActiveExecutors(void) const noexcept;
+
+private:
+    struct Lane
+    {
+        Executor* executor;
+        std::deque<std::string> tasks;
+        std::size_t offset{0};  // 队首指令串已执行到的位置
+    };
+
+    // 给active[next]一个时间片，任务全部完成的lane移出active并归还
+    std::size_t RunSlice(void) noexcept;
+    // 把active[position]移出active
+    void Deactivate(const std::size_t position) noexcept;
+    // 清空lane并归还到freeLanes
+    void ReleaseLane(const std::size_t index) noexcept;
+
+private:
+    std::size_t quantum;
+    std::vector<Lane> lanes;  // 只增不减，空闲的lane保留队列的内存供下一个执行器复用
+    std::vector<std::size_t> freeLanes;  // 容量不小于lanes.size()，归还时不分配内存
+    std::unordered_map<Executor*, std::size_t> laneOf;  // 只含有待执行任务的执行器
+    std::vector<std::size_t> active;  // 有待执行任务的lane
+    std::size_t next{0};              // 下一个时间片轮到的active下标，跨RunUntil保持轮转顺序
+};
+}  // namespace adas
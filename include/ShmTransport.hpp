@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CommandProtocol.hpp"
+#include "CommandServer.hpp"
+
+namespace adas
+{
+class FrameHandler;
+struct ShmSegment;
+struct ShmSlot;
+
+struct ShmTransportOptions
+{
+    unsigned slots{64};              // 可同时连接的客户端数
+    std::size_t ringBytes{1 << 18};  // 每个方向的环大小，向上取2的幂；单个请求帧不能超过它
+};
+
+// 共享内存传输的服务端：用shm_open按名字创建共享内存段，每个客户端占一个槽位，
+// 槽位中有请求、应答两个单生产者单消费者环，多个客户端的请求环合起来由一个消费循环轮询。
+// 帧格式与CommandServer相同(见CommandProtocol.hpp)，同一客户端的应答按请求顺序写入它的应答环；
+// 应答环写满时暂不处理该客户端的请求。消费循环空闲时先自旋，再在futex上睡眠，由客户端唤醒
+class ShmCommandServer final
+{
+public:
+    explicit ShmCommandServer(const std::string& name,
+                              const ShmTransportOptions& options = ShmTransportOptions{}) noexcept;
+    // 解除映射并删除共享内存名，已连接的客户端不再得到应答。调用时Run必须已经返回
+    ~ShmCommandServer() noexcept;
+
+    ShmCommandServer(const ShmCommandServer&) = delete;
+    ShmCommandServer& operator=(const ShmCommandServer&) = delete;
+
+public:
+    // 创建共享内存段，同名的旧段先删除；失败返回false并保留errno
+    bool Create(void) noexcept;
+
+    // 处理各客户端已到达的请求，回收已断开的槽位，返回处理的帧数。不睡眠，可以嵌入调用方自己的循环
+    std::size_t Poll(void) noexcept;
+    // 在调用线程上循环Poll直到Stop
+    void Run(void) noexcept;
+    // Create之后可在任意线程或信号处理函数中调用，Run尚未开始时之后的Run立即返回
+    void Stop(void) noexcept;
+
+    // accepted、closed为连接、断开的客户端数。只能在运行消费循环的线程上，或Run返回之后读取
+    const CommandServerStats& Stats(void) const noexcept
+    {
+        return stats;
+    }
+    std::size_t Vehicles(void) const noexcept;
+
+private:
+    ShmSlot& SlotAt(const unsigned index) const noexcept;
+    std::size_t PollSlot(const unsigned index) noexcept;
+
+private:
+    std::string name;
+    ShmTransportOptions options;
+    ShmSegment* segment{nullptr};
+    std::size_t size{0};
+    std::unique_ptr<FrameHandler> handler;
+    std::vector<char> scratch;   // 跨过环尾的请求负载拷到这里再处理
+    std::vector<bool> attached;  // 各槽位是否已计入accepted
+    std::atomic<bool> stopping{false};
+    CommandServerStats stats;
+};
+
+// 共享内存传输的客户端：连接时占用一个空闲槽位。提交和接收都不经过系统调用，
+// 只有服务端在睡眠时提交才唤醒它，接收时没有应答才睡眠。一个客户端对象只能由一个线程使用
+class ShmCommandClient final
+{
+public:
+    ShmCommandClient(void) noexcept = default;
+    ~ShmCommandClient() noexcept;
+
+    ShmCommandClient(const ShmCommandClient&) = delete;
+    ShmCommandClient& operator=(const ShmCommandClient&) = delete;
+
+public:
+    // 失败返回false：共享内存段不存在或格式不符时保留errno，没有空闲槽位时errno为EBUSY
+    bool Attach(const std::string& name) noexcept;
+    // 释放槽位，尚未处理的请求和未取走的应答被丢弃
+    void Detach(void) noexcept;
+
+    // 请求环剩余空间不足时返回false，不阻塞；取走应答后服务端才会继续消费请求
+    bool Submit(const FrameType type, const std::uint64_t vehicle, const std::uint64_t tag,
+                const char* payload = nullptr, const std::size_t length = 0) noexcept;
+    bool SubmitExecute(const std::uint64_t vehicle, const std::uint64_t tag, const std::string& commands) noexcept;
+    bool SubmitReset(const std::uint64_t vehicle, const std::uint64_t tag, const Pose& pose,
+                     const CarMode& mode = CarMode{}) noexcept;
+
+    // 取走最多max个已到达的应答并返回个数。没有应答时最多等待timeoutNs纳秒，为0时立即返回
+    std::size_t Receive(Response* responses, const std::size_t max, const std::uint64_t timeoutNs = 0) noexcept;
+
+private:
+    std::size_t Take(Response* responses, const std::size_t max) noexcept;
+
+private:
+    ShmSegment* segment{nullptr};
+    std::size_t size{0};
+    ShmSlot* slot{nullptr};
+    char* requestData{nullptr};
+    char* responseData{nullptr};
+    std::uint64_t capacity{0};
+};
+}  // namespace adas
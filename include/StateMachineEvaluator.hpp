@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+namespace adas
+{
+enum class EvaluatorIsa : unsigned char {
+    SCALAR,  // 逐字节查转移表
+    SSSE3,
+    AVX2
+};
+
+// 未安装监听器且不短于VECTOR_THRESHOLD字节的指令串由向量化状态机求值：
+// 对车型内全部16个状态同时做pshufb转移，按组并入实际状态，结果与逐字节执行完全一致
+constexpr std::size_t VECTOR_THRESHOLD = 64;
+
+// 当前CPU支持的最快实现
+EvaluatorIsa BestEvaluatorIsa(void) noexcept;
+
+// 选择Execute使用的实现，超出CPU能力时退回可用的最高级别，返回实际生效的级别
+EvaluatorIsa SetEvaluatorIsa(const EvaluatorIsa isa) noexcept;
+EvaluatorIsa GetEvaluatorIsa(void) noexcept;
+}  // namespace adas
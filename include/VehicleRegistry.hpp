@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+#include "ExecutorPool.hpp"
+
+namespace adas
+{
+struct EpochRecord;
+
+// 按64位编号或字符串名查找执行器的并发注册表。
+// 按键的散列分成多个分片，每个分片有自己的互斥锁、执行器池和开放寻址表；
+// 查找不加锁，只读原子指针，写入在分片锁内进行。摘除的表项和旧表按纪元延迟回收，
+// 查找到的执行器在Guard存续期间不会被归还到池中。
+// 注册表只保证查找和增删并发安全：同一执行器的Execute仍需调用方串行化(例如用ConcurrentExecutor)
+class VehicleRegistry final
+{
+public:
+    // 读临界区：存续期间Find返回的指针保持有效。可以嵌套，不能跨线程传递
+    class Guard final
+    {
+    public:
+        Guard(void) noexcept;
+        ~Guard() noexcept;
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochRecord* record;
+    };
+
+public:
+    explicit VehicleRegistry(const unsigned shardBits = 6) noexcept;
+    // 调用时不能有其他线程在访问注册表
+    ~VehicleRegistry() noexcept;
+
+    VehicleRegistry(const VehicleRegistry&) = delete;
+    VehicleRegistry& operator=(const VehicleRegistry&) = delete;
+
+public:
+    // 键已存在或内存不足时返回false
+    bool Insert(const std::uint64_t id, const Pose& pose, const CarMode& mode = CarMode{}) noexcept;
+    bool Insert(const std::string& name, const Pose& pose, const CarMode& mode = CarMode{}) noexcept;
+    // 键不存在时返回false；执行器在所有可能看到它的读者离开后才归还到池中
+    bool Remove(const std::uint64_t id) noexcept;
+    bool Remove(const std::string& name) noexcept;
+
+    // 任意线程调用，不加锁；不存在时返回nullptr
+    Executor* Find(const Guard& guard, const std::uint64_t id) const noexcept;
+    Executor* Find(const Guard& guard, const std::string& name) const noexcept;
+
+    std::size_t Size(void) const noexcept
+    {
+        return size.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry
+    {
+        std::uint64_t hash;
+        std::uint64_t id;  // 按名字注册时为0
+        std::string name;
+        bool named;
+        ExecutorPool::Handle executor;
+    };
+
+    struct Table
+    {
+        std::size_t mask;
+        std::unique_ptr<std::atomic<Entry*>[]> slots;
+    };
+
+    // 待回收的表项或旧表，retired为摘除时的全局纪元
+    struct Retired
+    {
+        std::uint64_t retired;
+        Entry* entry;
+        Table* table;
+    };
+
+    struct alignas(64) Shard
+    {
+        std::atomic<Table*> table{nullptr};
+        std::mutex mutex;  // 以下成员只在锁内访问
+        ExecutorPool pool;
+        std::size_t used{0};  // 含墓碑的已用槽位数
+        std::size_t live{0};
+        std::vector<Retired> limbo;
+    };
+
+    Shard& ShardOf(const std::uint64_t hash) const noexcept;
+    bool Insert(const std::uint64_t hash, const std::uint64_t id, const std::string* name, const Pose& pose,
+                const CarMode& mode) noexcept;
+    bool Remove(const std::uint64_t hash, const std::uint64_t id, const std::string* name) noexcept;
+    Executor* Find(const std::uint64_t hash, const std::uint64_t id, const std::string* name) const noexcept;
+
+    // capacity为2的幂；内存不足返回nullptr
+    static Table* NewTable(const std::size_t capacity) noexcept;
+    // 在分片锁内调用：表满时按存活项数重建；内存不足返回false
+    bool Reserve(Shard& shard) noexcept;
+    // 在分片锁内、摘除之后调用；limbo必须已预留空间
+    void Retire(Shard& shard, Entry* entry, Table* table) noexcept;
+    // 在分片锁内调用：释放已经安全的待回收对象
+    void Reclaim(Shard& shard) noexcept;
+
+private:
+    unsigned shardBits;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<std::size_t> size{0};
+};
+}  // namespace adas
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+
+namespace adas
+{
+// 最多可注册的车型数(含内置的NORMAL、SPORTS、BUS)
+constexpr std::size_t MAX_CAR_TYPES = 16;
+// 单次移动格数上限，保证编译后的位移能放进转移表
+constexpr unsigned MAX_VEHICLE_STEPS = 15;
+
+// 车型的行为数据，注册时编译成平坦的状态转移表，内置车型也由此定义。
+// 数组下标0为普通状态、1为加速状态；倒车时所有移动反向、左右转互换
+struct VehicleSpec
+{
+    std::string name;
+    unsigned move[2]{1, 2};        // M移动的格数
+    unsigned turnBefore[2]{0, 1};  // L/R转向前移动的格数
+    unsigned turnAfter[2]{0, 0};   // L/R转向后移动的格数
+    std::string onN;               // N切换到的车型，为空时拒绝N
+    std::string onU;               // U切换到的车型，必填
+};
+
+// 注册一组车型，组内可以互相引用，也可以引用已注册的车型；
+// 任何一项非法时整组都不注册，原因写入error
+bool RegisterVehicleTypes(const std::vector<VehicleSpec>& specs, std::string& error);
+
+// 解析配置文本，格式为：
+//   [TRUCK]            # 车型名
+//   move = 1 1         # 普通 加速
+//   turn_before = 1 2
+//   turn_after = 0 0
+//   on_n = -           # - 表示拒绝
+//   on_u = NORMAL
+// 未写出的键取VehicleSpec的默认值
+bool ParseVehicleTypes(const std::string& text, std::vector<VehicleSpec>& specs, std::string& error);
+
+// 读取配置文件并注册其中的车型
+bool LoadVehicleTypes(const std::string& path, std::string& error);
+
+bool FindCarType(const std::string& name, CarType& type) noexcept;
+// 未注册的车型返回"UNKNOWN"
+const char* CarTypeName(const CarType carType) noexcept;
+std::size_t CarTypeCount(void) noexcept;
+}  // namespace adas
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace adas
+{
+// 基础指令M/L/R/F/B在每个游程开始时被选中的相对权重
+struct OpcodeMix
+{
+    double move{0.6};
+    double left{0.12};
+    double right{0.12};
+    double fast{0.08};
+    double back{0.08};
+};
+
+struct WorkloadConfig
+{
+    std::uint64_t seed{1};
+    OpcodeMix mix;
+    // 同一基础指令连续出现的平均次数(几何分布，>=1)，游程结束后换成另一种指令
+    double meanRunLength{2.0};
+    // 以下为每个指令位插入对应内容的概率，总和超过1时按比例截断
+    double carTypeSwitchRate{0.002};  // 插入N或U
+    double busShare{0.5};             // 车型切换中U所占比例
+    double turnRoundRate{0.01};       // 插入TR
+    double junkRate{0.0};             // 插入非指令字符
+    // 按块独立生成，每块的随机序列只由seed和块号决定，结果与线程数无关
+    std::size_t chunkSize{1 << 20};
+};
+
+// 基于带种子马尔可夫模型的指令流生成器：同一配置和长度总是生成相同的指令串
+class WorkloadGenerator final
+{
+public:
+    explicit WorkloadGenerator(const WorkloadConfig& config = WorkloadConfig{}) noexcept;
+
+public:
+    // threads为0时使用全部硬件线程
+    void Generate(char* out, const std::size_t length, const unsigned threads = 0) const;
+    std::string Generate(const std::size_t length, const unsigned threads = 0) const;
+
+    // 分段生成并顺序写出，内存占用与总长度无关；写入失败返回false
+    bool Write(std::FILE* file, const std::uint64_t length, const unsigned threads = 0) const;
+    bool WriteFile(const std::string& path, const std::uint64_t length, const unsigned threads = 0) const;
+
+private:
+    std::size_t RunLength(const std::uint64_t draw) const noexcept;
+    void GenerateChunk(char* out, const std::uint64_t chunk, const std::size_t length) const noexcept;
+
+private:
+    static constexpr unsigned OPCODES = 5;
+
+    WorkloadConfig config;
+    // 插入间隔和游程长度都是几何分布，保存log(1-p)用于逆变换采样
+    double insertLogStay;
+    double runLogStay;
+    // 按随机数高10位查表得到游程长度，区间内结果不唯一时为0，再退回log计算
+    std::uint32_t runTable[1024];
+    // 概率按32位定点数保存，取值[0, 2^32]；前两项为各类插入内容的累积占比
+    std::uint64_t junkThreshold;
+    std::uint64_t switchThreshold;
+    std::uint64_t busThreshold;
+    // 游程起始和换指令时的累积分布，后者排除当前指令
+    std::uint64_t startCumulative[OPCODES];
+    std::uint64_t nextCumulative[OPCODES][OPCODES];
+};
+}  // namespace adas
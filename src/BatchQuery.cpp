@@ -0,0 +1,57 @@
+#include "BatchQuery.hpp"
+#include <typeinfo>
+#include "ExecutorImpl.hpp"
+
+namespace adas
+{
+namespace
+{
+// 预取距离：提前若干个执行器把对象所在缓存行取入
+constexpr std::size_t PREFETCH_DISTANCE = 8;
+
+// ExecutorImpl是final类，比较typeid即可判断，比dynamic_cast便宜；其他实现(如惰性执行器)返回空，由调用方回退到虚函数
+inline const ExecutorImpl* Impl(const Executor* const* executors, const std::size_t index, const std::size_t count)
+{
+    if (index + PREFETCH_DISTANCE < count) {
+        __builtin_prefetch(executors[index + PREFETCH_DISTANCE]);
+    }
+    const Executor& executor = *executors[index];
+    return typeid(executor) == typeid(ExecutorImpl) ? static_cast<const ExecutorImpl*>(&executor) : nullptr;
+}
+
+inline void Read(const Executor* const* executors, const std::size_t index, const std::size_t count, Pose& pose,
+                 CarMode* mode)
+{
+    const ExecutorImpl* impl = Impl(executors, index, count);
+    if (impl != nullptr) {
+        pose = impl->GetPose();
+        if (mode != nullptr) {
+            *mode = impl->GetMode();
+        }
+        return;
+    }
+    pose = executors[index]->Query();
+    if (mode != nullptr) {
+        *mode = executors[index]->QueryMode();
+    }
+}
+}  // namespace
+
+void QueryBatch(const Executor* const* executors, const std::size_t count, const PoseColumns& columns) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        Pose pose;
+        Read(executors, i, count, pose, columns.mode == nullptr ? nullptr : columns.mode + i);
+        columns.x[i] = pose.x;
+        columns.y[i] = pose.y;
+        columns.heading[i] = pose.heading;
+    }
+}
+
+void QueryBatch(const Executor* const* executors, const std::size_t count, Pose* poses, CarMode* modes) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        Read(executors, i, count, poses[i], modes == nullptr ? nullptr : modes + i);
+    }
+}
+}  // namespace adas
@@ -0,0 +1,133 @@
+#include "CollisionDetector.hpp"
+#include <algorithm>
+#include "ParallelFor.hpp"
+
+namespace adas
+{
+namespace
+{
+constexpr unsigned PARTITION_BITS = 6;
+constexpr std::size_t PARTITIONS = std::size_t{1} << PARTITION_BITS;
+
+std::uint64_t Pack(const GridPoint& cell) noexcept
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell.x)) << 32) |
+           static_cast<std::uint32_t>(cell.y);
+}
+
+GridPoint Unpack(const std::uint64_t key) noexcept
+{
+    return GridPoint{static_cast<std::int32_t>(key >> 32), static_cast<std::int32_t>(key)};
+}
+
+std::size_t PartitionOf(const std::uint64_t key, const std::uint64_t other) noexcept
+{
+    return static_cast<std::size_t>(((key ^ (other * 0xC2B2AE3D27D4EB4Full)) * 0x9E3779B97F4A7C15ull) >>
+                                    (64 - PARTITION_BITS));
+}
+}  // namespace
+
+void CollisionDetector::Detect(const std::vector<VehicleMove>& moves, const unsigned threads,
+                               std::vector<Collision>& collisions)
+{
+    collisions.clear();
+    // 每个线程处理连续的一段，写入自己的一组分区
+    const std::size_t chunks = std::max<std::size_t>(1, std::min<std::size_t>(ResolveThreads(threads), moves.size()));
+    const std::size_t chunkSize = (moves.size() + chunks - 1) / chunks;
+    scattered.resize(std::max(scattered.size(), chunks * PARTITIONS));
+    merged.resize(PARTITIONS);
+    tables.resize(PARTITIONS);
+    found.resize(PARTITIONS);
+
+    ParallelFor(chunks, threads, [this, &moves, chunkSize](const std::size_t chunk) {
+        std::vector<Record>* out = &scattered[chunk * PARTITIONS];
+        for (std::size_t p = 0; p < PARTITIONS; ++p) {
+            out[p].clear();
+        }
+        const std::size_t end = std::min(moves.size(), (chunk + 1) * chunkSize);
+        for (std::size_t i = chunk * chunkSize; i < end; ++i) {
+            const VehicleMove& move = moves[i];
+            if (move.id == INVALID_VEHICLE) {
+                continue;
+            }
+            const std::uint64_t to = Pack(move.to);
+            out[PartitionOf(to, 0)].push_back(
+                Record{to, 0, move.id, static_cast<std::uint8_t>(CollisionKind::SAME_CELL), 0});
+            const std::uint64_t from = Pack(move.from);
+            if (from != to) {
+                // 互换位置的两辆车走的是同一条边的两个方向
+                const std::uint64_t low = std::min(from, to);
+                const std::uint64_t high = std::max(from, to);
+                out[PartitionOf(low, high)].push_back(Record{low, high, move.id,
+                                                             static_cast<std::uint8_t>(CollisionKind::SWAP),
+                                                             static_cast<std::uint8_t>(from == low)});
+            }
+        }
+    });
+
+    ParallelFor(PARTITIONS, threads, [this, chunks](const std::size_t partition) {
+        std::vector<Record>& records = merged[partition];
+        records.clear();
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            const std::vector<Record>& part = scattered[chunk * PARTITIONS + partition];
+            records.insert(records.end(), part.begin(), part.end());
+        }
+        found[partition].clear();
+        Group(records, tables[partition], found[partition]);
+    });
+
+    std::size_t total = 0;
+    for (const std::vector<Collision>& part : found) {
+        total += part.size();
+    }
+    collisions.reserve(total);
+    for (const std::vector<Collision>& part : found) {
+        collisions.insert(collisions.end(), part.begin(), part.end());
+    }
+    std::sort(collisions.begin(), collisions.end(), [](const Collision& lhs, const Collision& rhs) {
+        if (lhs.first != rhs.first) {
+            return lhs.first < rhs.first;
+        }
+        return lhs.second != rhs.second ? lhs.second < rhs.second : lhs.kind < rhs.kind;
+    });
+}
+
+void CollisionDetector::Group(const std::vector<Record>& records, Table& table, std::vector<Collision>& out)
+{
+    // 开放寻址表的每个桶指向一组的最后一条记录，组内用next串起来；装载率不超过1/2
+    std::size_t buckets = 16;
+    while (buckets < records.size() * 2) {
+        buckets *= 2;
+    }
+    const std::size_t mask = buckets - 1;
+    table.heads.assign(buckets, NONE);
+    table.next.resize(records.size());
+
+    for (std::uint32_t i = 0; i < records.size(); ++i) {
+        const Record& record = records[i];
+        std::size_t bucket = static_cast<std::size_t>(
+            ((record.key ^ (record.other * 0xC2B2AE3D27D4EB4Full) ^ record.kind) * 0x9E3779B97F4A7C15ull) >> 32);
+        for (bucket &= mask; table.heads[bucket] != NONE; bucket = (bucket + 1) & mask) {
+            const Record& head = records[table.heads[bucket]];
+            if (head.kind == record.kind && head.key == record.key && head.other == record.other) {
+                break;
+            }
+        }
+        // 与组内已有的每条记录各成一对
+        for (std::uint32_t j = table.heads[bucket]; j != NONE; j = table.next[j]) {
+            const Record& earlier = records[j];
+            const VehicleId first = std::min(earlier.id, record.id);
+            const VehicleId second = std::max(earlier.id, record.id);
+            if (record.kind == static_cast<std::uint8_t>(CollisionKind::SAME_CELL)) {
+                out.push_back(Collision{first, second, CollisionKind::SAME_CELL, Unpack(record.key)});
+            } else if (earlier.forward != record.forward) {
+                const Record& from = first == record.id ? record : earlier;
+                out.push_back(
+                    Collision{first, second, CollisionKind::SWAP, Unpack(from.forward != 0 ? from.other : from.key)});
+            }
+        }
+        table.next[i] = table.heads[bucket];
+        table.heads[bucket] = i;
+    }
+}
+}  // namespace adas
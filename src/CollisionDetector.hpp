@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Fleet.hpp"
+
+namespace adas
+{
+// 按tick检测碰撞：每辆车生成按格子(和换位的边)分组的记录，先由各线程按散列值分到自己的分区，
+// 再按分区并行合并、用散列表分组。缓冲区在多次调用间复用
+class CollisionDetector final
+{
+public:
+    CollisionDetector(void) noexcept = default;
+
+    CollisionDetector(const CollisionDetector&) = delete;
+    CollisionDetector& operator=(const CollisionDetector&) = delete;
+
+public:
+    // id为INVALID_VEHICLE的项跳过。结果按(first, second)排序，与线程数无关；内存不足抛出std::bad_alloc
+    void Detect(const std::vector<VehicleMove>& moves, const unsigned threads, std::vector<Collision>& collisions);
+
+private:
+    struct Record
+    {
+        std::uint64_t key;    // 所在格；换位记录为边较小的端点
+        std::uint64_t other;  // 换位记录为边较大的端点，占格记录为0
+        VehicleId id;
+        std::uint8_t kind;     // CollisionKind
+        std::uint8_t forward;  // 换位记录：是否从较小端点驶向较大端点
+    };
+
+    struct Table
+    {
+        std::vector<std::uint32_t> heads;
+        std::vector<std::uint32_t> next;
+    };
+
+    static constexpr std::uint32_t NONE = 0xFFFFFFFF;
+
+    // 找出同组的记录对
+    static void Group(const std::vector<Record>& records, Table& table, std::vector<Collision>& out);
+
+private:
+    std::vector<std::vector<Record>> scattered;  // [块][分区]
+    std::vector<std::vector<Record>> merged;     // [分区]
+    std::vector<Table> tables;                   // [分区]
+    std::vector<std::vector<Collision>> found;   // [分区]
+};
+}  // namespace adas
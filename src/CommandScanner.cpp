@@ -0,0 +1,181 @@
+#include "CommandScanner.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ADAS_SCAN_X86 1
+#endif
+
+namespace adas
+{
+namespace
+{
+// 只填move/turn/toggle/carSwitch和T、R的原始位置，TR配对由Classify统一完成
+struct RawMasks
+{
+    std::uint64_t move;
+    std::uint64_t turn;
+    std::uint64_t toggle;
+    std::uint64_t carSwitch;
+    std::uint64_t t;
+    std::uint64_t r;
+};
+
+void ClassifyScalar(const char* block, RawMasks& raw) noexcept
+{
+    raw = RawMasks{};
+    for (unsigned i = 0; i < CommandScanner::BLOCK; ++i) {
+        const std::uint64_t bit = 1ull << i;
+        switch (block[i]) {
+        case 'M':
+            raw.move |= bit;
+            break;
+        case 'L':
+            raw.turn |= bit;
+            break;
+        case 'R':
+            raw.turn |= bit;
+            raw.r |= bit;
+            break;
+        case 'F':
+        case 'B':
+            raw.toggle |= bit;
+            break;
+        case 'N':
+        case 'U':
+            raw.carSwitch |= bit;
+            break;
+        case 'T':
+            raw.t |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+#ifdef ADAS_SCAN_X86
+// 每次比较16字节，4组拼成64位
+void ClassifySse2(const char* block, RawMasks& raw) noexcept
+{
+    raw = RawMasks{};
+    for (unsigned part = 0; part < 4; ++part) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + part * 16));
+        auto match = [&bytes](const char c) {
+            return static_cast<std::uint64_t>(
+                static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)))));
+        };
+        const unsigned shift = part * 16;
+        const std::uint64_t r = match('R');
+        raw.move |= match('M') << shift;
+        raw.turn |= (match('L') | r) << shift;
+        raw.toggle |= (match('F') | match('B')) << shift;
+        raw.carSwitch |= (match('N') | match('U')) << shift;
+        raw.t |= match('T') << shift;
+        raw.r |= r << shift;
+    }
+}
+
+// 每次比较32字节，2组拼成64位
+__attribute__((target("avx2"))) void ClassifyAvx2(const char* block, RawMasks& raw) noexcept
+{
+    raw = RawMasks{};
+    for (unsigned part = 0; part < 2; ++part) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + part * 32));
+        auto match = [&bytes](const char c) __attribute__((target("avx2"))) {
+            return static_cast<std::uint64_t>(
+                static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c)))));
+        };
+        const unsigned shift = part * 32;
+        const std::uint64_t r = match('R');
+        raw.move |= match('M') << shift;
+        raw.turn |= (match('L') | r) << shift;
+        raw.toggle |= (match('F') | match('B')) << shift;
+        raw.carSwitch |= (match('N') | match('U')) << shift;
+        raw.t |= match('T') << shift;
+        raw.r |= r << shift;
+    }
+}
+#endif
+
+using RawClassify = void (*)(const char*, RawMasks&) noexcept;
+
+RawClassify RawClassifyOf(const ScanIsa isa) noexcept
+{
+#ifdef ADAS_SCAN_X86
+    switch (isa) {
+    case ScanIsa::AVX2:
+        return ClassifyAvx2;
+    case ScanIsa::SSE2:
+        return ClassifySse2;
+    default:
+        break;
+    }
+#endif
+    (void)isa;
+    return ClassifyScalar;
+}
+
+RawClassify rawClassifiers[3] = {RawClassifyOf(ScanIsa::SCALAR), RawClassifyOf(ScanIsa::SSE2),
+                                 RawClassifyOf(ScanIsa::AVX2)};
+}  // namespace
+
+ScanIsa CommandScanner::BestIsa(void) noexcept
+{
+#ifdef ADAS_SCAN_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return ScanIsa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return ScanIsa::SSE2;
+    }
+#endif
+    return ScanIsa::SCALAR;
+}
+
+CommandScanner::CommandScanner(const ScanIsa isa) noexcept : isa(isa)
+{
+    // 不支持的指令集退回标量实现
+    const ScanIsa best = BestIsa();
+    if (static_cast<unsigned>(this->isa) > static_cast<unsigned>(best)) {
+        this->isa = best;
+    }
+}
+
+ScanIsa CommandScanner::Isa(void) const noexcept
+{
+    return isa;
+}
+
+void CommandScanner::Classify(const char* block, const std::size_t length, const bool continuesTurnRound,
+                              const bool nextIsR, ClassMasks& masks) const noexcept
+{
+    RawMasks raw;
+    if (length == BLOCK) {
+        rawClassifiers[static_cast<unsigned>(isa)](block, raw);
+    } else {
+        // 不足一块时复制到补零的缓冲区，补零部分不属于任何指令，最后再截掉
+        char padded[BLOCK] = {};
+        std::memcpy(padded, block, length);
+        rawClassifiers[static_cast<unsigned>(isa)](padded, raw);
+    }
+
+    const std::uint64_t valid = length >= BLOCK ? ~0ull : (1ull << length) - 1;
+    const std::uint64_t nextR = (raw.r >> 1) | (nextIsR ? 1ull << 63 : 0);
+    masks.move = raw.move;
+    masks.toggle = raw.toggle;
+    masks.carSwitch = raw.carSwitch;
+    masks.turnRound = raw.t & nextR & valid;
+    // TR中的R不算转向
+    masks.turn = raw.turn & ~(masks.turnRound << 1) & ~(continuesTurnRound ? 1ull : 0ull);
+    const std::uint64_t known = raw.move | raw.turn | raw.toggle | raw.carSwitch | masks.turnRound;
+    masks.junk = ~(known | (masks.turnRound << 1)) & valid;
+}
+
+std::vector<CommandSegment> CommandScanner::Segments(const char* data, const std::size_t size) const
+{
+    std::vector<CommandSegment> segments;
+    ForEachSegment(data, size, [&segments](const CommandSegment& segment) { segments.push_back(segment); });
+    return segments;
+}
+}  // namespace adas
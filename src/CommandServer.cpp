@@ -0,0 +1,369 @@
+#include "CommandServer.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <new>
+#include "FrameHandler.hpp"
+
+namespace adas
+{
+namespace
+{
+constexpr std::size_t READ_CHUNK = 64 * 1024;
+// 发送缓冲积压超过该值时暂停处理该连接的请求
+constexpr std::size_t HIGH_WATER = 1 << 20;
+constexpr int MAX_EVENTS = 256;
+}  // namespace
+
+struct CommandServer::Connection
+{
+    int fd;
+    std::vector<char> in;
+    std::size_t inBegin{0};  // [inBegin, inEnd)为已收到、未处理的字节
+    std::size_t inEnd{0};
+    std::string out;
+    std::size_t outBegin{0};  // 之前的应答已发出
+    std::uint32_t events{EPOLLIN};
+};
+
+CommandServer::CommandServer(const CommandServerOptions& options) noexcept : options(options)
+{
+}
+
+CommandServer::~CommandServer() noexcept
+{
+    for (std::unique_ptr<Connection>& connection : connections) {
+        if (connection != nullptr) {
+            ::close(connection->fd);
+        }
+    }
+    for (const int fd : {listenFd, epollFd, wakeFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (listenFd >= 0 && !options.unixPath.empty()) {
+        ::unlink(options.unixPath.c_str());
+    }
+}
+
+bool CommandServer::Listen(void) noexcept
+{
+    try {
+        buffer.resize(READ_CHUNK);
+        handler.reset(new FrameHandler());
+    } catch (const std::bad_alloc&) {
+        errno = ENOMEM;
+        return false;
+    }
+    if (options.unixPath.empty()) {
+        listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            return false;
+        }
+        const int one = 1;
+        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return false;
+        }
+        port = ntohs(address.sin_port);
+    } else {
+        sockaddr_un address{};
+        if (options.unixPath.size() >= sizeof(address.sun_path)) {
+            errno = ENAMETOOLONG;
+            return false;
+        }
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        options.unixPath.copy(address.sun_path, options.unixPath.size());
+        ::unlink(options.unixPath.c_str());
+        if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            return false;
+        }
+    }
+    if (::listen(listenFd, SOMAXCONN) != 0) {
+        return false;
+    }
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        return false;
+    }
+    for (const int fd : {listenFd, wakeFd}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t CommandServer::Vehicles(void) const noexcept
+{
+    return handler == nullptr ? 0 : handler->Vehicles();
+}
+
+void CommandServer::Stop(void) noexcept
+{
+    if (wakeFd >= 0) {
+        const std::uint64_t one = 1;
+        const ssize_t written = ::write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+bool CommandServer::Run(void) noexcept
+{
+    epoll_event events[MAX_EVENTS];
+    for (;;) {
+        const int ready = ::epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        for (int i = 0; i < ready; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+                std::uint64_t count = 0;
+                const ssize_t consumed = ::read(wakeFd, &count, sizeof(count));
+                (void)consumed;
+                return true;
+            }
+            if (fd == listenFd) {
+                Accept();
+                continue;
+            }
+            // 同一批事件中前面关闭的描述符可能已被新连接复用，多余的读写只会得到EAGAIN
+            if (static_cast<std::size_t>(fd) >= connections.size() || connections[fd] == nullptr) {
+                continue;
+            }
+            Connection& connection = *connections[fd];
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0 && !OnReadable(connection)) {
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) != 0) {
+                Flush(connection);
+            }
+        }
+    }
+}
+
+void CommandServer::Accept(void) noexcept
+{
+    for (;;) {
+        const int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN表示已取完；描述符耗尽等错误留到下次可读时再试
+            return;
+        }
+        if (open >= options.maxConnections) {
+            ::close(fd);
+            ++stats.rejected;
+            continue;
+        }
+        if (options.unixPath.empty()) {
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        Connection* connection = nullptr;
+        try {
+            if (static_cast<std::size_t>(fd) >= connections.size()) {
+                connections.resize(static_cast<std::size_t>(fd) + 1);
+            }
+            connections[fd].reset(new Connection{fd});
+            connection = connections[fd].get();
+        } catch (const std::bad_alloc&) {
+            ::close(fd);
+            ++stats.rejected;
+            continue;
+        }
+        epoll_event event{};
+        event.events = connection->events;
+        event.data.fd = fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            connections[fd].reset();
+            ++stats.rejected;
+            continue;
+        }
+        ++open;
+        ++stats.accepted;
+    }
+}
+
+void CommandServer::Close(Connection& connection) noexcept
+{
+    const int fd = connection.fd;
+    ::close(fd);
+    connections[fd].reset();
+    --open;
+    ++stats.closed;
+}
+
+bool CommandServer::OnReadable(Connection& connection) noexcept
+{
+    // 没有残留字节时直接读进共享缓冲，处理后只把剩下的不完整帧拷进连接自己的缓冲
+    const bool direct = connection.inEnd == 0;
+    char* target = buffer.data();
+    std::size_t room = buffer.size();
+    if (!direct) {
+        std::copy(connection.in.begin() + connection.inBegin, connection.in.begin() + connection.inEnd,
+                  connection.in.begin());
+        connection.inEnd -= connection.inBegin;
+        connection.inBegin = 0;
+        try {
+            connection.in.resize(std::max(connection.in.size(), connection.inEnd + READ_CHUNK));
+        } catch (const std::bad_alloc&) {
+            Close(connection);
+            return false;
+        }
+        target = connection.in.data() + connection.inEnd;
+        room = connection.in.size() - connection.inEnd;
+    }
+    const ssize_t received = ::recv(connection.fd, target, room, 0);
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        Close(connection);
+        return false;
+    }
+    if (received < 0) {
+        return true;
+    }
+    if (!direct) {
+        connection.inEnd += static_cast<std::size_t>(received);
+        return Flush(connection);
+    }
+    std::size_t consumed = 0;
+    if (!ProcessFrames(connection, target, static_cast<std::size_t>(received), consumed)) {
+        return false;
+    }
+    if (consumed < static_cast<std::size_t>(received)) {
+        try {
+            connection.in.assign(target + consumed, target + received);
+        } catch (const std::bad_alloc&) {
+            Close(connection);
+            return false;
+        }
+        connection.inEnd = connection.in.size();
+    }
+    return Flush(connection);
+}
+
+bool CommandServer::ProcessFrames(Connection& connection, const char* data, const std::size_t size,
+                                  std::size_t& consumed) noexcept
+{
+    consumed = 0;
+    while (connection.out.size() - connection.outBegin < HIGH_WATER && size - consumed >= sizeof(RequestHeader)) {
+        RequestHeader header;
+        std::memcpy(&header, data + consumed, sizeof(header));
+        if (header.length > MAX_FRAME_PAYLOAD) {
+            Close(connection);
+            return false;
+        }
+        if (size - consumed < sizeof(header) + header.length) {
+            break;
+        }
+        Response response{};
+        handler->Handle(header, data + consumed + sizeof(header), response, stats);
+        try {
+            connection.out.append(reinterpret_cast<const char*>(&response), sizeof(response));
+        } catch (const std::bad_alloc&) {
+            Close(connection);
+            return false;
+        }
+        consumed += sizeof(header) + header.length;
+    }
+    return true;
+}
+
+bool CommandServer::ProcessPending(Connection& connection) noexcept
+{
+    if (connection.inEnd == 0) {
+        return true;
+    }
+    std::size_t consumed = 0;
+    if (!ProcessFrames(connection, connection.in.data() + connection.inBegin, connection.inEnd - connection.inBegin,
+                       consumed)) {
+        return false;
+    }
+    connection.inBegin += consumed;
+    if (connection.inBegin == connection.inEnd) {
+        // 残留处理完后释放，空闲连接不占读缓冲
+        std::vector<char>().swap(connection.in);
+        connection.inBegin = 0;
+        connection.inEnd = 0;
+    }
+    return true;
+}
+
+bool CommandServer::Flush(Connection& connection) noexcept
+{
+    for (;;) {
+        while (connection.outBegin < connection.out.size()) {
+            const ssize_t sent = ::send(connection.fd, connection.out.data() + connection.outBegin,
+                                        connection.out.size() - connection.outBegin, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                Close(connection);
+                return false;
+            }
+            connection.outBegin += static_cast<std::size_t>(sent);
+        }
+        if (connection.outBegin == connection.out.size()) {
+            connection.out.clear();
+            connection.outBegin = 0;
+        }
+        // 积压回落后继续处理因积压留在输入缓冲中的请求，直到没有新的应答
+        const std::size_t backlog = connection.out.size();
+        if (backlog - connection.outBegin >= HIGH_WATER) {
+            break;
+        }
+        if (!ProcessPending(connection)) {
+            return false;
+        }
+        if (connection.out.size() == backlog) {
+            break;
+        }
+    }
+
+    const std::size_t backlog = connection.out.size() - connection.outBegin;
+    const std::uint32_t wanted = (backlog != 0 ? static_cast<std::uint32_t>(EPOLLOUT) : 0u) |
+                                 (backlog < HIGH_WATER ? static_cast<std::uint32_t>(EPOLLIN) : 0u);
+    if (wanted != connection.events) {
+        epoll_event event{};
+        event.events = wanted;
+        event.data.fd = connection.fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event) != 0) {
+            Close(connection);
+            return false;
+        }
+        connection.events = wanted;
+    }
+    return true;
+}
+}  // namespace adas
@@ -0,0 +1,173 @@
+#include "ConcurrentExecutor.hpp"
+#include <chrono>
+#include <new>
+#include <system_error>
+
+namespace adas
+{
+namespace
+{
+// 后台线程睡眠前再尝试取几轮，短暂的空闲不进入条件变量
+constexpr unsigned SPIN_ROUNDS = 64;
+
+std::uint64_t NowNs(void) noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+}  // namespace
+
+ConcurrentExecutor::ConcurrentExecutor(const Pose& pose, const CarMode& mode)
+    : executor(Executor::NewExecutor(pose, mode)), head(&stub), tail(&stub)
+{
+    if (executor == nullptr) {
+        throw std::bad_alloc();
+    }
+}
+
+ConcurrentExecutor::~ConcurrentExecutor() noexcept
+{
+    Stop();
+    for (Node* node = Pop(); node != nullptr; node = Pop()) {
+        delete node;
+    }
+}
+
+bool ConcurrentExecutor::Submit(const std::string& commands) noexcept
+{
+    Node* node = new (std::nothrow) Node();
+    if (node == nullptr) {
+        return false;
+    }
+    try {
+        node->commands = commands;
+    } catch (const std::bad_alloc&) {
+        delete node;
+        return false;
+    }
+    node->enqueuedNs = NowNs();
+    Push(node);
+    // 与Consume中先置sleeping再检查队列配对：两边都用顺序一致的内存序，至少一方能看到另一方
+    if (sleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sleeping.store(false, std::memory_order_relaxed);
+        wakeup.notify_one();
+    }
+    return true;
+}
+
+void ConcurrentExecutor::Push(Node* node) noexcept
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head.exchange(node, std::memory_order_seq_cst);
+    prev->next.store(node, std::memory_order_release);
+}
+
+ConcurrentExecutor::Node* ConcurrentExecutor::Pop(void) noexcept
+{
+    Node* first = tail;
+    Node* next = first->next.load(std::memory_order_acquire);
+    if (first == &stub) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+        tail = next;
+        return first;
+    }
+    if (first != head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    // first是最后一个节点：把stub接到它后面，才能把它取走
+    Push(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
+
+bool ConcurrentExecutor::Empty(void) const noexcept
+{
+    return tail == &stub && head.load(std::memory_order_seq_cst) == &stub;
+}
+
+std::size_t ConcurrentExecutor::Drain(void) noexcept
+{
+    std::size_t count = 0;
+    for (Node* node = Pop(); node != nullptr; node = Pop()) {
+        queueLatency.Record(NowNs() - node->enqueuedNs);
+        executor->Execute(node->commands);
+        delete node;
+        executed.fetch_add(1, std::memory_order_release);
+        ++count;
+    }
+    return count;
+}
+
+bool ConcurrentExecutor::Start(void) noexcept
+{
+    if (consumer.joinable()) {
+        return false;
+    }
+    stopping.store(false, std::memory_order_relaxed);
+    try {
+        consumer = std::thread([this] { Consume(); });
+    } catch (const std::system_error&) {
+        return false;
+    }
+    return true;
+}
+
+void ConcurrentExecutor::Stop(void) noexcept
+{
+    if (!consumer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping.store(true, std::memory_order_relaxed);
+        sleeping.store(false, std::memory_order_relaxed);
+        wakeup.notify_one();
+    }
+    consumer.join();
+}
+
+void ConcurrentExecutor::Consume(void) noexcept
+{
+    unsigned idle = 0;
+    for (;;) {
+        if (Drain() != 0) {
+            idle = 0;
+            continue;
+        }
+        if (stopping.load(std::memory_order_relaxed)) {
+            // 生产者可能刚交换了head还没链上next，等它完成
+            while (!Empty()) {
+                Drain();
+                std::this_thread::yield();
+            }
+            return;
+        }
+        if (++idle < SPIN_ROUNDS) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.store(true, std::memory_order_seq_cst);
+        if (!Empty() || stopping.load(std::memory_order_relaxed)) {
+            sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        wakeup.wait(lock, [this] { return !sleeping.load(std::memory_order_relaxed); });
+        idle = 0;
+    }
+}
+}  // namespace adas
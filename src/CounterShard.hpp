@@ -0,0 +1,9 @@
+#pragma once
+#include "ExecutorMetrics.hpp"
+
+namespace adas
+{
+// 把执行器计数的增量(after - before)累加到当前线程的分片。
+// 分片只有所属线程写入，用relaxed原子读写代替RMW指令
+void AddToThreadShard(const ExecutorCounters& before, const ExecutorCounters& after) noexcept;
+}  // namespace adas
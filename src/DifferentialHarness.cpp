@@ -0,0 +1,432 @@
+#include "DifferentialHarness.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include "ExecutorListener.hpp"
+#include "ExecutorPool.hpp"
+#include "Geofence.hpp"
+#include "LazyExecutor.hpp"
+#include "ObstacleMap.hpp"
+#include "ParallelFor.hpp"
+#include "ReferenceExecutor.hpp"
+#include "StateMachine.hpp"
+#include "VehicleTypes.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+// 均匀随机指令串的字符表，T与R单独出现以覆盖不完整的TR
+constexpr char RANDOM_ALPHABET[] = "MMMLRFBNUTRTRTX";
+constexpr std::size_t CORPUS_SIZE = 1 << 20;
+// 单次最小化最多调用引擎的次数，避免病态输入耗时过长
+constexpr std::size_t MAX_MINIMIZE_TESTS = 20000;
+
+std::uint64_t SplitMix(std::uint64_t& state) noexcept
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+std::string Join(const std::vector<std::string>& tokens)
+{
+    std::string result;
+    for (const std::string& token : tokens) {
+        result += token;
+    }
+    return result;
+}
+
+// 经典ddmin：反复尝试只保留某一块或去掉某一块，粒度逐步细化到单个单位
+template <typename Test>
+std::vector<std::string> Minimize(std::vector<std::string> tokens, Test test)
+{
+    std::size_t budget = MAX_MINIMIZE_TESTS;
+    std::size_t parts = 2;
+    while (tokens.size() >= 2 && budget > 0) {
+        const std::size_t chunk = (tokens.size() + parts - 1) / parts;
+        bool reduced = false;
+        for (std::size_t begin = 0; begin < tokens.size() && budget > 0; begin += chunk) {
+            const std::size_t end = std::min(begin + chunk, tokens.size());
+            std::vector<std::string> subset(tokens.begin() + begin, tokens.begin() + end);
+            --budget;
+            if (test(subset)) {
+                tokens.swap(subset);
+                parts = 2;
+                reduced = true;
+                break;
+            }
+            std::vector<std::string> complement(tokens.begin(), tokens.begin() + begin);
+            complement.insert(complement.end(), tokens.begin() + end, tokens.end());
+            --budget;
+            if (test(complement)) {
+                tokens.swap(complement);
+                parts = std::max<std::size_t>(parts - 1, 2);
+                reduced = true;
+                break;
+            }
+        }
+        if (!reduced) {
+            if (parts >= tokens.size()) {
+                break;
+            }
+            parts = std::min(parts * 2, tokens.size());
+        }
+    }
+    return tokens;
+}
+
+EngineState RunExecutor(const EngineState& initial, const std::string& commands)
+{
+    std::unique_ptr<Executor> executor(Executor::NewExecutor(initial.pose, initial.mode));
+    executor->Execute(commands);
+    return EngineState{executor->Query(), executor->QueryMode()};
+}
+
+EngineState RunPooledExecutor(const EngineState& initial, const std::string& commands)
+{
+    // 池不是线程安全的，每个线程一个；复用的执行器经过Reset，能覆盖状态残留问题
+    static thread_local ExecutorPool pool(64);
+    ExecutorPool::Handle executor = pool.Acquire(initial.pose, initial.mode);
+    executor->Execute(commands);
+    return EngineState{executor->Query(), executor->QueryMode()};
+}
+
+// 引擎内部的随机调用方式由输入决定：同一输入总是同样调用，分歧可以复现和最小化
+std::uint64_t InputSeed(const EngineState& initial, const std::string& commands) noexcept
+{
+    std::uint64_t state = std::hash<std::string>()(commands);
+    state ^= static_cast<std::uint64_t>(static_cast<std::uint32_t>(initial.pose.x)) << 32;
+    state ^= static_cast<std::uint32_t>(initial.pose.y);
+    return SplitMix(state);
+}
+
+// 把指令串在执行单位边界上随机切成若干次Execute，其间随机插入Query、Flush，
+// 日志上限也随机取小值，日志写满时的自动执行同样被覆盖
+EngineState RunLazyExecutor(const EngineState& initial, const std::string& commands)
+{
+    std::uint64_t state = InputSeed(initial, commands);
+    LazyOptions options;
+    options.maxPendingBytes = 1 + static_cast<std::size_t>(SplitMix(state) % 128);
+    std::unique_ptr<LazyExecutor> executor(LazyExecutor::NewLazyExecutor(initial.pose, initial.mode, options));
+    const std::vector<std::string> tokens = Tokenize(commands);
+    for (std::size_t begin = 0; begin < tokens.size();) {
+        const std::size_t end = std::min(tokens.size(), begin + 1 + static_cast<std::size_t>(SplitMix(state) % 32));
+        executor->Execute(Join(std::vector<std::string>(tokens.begin() + begin, tokens.begin() + end)));
+        const std::uint64_t draw = SplitMix(state) % 4;
+        if (draw == 0) {
+            executor->Query();
+        } else if (draw == 1) {
+            executor->Flush();
+        }
+        begin = end;
+    }
+    return EngineState{executor->Query(), executor->QueryMode()};
+}
+
+// 用随机的预算分多次ExecuteSome执行完，预算常常落在T和R之间，覆盖TR不被截断的处理
+EngineState RunExecuteSome(const EngineState& initial, const std::string& commands)
+{
+    std::uint64_t state = InputSeed(initial, commands);
+    std::unique_ptr<Executor> executor(Executor::NewExecutor(initial.pose, initial.mode));
+    ExecuteCursor cursor(commands);
+    while (!cursor.Done()) {
+        executor->ExecuteSome(cursor, 1 + static_cast<std::size_t>(SplitMix(state) % 16));
+    }
+    return EngineState{executor->Query(), executor->QueryMode()};
+}
+
+// 围栏覆盖整个网格，从不拦截；走的是ExecuteWithin自己的逐条检查循环
+EngineState RunExecuteWithin(const EngineState& initial, const std::string& commands)
+{
+    static const Geofence wholeGrid = Geofence::Rectangle({INT_MIN, INT_MIN}, {INT_MAX, INT_MAX});
+    std::unique_ptr<Executor> executor(Executor::NewExecutor(initial.pose, initial.mode));
+    executor->ExecuteWithin(commands, wholeGrid);
+    return EngineState{executor->Query(), executor->QueryMode()};
+}
+
+// 空地图从不阻挡；装了地图的Execute改走逐条检查的执行循环
+EngineState RunWithObstacleMap(const EngineState& initial, const std::string& commands)
+{
+    static const ObstacleMap empty;
+    std::unique_ptr<Executor> executor(Executor::NewExecutor(initial.pose, initial.mode));
+    executor->SetObstacleMap(&empty);
+    executor->Execute(commands);
+    return EngineState{executor->Query(), executor->QueryMode()};
+}
+
+class IgnoringListener final : public ExecutorListener
+{
+public:
+    void OnEvents(const ExecutorEvent*, const std::size_t) noexcept override
+    {
+    }
+};
+
+// 装了监听者的执行器要逐条产生事件，不走向量化求值
+EngineState RunWithListener(const EngineState& initial, const std::string& commands)
+{
+    IgnoringListener listener;
+    std::unique_ptr<Executor> executor(Executor::NewExecutor(initial.pose, initial.mode));
+    executor->SetListener(&listener);
+    executor->Execute(commands);
+    return EngineState{executor->Query(), executor->QueryMode()};
+}
+
+const char* IsaName(const EvaluatorIsa isa) noexcept
+{
+    switch (isa) {
+    case EvaluatorIsa::SSSE3:
+        return "SSSE3";
+    case EvaluatorIsa::AVX2:
+        return "AVX2";
+    default:
+        return "SCALAR";
+    }
+}
+
+// 指定向量化求值的实现，只影响调用线程，多个线程可以同时校验不同的实现
+EngineRunner RunExecutorWithIsa(const EvaluatorIsa isa)
+{
+    return [isa](const EngineState& initial, const std::string& commands) {
+        ThreadEvaluatorIsa scoped(isa);
+        return RunExecutor(initial, commands);
+    };
+}
+
+EngineState RandomInitial(std::uint64_t& state) noexcept
+{
+    static const char headings[] = "ESWNESWNESWNESWX";
+    const std::uint64_t draw = SplitMix(state);
+    EngineState initial{};
+    initial.pose.x = static_cast<int>(draw % 2001) - 1000;
+    initial.pose.y = static_cast<int>((draw >> 16) % 2001) - 1000;
+    initial.pose.heading = headings[(draw >> 32) & 15];
+    initial.mode.carType = static_cast<CarType>((draw >> 36) % 3);
+    initial.mode.fast = ((draw >> 40) & 1) != 0;
+    initial.mode.reverse = ((draw >> 41) & 1) != 0;
+    return initial;
+}
+
+std::vector<std::string> BuildCorpora(const std::uint64_t seed, const unsigned threads)
+{
+    // 几组倾向不同的生成配置：长游程、高频切换、密集TR、夹杂未知字符
+    std::vector<WorkloadConfig> configs(4);
+    configs[0].meanRunLength = 8.0;
+    configs[1].carTypeSwitchRate = 0.05;
+    configs[2].turnRoundRate = 0.1;
+    configs[2].mix = OpcodeMix{0.3, 0.2, 0.2, 0.15, 0.15};
+    configs[3].junkRate = 0.05;
+    configs[3].carTypeSwitchRate = 0.02;
+    std::vector<std::string> corpora;
+    std::uint64_t state = seed;
+    for (WorkloadConfig& config : configs) {
+        config.seed = SplitMix(state);
+        corpora.push_back(WorkloadGenerator(config).Generate(CORPUS_SIZE, threads));
+    }
+    return corpora;
+}
+}  // namespace
+
+bool SameState(const EngineState& lhs, const EngineState& rhs) noexcept
+{
+    return lhs.pose.x == rhs.pose.x && lhs.pose.y == rhs.pose.y && lhs.pose.heading == rhs.pose.heading &&
+           lhs.mode.carType == rhs.mode.carType && lhs.mode.fast == rhs.mode.fast &&
+           lhs.mode.reverse == rhs.mode.reverse;
+}
+
+std::string FormatState(const EngineState& state)
+{
+    char text[96];
+    std::snprintf(text, sizeof(text), "(%d, %d, %c) %s%s%s", state.pose.x, state.pose.y, state.pose.heading,
+                  CarTypeName(state.mode.carType), state.mode.fast ? " fast" : "",
+                  state.mode.reverse ? " reverse" : "");
+    return text;
+}
+
+EngineState RunReference(const EngineState& initial, const std::string& commands)
+{
+    ReferenceExecutor executor(initial.pose, initial.mode);
+    executor.Execute(commands);
+    return EngineState{executor.Query(), executor.QueryMode()};
+}
+
+std::vector<std::string> Tokenize(const std::string& commands)
+{
+    std::vector<std::string> tokens;
+    tokens.reserve(commands.size());
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const bool turnRound = commands[i] == 'T' && i + 1 < commands.size() && commands[i + 1] == 'R';
+        tokens.push_back(commands.substr(i, turnRound ? 2 : 1));
+        i += turnRound ? 1 : 0;
+    }
+    return tokens;
+}
+
+std::string FormatDivergence(const Divergence& divergence)
+{
+    std::string text = divergence.engine + " diverged from reference on case " +
+                       std::to_string(divergence.caseIndex) + "\n";
+    text += "  initial:    " + FormatState(divergence.initial) + "\n";
+    text += "  step:       " + std::to_string(divergence.step) + " token \"" + divergence.token + "\" at offset " +
+            std::to_string(divergence.offset) + " of " + std::to_string(divergence.commands.size()) + "\n";
+    text += "  expected:   " + FormatState(divergence.expected) + "\n";
+    text += "  actual:     " + FormatState(divergence.actual) + "\n";
+    text += "  reproducer: \"" + divergence.reproducer + "\"\n";
+    return text;
+}
+
+DifferentialHarness DifferentialHarness::WithBuiltinEngines(void)
+{
+    DifferentialHarness harness;
+    harness.AddEngine("Executor", RunExecutor);
+    harness.AddEngine("ExecutorPool", RunPooledExecutor);
+    harness.AddEngine("LazyExecutor", RunLazyExecutor);
+    harness.AddEngine("ExecuteSome", RunExecuteSome);
+    harness.AddEngine("ExecuteWithin", RunExecuteWithin);
+    harness.AddEngine("Executor/ObstacleMap", RunWithObstacleMap);
+    harness.AddEngine("Executor/Listener", RunWithListener);
+    for (unsigned isa = 0; isa <= static_cast<unsigned>(BestEvaluatorIsa()); ++isa) {
+        const EvaluatorIsa evaluator = static_cast<EvaluatorIsa>(isa);
+        harness.AddEngine(std::string("Executor/") + IsaName(evaluator), RunExecutorWithIsa(evaluator));
+    }
+    return harness;
+}
+
+void DifferentialHarness::AddEngine(const std::string& name, EngineRunner runner)
+{
+    engines.push_back(Engine{name, std::move(runner)});
+}
+
+std::vector<std::string> DifferentialHarness::EngineNames(void) const
+{
+    std::vector<std::string> names;
+    for (const Engine& engine : engines) {
+        names.push_back(engine.name);
+    }
+    return names;
+}
+
+bool DifferentialHarness::Diverges(const Engine& engine, const EngineState& initial, const std::string& commands)
+{
+    return !SameState(RunReference(initial, commands), engine.runner(initial, commands));
+}
+
+Divergence DifferentialHarness::Explain(const Engine& engine, const EngineState& initial, const std::string& commands)
+{
+    const std::vector<std::string> tokens = Tokenize(commands);
+    std::vector<std::size_t> ends(1, 0);
+    for (const std::string& token : tokens) {
+        ends.push_back(ends.back() + token.size());
+    }
+
+    // 二分前缀长度：保持lo个单位一致、hi个单位不一致
+    std::size_t lo = 0;
+    std::size_t hi = tokens.size();
+    if (Diverges(engine, initial, std::string())) {
+        hi = 0;
+    }
+    while (hi > lo + 1) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (Diverges(engine, initial, commands.substr(0, ends[mid]))) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+
+    Divergence divergence;
+    divergence.engine = engine.name;
+    divergence.initial = initial;
+    divergence.commands = commands;
+    divergence.step = hi == 0 ? 0 : hi - 1;
+    divergence.offset = ends[divergence.step];
+    divergence.token = hi == 0 ? std::string() : tokens[hi - 1];
+    const std::string prefix = commands.substr(0, ends[hi]);
+    divergence.expected = RunReference(initial, prefix);
+    divergence.actual = engine.runner(initial, prefix);
+
+    const std::vector<std::string> minimal = Minimize(
+        std::vector<std::string>(tokens.begin(), tokens.begin() + hi),
+        [&engine, &initial](const std::vector<std::string>& candidate) {
+            return Diverges(engine, initial, Join(candidate));
+        });
+    divergence.reproducer = Join(minimal);
+    return divergence;
+}
+
+std::vector<Divergence> DifferentialHarness::Check(const EngineState& initial, const std::string& commands) const
+{
+    std::vector<Divergence> divergences;
+    for (const Engine& engine : engines) {
+        if (Diverges(engine, initial, commands)) {
+            divergences.push_back(Explain(engine, initial, commands));
+        }
+    }
+    return divergences;
+}
+
+DifferentialReport DifferentialHarness::Run(const DifferentialOptions& options) const
+{
+    const std::vector<std::string> corpora = BuildCorpora(options.seed, options.threads);
+    const std::size_t maxLength = std::min(options.maxLength, CORPUS_SIZE);
+    const std::uint64_t generatedThreshold =
+        options.generatedShare >= 1.0 ? ~0ull : static_cast<std::uint64_t>(options.generatedShare * 0x1.0p64);
+
+    // 引擎出现分歧后不再校验，只保留第一条记录
+    std::unique_ptr<std::atomic<bool>[]> diverged(new std::atomic<bool>[engines.size()]);
+    for (std::size_t i = 0; i < engines.size(); ++i) {
+        diverged[i].store(false, std::memory_order_relaxed);
+    }
+    std::vector<Divergence> found(engines.size());
+    std::mutex foundMutex;
+    std::atomic<std::uint64_t> checked{0};
+
+    ParallelFor(options.cases, options.threads, [&](const std::size_t caseIndex) {
+        std::uint64_t state = options.seed ^ (caseIndex * 0xD1B54A32D192ED03ull);
+        const EngineState initial = RandomInitial(state);
+        const std::size_t length = static_cast<std::size_t>(SplitMix(state) % (maxLength + 1));
+        std::string commands;
+        if (SplitMix(state) < generatedThreshold) {
+            const std::string& corpus = corpora[SplitMix(state) % corpora.size()];
+            commands = corpus.substr(SplitMix(state) % (corpus.size() - length + 1), length);
+        } else {
+            commands.resize(length);
+            for (char& c : commands) {
+                c = RANDOM_ALPHABET[SplitMix(state) % (sizeof(RANDOM_ALPHABET) - 1)];
+            }
+        }
+
+        const EngineState expected = RunReference(initial, commands);
+        for (std::size_t i = 0; i < engines.size(); ++i) {
+            if (diverged[i].load(std::memory_order_relaxed)) {
+                continue;
+            }
+            checked.fetch_add(commands.size(), std::memory_order_relaxed);
+            if (SameState(expected, engines[i].runner(initial, commands)) || diverged[i].exchange(true)) {
+                continue;
+            }
+            Divergence divergence = Explain(engines[i], initial, commands);
+            divergence.caseIndex = caseIndex;
+            std::lock_guard<std::mutex> lock(foundMutex);
+            found[i] = std::move(divergence);
+        }
+    });
+
+    DifferentialReport report;
+    report.cases = options.cases;
+    report.commands = checked.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < engines.size(); ++i) {
+        if (diverged[i].load(std::memory_order_relaxed)) {
+            report.divergences.push_back(std::move(found[i]));
+        }
+    }
+    return report;
+}
+}  // namespace adas
@@ -40,9 +40,4 @@ const Direction& Direction::RightOne() const noexcept
 {
     return directions[(index + 1) % 4];
 }
-
-const char Direction::GetHeading(void) const noexcept
-{
-    return heading;
-}
 } // namespace adas
\ No newline at end of file
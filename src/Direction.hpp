@@ -16,7 +16,10 @@ public:
     const Direction& LeftOne(void) const noexcept;
     const Direction& RightOne(void) const noexcept;
 
-    const char GetHeading(void) const noexcept;
+    char GetHeading(void) const noexcept
+    {
+        return heading;
+    }
 
 private:
     unsigned index;
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "ThreadShards.hpp"
+
+namespace adas
+{
+// 每个线程一条纪元记录，读临界区期间记下进入时的全局纪元
+struct EpochRecord
+{
+    std::atomic<std::uint64_t> epoch{0};  // 0表示不在读临界区
+    unsigned depth{0};                    // 嵌套深度，只有所属线程访问
+
+    void MergeFrom(EpochRecord&) noexcept
+    {
+    }
+};
+
+// 基于纪元的内存回收：进程内所有注册表共用一个全局纪元。
+// 在纪元e摘除的对象，等全局纪元推进到e + 2时，摘除前进入读临界区的读者都已离开，可以释放
+class EpochDomain final
+{
+public:
+    static EpochRecord& Enter(void) noexcept
+    {
+        EpochRecord& record = ThreadShards<EpochRecord>::Local();
+        if (record.depth++ == 0) {
+            record.epoch.store(Global().load(std::memory_order_relaxed), std::memory_order_seq_cst);
+            // 与TryAdvance中的栅栏配对：推进方要么看到本线程已进入，要么本线程读到推进后的数据
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        return record;
+    }
+
+    static void Leave(EpochRecord& record) noexcept
+    {
+        if (--record.depth == 0) {
+            record.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    static std::uint64_t Current(void) noexcept
+    {
+        return Global().load(std::memory_order_acquire);
+    }
+
+    // 所有在读临界区内的线程都已看到当前纪元时推进一次，返回推进后的全局纪元
+    static std::uint64_t TryAdvance(void) noexcept
+    {
+        const std::uint64_t current = Global().load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool lagging = false;
+        ThreadShards<EpochRecord>::Instance().ForEach([current, &lagging](const EpochRecord& record) {
+            // acquire：读到0或更新的纪元时，该线程之前读临界区内的访问都已完成
+            const std::uint64_t epoch = record.epoch.load(std::memory_order_acquire);
+            lagging = lagging || (epoch != 0 && epoch != current);
+        });
+        if (lagging) {
+            return current;
+        }
+        std::uint64_t expected = current;
+        Global().compare_exchange_strong(expected, current + 1, std::memory_order_acq_rel);
+        return Global().load(std::memory_order_acquire);
+    }
+
+private:
+    static std::atomic<std::uint64_t>& Global(void) noexcept
+    {
+        // 常量初始化，没有首次调用检查
+        static std::atomic<std::uint64_t> global{1};
+        return global;
+    }
+};
+}  // namespace adas
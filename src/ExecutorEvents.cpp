@@ -0,0 +1,69 @@
+#include "ExecutorEvents.hpp"
+
+namespace adas
+{
+namespace
+{
+ExecutorEventType TypeOf(const char command) noexcept
+{
+    switch (command) {
+    case 'M':
+        return ExecutorEventType::MOVE;
+    case 'F':
+    case 'B':
+        return ExecutorEventType::MODE_TOGGLE;
+    case 'N':
+    case 'U':
+        return ExecutorEventType::CAR_TYPE_SWITCH;
+    default:
+        return ExecutorEventType::TURN;
+    }
+}
+
+bool SameMode(const CarMode& lhs, const CarMode& rhs) noexcept
+{
+    return lhs.carType == rhs.carType && lhs.fast == rhs.fast && lhs.reverse == rhs.reverse;
+}
+
+bool SamePose(const Pose& lhs, const Pose& rhs) noexcept
+{
+    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.heading == rhs.heading;
+}
+}  // namespace
+
+BatchedEvents::BatchedEvents(ExecutorListener& listener) noexcept : listener(listener)
+{
+}
+
+BatchedEvents::~BatchedEvents() noexcept
+{
+    Flush();
+}
+
+void BatchedEvents::Emit(const char command, const Pose& from, const Pose& to, const CarMode& mode) noexcept
+{
+    const ExecutorEventType type = TypeOf(command);
+    if (size > 0) {
+        ExecutorEvent& last = buffer[size - 1];
+        // 同一状态下的连续移动首尾相接，合并为一次移动
+        if (type == ExecutorEventType::MOVE && last.type == ExecutorEventType::MOVE && SamePose(last.to, from) &&
+            SameMode(last.mode, mode)) {
+            last.to = to;
+            ++last.repeat;
+            return;
+        }
+    }
+    if (size == CAPACITY) {
+        Flush();
+    }
+    buffer[size++] = ExecutorEvent{type, command, 1, from, to, mode};
+}
+
+void BatchedEvents::Flush(void) noexcept
+{
+    if (size > 0) {
+        listener.OnEvents(buffer, size);
+        size = 0;
+    }
+}
+}  // namespace adas
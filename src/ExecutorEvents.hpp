@@ -0,0 +1,42 @@
+#pragma once
+#include "ExecutorListener.hpp"
+
+namespace adas
+{
+// 事件策略：ExecutorImpl::Run按策略在编译期决定是否生成事件
+
+// 未安装监听器时使用，事件相关代码全部被编译掉
+class NoEvents final
+{
+public:
+    static constexpr bool ENABLED = false;
+
+    void Emit(const char, const Pose&, const Pose&, const CarMode&) noexcept
+    {
+    }
+};
+
+// 缓冲事件并按批投递给监听器，连续同向移动合并为一个事件
+class BatchedEvents final
+{
+public:
+    static constexpr bool ENABLED = true;
+
+    explicit BatchedEvents(ExecutorListener& listener) noexcept;
+    ~BatchedEvents() noexcept;
+
+    BatchedEvents(const BatchedEvents&) = delete;
+    BatchedEvents& operator=(const BatchedEvents&) = delete;
+
+public:
+    void Emit(const char command, const Pose& from, const Pose& to, const CarMode& mode) noexcept;
+    void Flush(void) noexcept;
+
+private:
+    static constexpr std::size_t CAPACITY = 64;
+
+    ExecutorListener& listener;
+    ExecutorEvent buffer[CAPACITY];
+    std::size_t size{0};
+};
+}  // namespace adas
@@ -1,334 +1,431 @@
 #include "ExecutorImpl.hpp"
-#include "Command.hpp"
-#include <memory>
-#include <string>  // 添加string头文件
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "CounterShard.hpp"
+#include "ExecutorEvents.hpp"
+#include "Geofence.hpp"
+#include "ObstacleMap.hpp"
+#include "Profiler.hpp"
+#include "StateMachine.hpp"
+#include "VehicleTypes.hpp"
 
 namespace adas
 {
-// 车辆配置定义 - 使用构造函数初始化
-const CarConfig ExecutorImpl::normalCarConfig(1, 2, false, false);
-const CarConfig ExecutorImpl::sportsCarConfig(2, 4, true, true);
-const CarConfig ExecutorImpl::busCarConfig(1, 2, true, false); // 新增Bus配置
-
 Executor* Executor::NewExecutor(const Pose& pose) noexcept
 {
     return new (std::nothrow) ExecutorImpl(pose);
 }
 
-// 修改初始化列表顺序以匹配声明顺序
-ExecutorImpl::ExecutorImpl(const Pose& pose) noexcept 
-    : posehandler(pose),                    // 第一：按照声明顺序
-      currentConfig(&normalCarConfig),      // 第二：按照声明顺序
-      carType(CarType::NORMAL)              // 第四：按照声明顺序
+Executor* Executor::NewExecutor(const Pose& pose, const CarMode& mode) noexcept
 {
-    // commandTable会自动默认初始化
-    InitializeNormalCarCommands();
+    return new (std::nothrow) ExecutorImpl(pose, mode);
 }
 
-// 修改Execute函数以处理U命令
-void ExecutorImpl::Execute(const std::string& commands) noexcept
+namespace
 {
-    for (size_t i = 0; i < commands.size(); ++i) {
-        char cmd = commands[i];
-        
-        // 检查是否是TR指令
-        if (cmd == 'T' && i + 1 < commands.size() && commands[i + 1] == 'R') {
-            // 使用TR命令处理
-            TurnRoundCommand turnRoundCmd;
-            turnRoundCmd(posehandler);
-            ++i; // 跳过R字符
-        }
-        // 处理N命令切换车辆
-        else if (cmd == 'N') {
-            if (carType != CarType::BUS) {  // Bus不能切换到跑车
-                SwitchCarType();
-            }
-        }
-        // 处理U命令切换到Bus
-        else if (cmd == 'U') {
-            if (carType != CarType::BUS) {
-                SwitchToBus();
-            } else {
-                // 如果已经是Bus，则切换回普通车
-                SwitchToNormal();
-            }
-        }
-        // 处理其他命令
-        else {
-            auto it = commandTable.find(cmd);
-            if (it != commandTable.end()) {
-                it->second(posehandler);
-            }
-        }
-    }
+// 未注册的车型按NORMAL处理
+CarType RegisteredOrNormal(const CarType carType) noexcept
+{
+    return static_cast<std::size_t>(carType) < CarTypeCount() ? carType : CarType::NORMAL;
 }
 
-// 修改SwitchCarType函数
-void ExecutorImpl::SwitchCarType()
+// 计数槽位对应的实际生效指令，未生效为0
+char ExecutedCommand(const unsigned counter) noexcept
 {
-    if (carType == CarType::NORMAL) {
-        carType = CarType::SPORTS;
-        currentConfig = &sportsCarConfig;
-        InitializeSportsCarCommands();
-    } else {
-        carType = CarType::NORMAL;
-        currentConfig = &normalCarConfig;
-        InitializeNormalCarCommands();
-    }
-    
-    // 切换车辆类型时重置fast和reverse状态
-    // 注意：根据测试用例，切换车辆类型时状态应该重置
-    if (posehandler.IsFast()) {
-        posehandler.Fast(); // 调用Fast切换状态
-    }
-    if (posehandler.IsReverse()) {
-        posehandler.Reverse(); // 调用Reverse切换状态
-    }
+    static const char commands[ExecutorCounters::SIZE] = {'M', 'L', 'R', 'F', 'B', 'N', 'U', 'T'};
+    return commands[counter];
 }
 
-// 新增：切换到Bus
-void ExecutorImpl::SwitchToBus()
+int Sign(const int value) noexcept
 {
-    carType = CarType::BUS;
-    currentConfig = &busCarConfig;
-    InitializeBusCommands();
-    
-    // 切换车辆类型时重置fast和reverse状态
-    if (posehandler.IsFast()) {
-        posehandler.Fast(); // 调用Fast切换状态
-    }
-    if (posehandler.IsReverse()) {
-        posehandler.Reverse(); // 调用Reverse切换状态
+    return (value > 0) - (value < 0);
+}
+
+// 沿坐标轴走一段(dx、dy至少一个为0)：截到第一个障碍前，并检查走过的格子都在围栏内。
+// 前移at并累加实际走的格数；会驶出围栏时返回false
+bool Walk(const Geofence* fence, const ObstacleMap* obstacles, GridPoint& at, const int dx, const int dy,
+          std::uint64_t& moved) noexcept
+{
+    const std::uint64_t length = static_cast<std::uint64_t>(std::abs(dx) + std::abs(dy));
+    const int dirX = Sign(dx);
+    const int dirY = Sign(dy);
+    const std::uint64_t free = obstacles != nullptr ? obstacles->FreeSteps(at, dirX, dirY, length) : length;
+    if (fence != nullptr && fence->StepsInside(at, dirX, dirY, free) != free) {
+        return false;
     }
+    at.x += dirX * static_cast<int>(free);
+    at.y += dirY * static_cast<int>(free);
+    moved += free;
+    return true;
+}
+}  // namespace
+
+ExecutorImpl::ExecutorImpl(const Pose& pose, const CarMode& mode) noexcept
+    : x(pose.x),
+      y(pose.y),
+      state(StateOf(pose.heading, mode.fast, mode.reverse)),
+      carType(RegisteredOrNormal(mode.carType)),
+      table(&TableOf(carType)),
+      box{pose.x, pose.x, pose.y, pose.y},
+      startX(pose.x),
+      startY(pose.y),
+      publishedState(PackPosition(), PackState())
+{
 }
 
-// 新增：从Bus切换回普通车
-void ExecutorImpl::SwitchToNormal()
+ExecutorImpl::~ExecutorImpl() noexcept
 {
-    carType = CarType::NORMAL;
-    currentConfig = &normalCarConfig;
-    InitializeNormalCarCommands();
-    
-    // 切换车辆类型时重置fast和reverse状态
-    if (posehandler.IsFast()) {
-        posehandler.Fast(); // 调用Fast切换状态
+    PublishCounters();
+}
+
+void ExecutorImpl::Execute(const std::string& commands) noexcept
+{
+    ExecuteProfile profile(carType);
+    Replay(commands, 1);
+}
+
+void ExecutorImpl::Replay(const std::string& commands, const std::uint64_t calls) noexcept
+{
+    counters[ExecutorCounter::EXECUTE_CALLS] += calls;
+    Dispatch(commands.data(), commands.size());
+    MaybePublish();
+    PublishState();
+}
+
+std::size_t ExecutorImpl::ExecuteSome(ExecuteCursor& cursor, const std::size_t maxCommands) noexcept
+{
+    if (cursor.Done()) {
+        return 0;
+    }
+    ExecuteProfile profile(carType);
+    const char* data = cursor.commands->data();
+    const std::size_t size = cursor.commands->size();
+    const std::size_t begin = cursor.offset;
+    // 每条指令至少一个字节，按字节截取不会超出预算；不在T和R之间截断，TR仍算一条
+    std::size_t end = size - begin < maxCommands ? size : begin + maxCommands;
+    if (end > begin && end < size && data[end - 1] == 'T' && data[end] == 'R') {
+        ++end;
     }
-    if (posehandler.IsReverse()) {
-        posehandler.Reverse(); // 调用Reverse切换状态
+
+    const std::uint64_t turnRounds = counters[ExecutorCounter::COMMAND_TR] +
+                                     counters[ExecutorCounter::TR_IGNORED_IN_REVERSE];
+    Dispatch(data + begin, end - begin);
+    const std::uint64_t pairs = counters[ExecutorCounter::COMMAND_TR] +
+                                counters[ExecutorCounter::TR_IGNORED_IN_REVERSE] - turnRounds;
+
+    cursor.offset = end;
+    if (end == size) {
+        // 整条指令串执行完才算一次Execute
+        cursor.finished = true;
+        ++counters[ExecutorCounter::EXECUTE_CALLS];
+        MaybePublish();
     }
+    PublishState();
+    return end - begin - static_cast<std::size_t>(pairs);
 }
 
-int ExecutorImpl::GetMoveDistance() const
+std::size_t ExecutorImpl::ExecuteWithin(const std::string& commands, const Geofence& fence) noexcept
 {
-    if (posehandler.IsFast()) {
-        return currentConfig->fastMoveDistance;
+    ExecuteProfile profile(carType);
+    ++counters[ExecutorCounter::EXECUTE_CALLS];
+    std::size_t reached = 0;
+    if (listener == nullptr) {
+        NoEvents events;
+        reached = RunChecked(commands.data(), commands.size(), &fence, events);
     } else {
-        return currentConfig->normalMoveDistance;
+        BatchedEvents events(*listener);
+        reached = RunChecked(commands.data(), commands.size(), &fence, events);
     }
+    MaybePublish();
+    PublishState();
+    return reached;
 }
 
-void ExecutorImpl::HandleMove(PoseHandler& handler)
+void ExecutorImpl::Dispatch(const char* data, const std::size_t size) noexcept
 {
-    bool isReverse = handler.IsReverse();
-    int distance = GetMoveDistance();
-    
-    // 执行移动
-    for (int i = 0; i < distance; ++i) {
-        if (isReverse) {
-            handler.MoveBackward();
+    // 每次Execute只判断一次是否安装了监听器，未安装时走无事件的实例；有障碍物时逐条检查路径
+    if (listener == nullptr) {
+        const EvaluatorIsa isa = size >= VECTOR_THRESHOLD ? GetEvaluatorIsa() : EvaluatorIsa::SCALAR;
+        NoEvents events;
+        if (obstacles != nullptr) {
+            RunChecked(data, size, nullptr, events);
+        } else if (isa != EvaluatorIsa::SCALAR) {
+            RunVectorized(data, size, isa);
+        } else {
+            Run(data, size, events);
+        }
+    } else {
+        BatchedEvents events(*listener);
+        if (obstacles != nullptr) {
+            RunChecked(data, size, nullptr, events);
         } else {
-            handler.Move();
+            Run(data, size, events);
         }
     }
 }
 
-void ExecutorImpl::HandleTurnLeft(PoseHandler& handler)
-{
-    bool isReverse = handler.IsReverse();
-    bool isFast = handler.IsFast();
-    
-    // 跑车转向逻辑
-    if (carType == CarType::SPORTS) {
-        // 加速状态下：先移动1格
-        if (isFast) {
-            if (isReverse) {
-                handler.MoveBackward();
-            } else {
-                handler.Move();
-            }
+void ExecutorImpl::MaybePublish(void) noexcept
+{
+    // 按批并入线程分片，分摊每次Execute的固定开销
+    if (counters[ExecutorCounter::EXECUTE_CALLS] - published[ExecutorCounter::EXECUTE_CALLS] >= PUBLISH_INTERVAL) {
+        PublishCounters();
+    }
+}
+
+void ExecutorImpl::PublishCounters(void) noexcept
+{
+    const ExecutorCounters current = QueryCounters();
+    AddToThreadShard(published, current);
+    published = current;
+}
+
+template <typename EventPolicy>
+void ExecutorImpl::Run(const char* data, const std::size_t size, EventPolicy& events) noexcept
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        unsigned commandClass = COMMAND_CLASS[data[i]];
+        if (commandClass == CLASS_T) {
+            // TR必须在同一次Execute内成对出现，单独的T是未知字符
+            const bool turnRound = i + 1 < size && data[i + 1] == 'R';
+            commandClass = turnRound ? CLASS_TR : CLASS_JUNK;
+            i += turnRound ? 1 : 0;
         }
-        
-        // 转向（倒车时左右相反）
-        if (isReverse) {
-            handler.TurnRight();  // reverse 时左转变成右转
-        } else {
-            handler.TurnLeft();
+
+        [[maybe_unused]] Pose before{};
+        if constexpr (EventPolicy::ENABLED) {
+            before = GetPose();
         }
-        
-        // 跑车总是会在转向后移动1格
-        // 如果是加速状态，这是第二次移动；如果是普通状态，这是第一次移动
-        if (isReverse) {
-            handler.MoveBackward();
-        } else {
-            handler.Move();
+
+        const Transition& transition = (*table)[state][commandClass];
+        Apply(transition);
+
+        if constexpr (EventPolicy::ENABLED) {
+            const char executed = ExecutedCommand(transition.counter);
+            if (executed != '\0') {
+                events.Emit(executed, before, GetPose(), GetMode());
+            }
         }
-    } else {
-        // 普通车使用原来的命令类，不会执行到这里
-        // 为安全起见，调用原来的命令
-        TurnLeftCommand cmd;
-        cmd(handler);
     }
 }
 
-void ExecutorImpl::HandleTurnRight(PoseHandler& handler)
-{
-    bool isReverse = handler.IsReverse();
-    bool isFast = handler.IsFast();
-    
-    // 跑车转向逻辑
-    if (carType == CarType::SPORTS) {
-        // 加速状态下：先移动1格
-        if (isFast) {
-            if (isReverse) {
-                handler.MoveBackward();
-            } else {
-                handler.Move();
+template <typename EventPolicy>
+std::size_t ExecutorImpl::RunChecked(const char* data, const std::size_t size, const Geofence* fence,
+                                     EventPolicy& events) noexcept
+{
+    if (fence != nullptr && !fence->Contains(GridPoint{x, y})) {
+        return 0;
+    }
+    std::size_t i = 0;
+    while (i < size) {
+        unsigned commandClass = COMMAND_CLASS[data[i]];
+        std::size_t length = 1;
+        if (commandClass == CLASS_T) {
+            const bool turnRound = i + 1 < size && data[i + 1] == 'R';
+            commandClass = turnRound ? CLASS_TR : CLASS_JUNK;
+            length = turnRound ? 2 : 1;
+        }
+        const Transition& transition = (*table)[state][commandClass];
+
+        // 不改变状态的指令(直行、未知字符)连续出现时是一条直线，整段一起检查；生成事件时逐条执行
+        std::size_t count = 1;
+        if (!EventPolicy::ENABLED && transition.next == state && transition.switchTo == NO_SWITCH && data[i] != 'T') {
+            while (i + count < size && data[i + count] == data[i]) {
+                ++count;
             }
         }
-        
-        // 转向（倒车时左右相反）
-        if (isReverse) {
-            handler.TurnLeft();  // reverse 时右转变成左转
-        } else {
-            handler.TurnRight();
+
+        [[maybe_unused]] Pose before{};
+        if constexpr (EventPolicy::ENABLED) {
+            before = GetPose();
         }
-        
-        // 跑车总是会在转向后移动1格
-        // 如果是加速状态，这是第二次移动；如果是普通状态，这是第一次移动
-        if (isReverse) {
-            handler.MoveBackward();
+        std::size_t allowed = count;
+        if (transition.steps == 0) {
+            // 不移动的指令(原地转向、F、B、N、U)不会驶出围栏也不会撞上障碍
+            ApplyPath(transition, count, x, y, 0);
+        } else if (count > 1) {
+            // 先截到第一个障碍前，再看围栏内容得下几条完整的指令
+            const std::uint64_t steps = transition.steps;
+            const int dirX = Sign(transition.dx);
+            const int dirY = Sign(transition.dy);
+            const std::uint64_t free =
+                obstacles != nullptr ? obstacles->FreeSteps(GridPoint{x, y}, dirX, dirY, steps * count) : steps * count;
+            const std::uint64_t room = fence != nullptr ? fence->StepsInside(GridPoint{x, y}, dirX, dirY, free) : free;
+            allowed = room < free ? static_cast<std::size_t>(room / steps) : count;
+            const std::uint64_t moved = allowed * steps < free ? allowed * steps : free;
+            ApplyPath(transition, allowed, x + dirX * static_cast<int>(moved), y + dirY * static_cast<int>(moved),
+                      moved);
         } else {
-            handler.Move();
+            // 先沿执行前朝向所在的轴走，再沿另一轴走
+            const bool alongX = ((state >> 2) & 1) == 0;
+            const int firstX = alongX ? transition.dx : 0;
+            const int firstY = alongX ? 0 : transition.dy;
+            GridPoint at{x, y};
+            std::uint64_t moved = 0;
+            if (Walk(fence, obstacles, at, firstX, firstY, moved) &&
+                Walk(fence, obstacles, at, transition.dx - firstX, transition.dy - firstY, moved)) {
+                ApplyPath(transition, 1, at.x, at.y, moved);
+            } else {
+                allowed = 0;
+            }
         }
-    } else {
-        // 普通车使用原来的命令类，不会执行到这里
-        // 为安全起见，调用原来的命令
-        TurnRightCommand cmd;
-        cmd(handler);
+
+        if constexpr (EventPolicy::ENABLED) {
+            const char executed = ExecutedCommand(transition.counter);
+            if (allowed != 0 && executed != '\0') {
+                events.Emit(executed, before, GetPose(), GetMode());
+            }
+        }
+        if (allowed < count) {
+            return i + allowed * length;
+        }
+        i += count * length;
     }
+    return size;
 }
 
-// Bus特有命令处理函数
-void ExecutorImpl::HandleBusMove(PoseHandler& handler)
+void ExecutorImpl::RunVectorized(const char* data, const std::size_t size, const EvaluatorIsa isa) noexcept
 {
-    bool isReverse = handler.IsReverse();
-    int distance = GetMoveDistance();
-    
-    // 执行移动
-    for (int i = 0; i < distance; ++i) {
-        if (isReverse) {
-            handler.MoveBackward();
-        } else {
-            handler.Move();
+    unsigned char classes[FSM_BLOCK];
+    for (std::size_t pos = 0; pos < size; pos += FSM_BLOCK) {
+        const std::size_t length = size - pos < FSM_BLOCK ? size - pos : FSM_BLOCK;
+        std::uint64_t switches = ClassifyCommands(isa, data, size, pos, length, classes);
+        if (switches == 0 && length == FSM_BLOCK && UniformBlock(classes)) {
+            FoldBlock(FsmTablesOf(carType), classes[0], x, y, state, box, counters.values);
+            continue;
+        }
+        std::size_t begin = 0;
+        for (;;) {
+            const std::size_t end = switches != 0 ? static_cast<std::size_t>(__builtin_ctzll(switches)) : length;
+            if (end - begin >= MIN_VECTOR_RUN) {
+                EvaluateClasses(isa, FsmTablesOf(carType), classes + begin, end - begin, x, y, state, box,
+                                counters.values);
+            } else {
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (classes[i] != CLASS_NOP) {
+                        Apply((*table)[state][classes[i]]);
+                    }
+                }
+            }
+            if (end == length) {
+                break;
+            }
+            Apply((*table)[state][classes[end]]);
+            switches &= switches - 1;
+            begin = end + 1;
         }
     }
 }
 
-void ExecutorImpl::HandleBusTurnLeft(PoseHandler& handler)
+void ExecutorImpl::Apply(const Transition& transition) noexcept
 {
-    bool isReverse = handler.IsReverse();
-    int distance = GetMoveDistance();
-    
-    // Bus转向逻辑：先移动，再转向
-    // 执行移动
-    for (int i = 0; i < distance; ++i) {
-        if (isReverse) {
-            handler.MoveBackward();
-        } else {
-            handler.Move();
-        }
-    }
-    
-    // 转向（倒车时左右相反）
-    if (isReverse) {
-        handler.TurnRight();  // reverse 时左转变成右转
-    } else {
-        handler.TurnLeft();
+    x += transition.dx;
+    y += transition.dy;
+    box.Include(x, y);
+    state = transition.next;
+    ++counters.values[transition.counter];
+    counters.values[static_cast<unsigned>(ExecutorCounter::GRID_STEPS)] += transition.steps;
+    if (transition.switchTo != NO_SWITCH) {
+        SwitchCarType(static_cast<CarType>(transition.switchTo));
     }
 }
 
-void ExecutorImpl::HandleBusTurnRight(PoseHandler& handler)
+void ExecutorImpl::ApplyPath(const Transition& transition, const std::uint64_t count, const int endX, const int endY,
+                             const std::uint64_t steps) noexcept
 {
-    bool isReverse = handler.IsReverse();
-    int distance = GetMoveDistance();
-    
-    // Bus转向逻辑：先移动，再转向
-    // 执行移动
-    for (int i = 0; i < distance; ++i) {
-        if (isReverse) {
-            handler.MoveBackward();
-        } else {
-            handler.Move();
-        }
-    }
-    
-    // 转向（倒车时左右相反）
-    if (isReverse) {
-        handler.TurnLeft();  // reverse 时右转变成左转
-    } else {
-        handler.TurnRight();
+    x = endX;
+    y = endY;
+    box.Include(x, y);
+    state = transition.next;
+    counters.values[transition.counter] += count;
+    counters.values[static_cast<unsigned>(ExecutorCounter::GRID_STEPS)] += steps;
+    if (transition.switchTo != NO_SWITCH) {
+        SwitchCarType(static_cast<CarType>(transition.switchTo));
     }
 }
 
-void ExecutorImpl::HandleFast(PoseHandler& handler)
+void ExecutorImpl::SwitchCarType(const CarType target) noexcept
+{
+    TraceSpan span("CarTypeSwitch", target);
+    carType = target;
+    table = &TableOf(carType);
+}
+
+void ExecutorImpl::SetListener(ExecutorListener* listener) noexcept
 {
-    handler.Fast();
+    this->listener = listener;
 }
 
-void ExecutorImpl::HandleReverse(PoseHandler& handler)
+void ExecutorImpl::SetObstacleMap(const ObstacleMap* map) noexcept
 {
-    handler.Reverse();
+    obstacles = map;
 }
 
-void ExecutorImpl::InitializeNormalCarCommands()
+ExecutorCounters ExecutorImpl::QueryCounters(void) const noexcept
 {
-    // 普通车使用原始的命令类
-    commandTable.clear();
-    commandTable['M'] = MoveCommand();
-    commandTable['L'] = TurnLeftCommand();
-    commandTable['R'] = TurnRightCommand();
-    commandTable['F'] = FastCommand();
-    commandTable['B'] = ReverseCommand();
+    // 每条指令只累加一个计数，车型切换次数在查询时合成
+    ExecutorCounters result = counters;
+    result[ExecutorCounter::CAR_TYPE_SWITCHES] =
+        counters[ExecutorCounter::COMMAND_N] + counters[ExecutorCounter::COMMAND_U];
+    return result;
 }
 
-void ExecutorImpl::InitializeSportsCarCommands()
-{
-    // 跑车使用自定义的处理函数
-    commandTable.clear();
-    
-    // 使用lambda表达式绑定成员函数
-    commandTable['M'] = [this](PoseHandler& handler) { this->HandleMove(handler); };
-    commandTable['L'] = [this](PoseHandler& handler) { this->HandleTurnLeft(handler); };
-    commandTable['R'] = [this](PoseHandler& handler) { this->HandleTurnRight(handler); };
-    commandTable['F'] = [this](PoseHandler& handler) { this->HandleFast(handler); };
-    commandTable['B'] = [this](PoseHandler& handler) { this->HandleReverse(handler); };
+PathStats ExecutorImpl::QueryStats(void) const noexcept
+{
+    // 行驶格数本来就计在GRID_STEPS中
+    return PathStats{counters[ExecutorCounter::GRID_STEPS] - startSteps,
+                     box.minX,
+                     box.minY,
+                     box.maxX,
+                     box.maxY,
+                     x - startX,
+                     y - startY};
 }
 
-void ExecutorImpl::InitializeBusCommands()
-{
-    // Bus使用自定义的处理函数
-    commandTable.clear();
-    
-    // 使用lambda表达式绑定成员函数
-    commandTable['M'] = [this](PoseHandler& handler) { this->HandleBusMove(handler); };
-    commandTable['L'] = [this](PoseHandler& handler) { this->HandleBusTurnLeft(handler); };
-    commandTable['R'] = [this](PoseHandler& handler) { this->HandleBusTurnRight(handler); };
-    commandTable['F'] = [this](PoseHandler& handler) { this->HandleFast(handler); };
-    commandTable['B'] = [this](PoseHandler& handler) { this->HandleReverse(handler); };
+void ExecutorImpl::ResetStats(void) noexcept
+{
+    box = PathBox{x, x, y, y};
+    startX = x;
+    startY = y;
+    startSteps = counters[ExecutorCounter::GRID_STEPS];
 }
 
 Pose ExecutorImpl::Query(void) const noexcept
 {
-    return posehandler.Query();
+    return GetPose();
+}
+
+CarMode ExecutorImpl::QueryMode(void) const noexcept
+{
+    return GetMode();
+}
+
+PublishedState ExecutorImpl::QueryPublished(void) const noexcept
+{
+    std::uint64_t position = 0;
+    std::uint64_t packed = 0;
+    const std::uint64_t version = publishedState.Read(position, packed);
+    const unsigned bits = static_cast<unsigned>(packed);
+    return PublishedState{Pose{static_cast<std::int32_t>(position >> 32), static_cast<std::int32_t>(position),
+                               HeadingOf(bits)},
+                          CarMode{static_cast<CarType>(packed >> 32), (bits & 2) != 0,
+                                  (bits & 1) != 0},
+                          version};
+}
+
+void ExecutorImpl::Reset(const Pose& pose, const CarMode& mode) noexcept
+{
+    PublishCounters();
+    x = pose.x;
+    y = pose.y;
+    state = StateOf(pose.heading, mode.fast, mode.reverse);
+    carType = RegisteredOrNormal(mode.carType);
+    table = &TableOf(carType);
+    listener = nullptr;
+    obstacles = nullptr;
+    counters = ExecutorCounters{};
+    published = ExecutorCounters{};
+    ResetStats();
+    PublishState();
 }
-}  // namespace adas
\ No newline at end of file
+}  // namespace adas
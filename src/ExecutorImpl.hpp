@@ -1,80 +1,111 @@
 #pragma once
 #include "Executor.hpp"
-#include "PoseHandler.hpp"
-#include <unordered_map>
-#include <functional>
+#include "ExecutorMetrics.hpp"
+#include "Seqlock.hpp"
+#include "StateMachineEvaluator.hpp"
+#include "VehicleTable.hpp"
 
 namespace adas
 {
-enum class CarType {
-    NORMAL,
-    SPORTS,
-    BUS  // 新增Bus类型
-};
-
-// 车辆配置结构
-struct CarConfig {
-    int normalMoveDistance;     // 普通移动距离
-    int fastMoveDistance;       // 加速移动距离
-    bool turnWithMove;          // 转向时是否伴随移动
-    bool complexTurnRound;      // 是否执行复杂的掉头逻辑
-    
-    // 添加构造函数以支持初始化
-    CarConfig(int normalDist, int fastDist, bool turnMove, bool complexTurn)
-        : normalMoveDistance(normalDist), fastMoveDistance(fastDist), 
-          turnWithMove(turnMove), complexTurnRound(complexTurn) {}
-};
-
+// 车型行为全部编译在VehicleTable中，执行时每个字符只查一次转移表
 class ExecutorImpl final : public Executor
 {
 public:
-    explicit ExecutorImpl(const Pose& pose) noexcept;
-    ~ExecutorImpl() noexcept = default;
+    explicit ExecutorImpl(const Pose& pose, const CarMode& mode = CarMode{}) noexcept;
+    ~ExecutorImpl() noexcept;
 
     ExecutorImpl(const ExecutorImpl&) = delete;
     ExecutorImpl& operator=(const ExecutorImpl&) = delete;
 
+public:
+    // 供批量查询使用的非虚访问接口
+    Pose GetPose(void) const noexcept
+    {
+        return Pose{x, y, HeadingOf(state)};
+    }
+    CarMode GetMode(void) const noexcept
+    {
+        return CarMode{carType, (state & 2) != 0, (state & 1) != 0};
+    }
+
+    // 执行calls次Execute拼接而成的指令串(调用方保证TR不跨越原来的边界)，不记录Execute耗时
+    void Replay(const std::string& commands, const std::uint64_t calls) noexcept;
+
 public:
     void Execute(const std::string& command) noexcept override;
+    std::size_t ExecuteSome(ExecuteCursor& cursor, const std::size_t maxCommands) noexcept override;
+    std::size_t ExecuteWithin(const std::string& commands, const Geofence& fence) noexcept override;
     Pose Query(void) const noexcept override;
+    CarMode QueryMode(void) const noexcept override;
+    PublishedState QueryPublished(void) const noexcept override;
+    void Reset(const Pose& pose, const CarMode& mode = CarMode{}) noexcept override;
+    void SetListener(ExecutorListener* listener) noexcept override;
+    void SetObstacleMap(const ObstacleMap* map) noexcept override;
+    ExecutorCounters QueryCounters(void) const noexcept override;
+    PathStats QueryStats(void) const noexcept override;
+    void ResetStats(void) noexcept override;
+
+private:
+    // 指令执行主循环，事件策略在编译期决定是否生成事件
+    // 执行data[0, size)，TR不会跨越size
+    void Dispatch(const char* data, const std::size_t size) noexcept;
+
+    template <typename EventPolicy>
+    void Run(const char* data, const std::size_t size, EventPolicy& events) noexcept;
+
+    // 逐条按实际路径执行：移动截到第一个障碍前；fence非空时在第一条会驶出围栏的指令前停下，
+    // 返回停下的位置
+    template <typename EventPolicy>
+    std::size_t RunChecked(const char* data, const std::size_t size, const Geofence* fence,
+                           EventPolicy& events) noexcept;
+
+    // 长指令串按块分类，N/U之间的段交给向量化状态机，短段和N/U逐条查表
+    void RunVectorized(const char* data, const std::size_t size, const EvaluatorIsa isa) noexcept;
+
+    void Apply(const Transition& transition) noexcept;
+    // 执行count次同一转移(count > 1时转移不改变状态)，实际走到(endX, endY)，共steps格
+    void ApplyPath(const Transition& transition, const std::uint64_t count, const int endX, const int endY,
+                   const std::uint64_t steps) noexcept;
+
+    // 切换车型只是换一张转移表，不在热路径上
+    void SwitchCarType(const CarType target) noexcept;
+
+    // 把尚未并入线程分片的计数增量并入
+    void PublishCounters(void) noexcept;
+    void MaybePublish(void) noexcept;
+    // 发布位姿和车辆状态，供其他线程的QueryPublished读取
+    void PublishState(void) noexcept
+    {
+        publishedState.Publish(PackPosition(), PackState());
+    }
+    std::uint64_t PackPosition(void) const noexcept
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+    }
+    std::uint64_t PackState(void) const noexcept
+    {
+        return (static_cast<std::uint64_t>(carType) << 32) | state;
+    }
 
 private:
-    using CommandHandler = std::function<void(PoseHandler&)>;
-    
-    // 初始化不同车辆类型的命令表
-    void InitializeNormalCarCommands();
-    void InitializeSportsCarCommands();
-    void InitializeBusCommands();  // 新增Bus命令表初始化
-    
-    // 车辆类型切换
-    void SwitchCarType();
-    void SwitchToBus();      // 新增：切换到Bus
-    void SwitchToNormal();   // 新增：从Bus切换回普通车
-    
-    // 获取当前车辆的移动距离
-    int GetMoveDistance() const;
-    
-    // 命令处理辅助函数
-    void HandleMove(PoseHandler& handler);
-    void HandleTurnLeft(PoseHandler& handler);
-    void HandleTurnRight(PoseHandler& handler);
-    void HandleFast(PoseHandler& handler);
-    void HandleReverse(PoseHandler& handler);
-    
-    // Bus特有命令处理函数
-    void HandleBusMove(PoseHandler& handler);
-    void HandleBusTurnLeft(PoseHandler& handler);
-    void HandleBusTurnRight(PoseHandler& handler);
-    
-    // 按照初始化顺序调整声明顺序
-    PoseHandler posehandler;               // 第一：需要在构造函数中初始化
-    const CarConfig* currentConfig;        // 第二：依赖于posehandler
-    std::unordered_map<char, CommandHandler> commandTable; // 第三：默认初始化
-    CarType carType{CarType::NORMAL};      // 第四：有默认值
-    
-    // 车辆配置表
-    static const CarConfig normalCarConfig;
-    static const CarConfig sportsCarConfig;
-    static const CarConfig busCarConfig;   // 新增Bus配置
+    int x;
+    int y;
+    unsigned state;  // 车型内状态，见VehicleTable.hpp
+    CarType carType;
+    const VehicleTable* table;
+    ExecutorListener* listener{nullptr};    // 未安装监听器时为空
+    const ObstacleMap* obstacles{nullptr};  // 未安装障碍物地图时为空
+    ExecutorCounters counters;              // 自创建或Reset以来的计数
+    ExecutorCounters published;             // 已并入线程分片的部分
+    PathBox box;                            // 统计开始以来经过的格子
+    int startX;                             // 统计开始时的位置和已行驶格数
+    int startY;
+    std::uint64_t startSteps{0};
+    SeqlockPair publishedState;             // 最近一次发布的PackPosition和PackState
+
+    // 每隔多少次Execute把计数并入线程分片；全局快照对每个存活执行器最多滞后这么多次调用
+    static constexpr std::uint64_t PUBLISH_INTERVAL = 32;
+    // 短于此长度的段逐条查表比向量化求值的分组合并开销更小
+    static constexpr std::size_t MIN_VECTOR_RUN = 16;
 };
-}  // namespace adas
\ No newline at end of file
+}  // namespace adas
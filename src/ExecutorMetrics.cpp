@@ -0,0 +1,115 @@
+#include "ExecutorMetrics.hpp"
+#include <atomic>
+#include <cstdio>
+#include "CounterShard.hpp"
+#include "ThreadShards.hpp"
+
+namespace adas
+{
+namespace
+{
+struct CounterShard
+{
+    void MergeFrom(const CounterShard& other) noexcept
+    {
+        for (std::size_t i = 0; i < ExecutorCounters::SIZE; ++i) {
+            values[i].store(values[i].load(std::memory_order_relaxed) + other.values[i].load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint64_t> values[ExecutorCounters::SIZE]{};
+};
+
+using CounterShards = ThreadShards<CounterShard>;
+
+struct Metric
+{
+    ExecutorCounter counter;
+    const char* name;
+    const char* label;  // opcode标签，非指令类计数为空
+};
+
+const Metric METRICS[] = {
+    {ExecutorCounter::COMMAND_M, "adas_executor_commands_total", "M"},
+    {ExecutorCounter::COMMAND_L, "adas_executor_commands_total", "L"},
+    {ExecutorCounter::COMMAND_R, "adas_executor_commands_total", "R"},
+    {ExecutorCounter::COMMAND_F, "adas_executor_commands_total", "F"},
+    {ExecutorCounter::COMMAND_B, "adas_executor_commands_total", "B"},
+    {ExecutorCounter::COMMAND_N, "adas_executor_commands_total", "N"},
+    {ExecutorCounter::COMMAND_U, "adas_executor_commands_total", "U"},
+    {ExecutorCounter::COMMAND_TR, "adas_executor_commands_total", "TR"},
+    {ExecutorCounter::UNKNOWN_SKIPPED, "adas_executor_unknown_skipped_total", nullptr},
+    {ExecutorCounter::TR_IGNORED_IN_REVERSE, "adas_executor_tr_ignored_in_reverse_total", nullptr},
+    {ExecutorCounter::N_REFUSED_IN_BUS, "adas_executor_n_refused_in_bus_total", nullptr},
+    {ExecutorCounter::CAR_TYPE_SWITCHES, "adas_executor_car_type_switches_total", nullptr},
+    {ExecutorCounter::GRID_STEPS, "adas_executor_grid_steps_total", nullptr},
+    {ExecutorCounter::EXECUTE_CALLS, "adas_executor_execute_calls_total", nullptr},
+};
+}  // namespace
+
+void AddToThreadShard(const ExecutorCounters& before, const ExecutorCounters& after) noexcept
+{
+    CounterShard& shard = CounterShards::Local();
+    for (std::size_t i = 0; i < ExecutorCounters::SIZE; ++i) {
+        std::atomic<std::uint64_t>& value = shard.values[i];
+        value.store(value.load(std::memory_order_relaxed) + (after.values[i] - before.values[i]),
+                    std::memory_order_relaxed);
+    }
+}
+
+ExecutorCounters SnapshotGlobalCounters(void) noexcept
+{
+    ExecutorCounters total;
+    CounterShards::Instance().ForEach([&total](const CounterShard& shard) {
+        for (std::size_t i = 0; i < ExecutorCounters::SIZE; ++i) {
+            total.values[i] += shard.values[i].load(std::memory_order_relaxed);
+        }
+    });
+    return total;
+}
+
+std::string FormatPrometheus(const ExecutorCounters& counters)
+{
+    std::string text;
+    const char* previous = nullptr;
+    for (const Metric& metric : METRICS) {
+        if (previous == nullptr || std::string(previous) != metric.name) {
+            text += "# TYPE ";
+            text += metric.name;
+            text += " counter\n";
+            previous = metric.name;
+        }
+        text += metric.name;
+        if (metric.label != nullptr) {
+            text += "{opcode=\"";
+            text += metric.label;
+            text += "\"}";
+        }
+        text += ' ';
+        text += std::to_string(counters[metric.counter]);
+        text += '\n';
+    }
+    return text;
+}
+
+bool WritePrometheus(const std::string& path) noexcept
+{
+    try {
+        const std::string text = FormatPrometheus(SnapshotGlobalCounters());
+        const std::string temp = path + ".tmp";
+        std::FILE* file = std::fopen(temp.c_str(), "w");
+        if (file == nullptr) {
+            return false;
+        }
+        const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        if (std::fclose(file) != 0 || !written) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    } catch (...) {
+        return false;
+    }
+}
+}  // namespace adas
@@ -0,0 +1,108 @@
+#include "ExecutorPool.hpp"
+#include <new>
+#include "ExecutorImpl.hpp"
+
+namespace adas
+{
+struct ExecutorPool::Slab final
+{
+    struct alignas(ExecutorImpl) Slot
+    {
+        unsigned char storage[sizeof(ExecutorImpl)];
+    };
+
+    explicit Slab(const std::size_t size) noexcept : slots(new (std::nothrow) Slot[size])
+    {
+    }
+
+    ExecutorImpl* At(const std::size_t index) noexcept
+    {
+        return reinterpret_cast<ExecutorImpl*>(slots[index].storage);
+    }
+
+    std::unique_ptr<Slot[]> slots;
+};
+
+ExecutorPool::Deleter::Deleter(ExecutorPool* pool) noexcept : pool(pool)
+{
+}
+
+void ExecutorPool::Deleter::operator()(Executor* executor) const noexcept
+{
+    if (pool != nullptr) {
+        pool->Release(executor);
+    } else {
+        delete executor;
+    }
+}
+
+ExecutorPool::ExecutorPool(const std::size_t slabSize) noexcept : slabSize(slabSize == 0 ? 1 : slabSize)
+{
+}
+
+ExecutorPool::~ExecutorPool() noexcept
+{
+    // 前面的slab全部构造满，最后一个slab构造了used个
+    for (std::size_t i = 0; i < slabs.size(); ++i) {
+        const std::size_t constructed = (i + 1 == slabs.size()) ? used : slabSize;
+        for (std::size_t j = 0; j < constructed; ++j) {
+            slabs[i]->At(j)->~ExecutorImpl();
+        }
+    }
+}
+
+ExecutorPool::Handle ExecutorPool::Acquire(const Pose& pose, const CarMode& mode) noexcept
+{
+    ExecutorImpl* executor = nullptr;
+    if (!freeList.empty()) {
+        executor = freeList.back();
+        freeList.pop_back();
+        executor->Reset(pose, mode);
+    } else {
+        executor = Construct(pose, mode);
+    }
+
+    if (executor != nullptr) {
+        ++inUse;
+    }
+    return Handle(executor, Deleter(this));
+}
+
+void ExecutorPool::Release(Executor* executor) noexcept
+{
+    if (executor == nullptr) {
+        return;
+    }
+    // freeList在新建slab时已预留足够容量，这里不会分配内存
+    freeList.push_back(static_cast<ExecutorImpl*>(executor));
+    --inUse;
+}
+
+std::size_t ExecutorPool::Capacity(void) const noexcept
+{
+    return slabs.size() * slabSize;
+}
+
+std::size_t ExecutorPool::InUse(void) const noexcept
+{
+    return inUse;
+}
+
+ExecutorImpl* ExecutorPool::Construct(const Pose& pose, const CarMode& mode) noexcept
+{
+    if (slabs.empty() || used == slabSize) {
+        std::unique_ptr<Slab> slab(new (std::nothrow) Slab(slabSize));
+        if (slab == nullptr || slab->slots == nullptr) {
+            return nullptr;
+        }
+        try {
+            freeList.reserve(Capacity() + slabSize);
+            slabs.push_back(std::move(slab));
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+        used = 0;
+    }
+    return new (slabs.back()->At(used++)) ExecutorImpl(pose, mode);
+}
+}  // namespace adas
@@ -0,0 +1,286 @@
+#include "ExecutorProfiler.hpp"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "Profiler.hpp"
+#include "ThreadShards.hpp"
+#include "VehicleTypes.hpp"
+
+namespace adas
+{
+std::atomic<unsigned> activeProfilingMode{PROFILE_NONE};
+
+namespace
+{
+constexpr std::size_t PROFILED_CAR_TYPES = MAX_CAR_TYPES;
+// 每个线程最多缓存的trace事件数，超出后丢弃，避免长时间开启时内存无限增长
+constexpr std::size_t MAX_TRACE_EVENTS = 1 << 20;
+
+struct TraceEvent
+{
+    const char* name;
+    unsigned tid;
+    CarType carType;
+    std::uint64_t start;
+    std::uint64_t duration;
+};
+
+std::size_t SlotOf(const CarType carType) noexcept
+{
+    const std::size_t slot = static_cast<std::size_t>(carType);
+    return slot < PROFILED_CAR_TYPES ? slot : PROFILED_CAR_TYPES - 1;
+}
+
+struct ProfileShard
+{
+    ProfileShard(void) noexcept : tid(nextTid.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    void RecordLatency(const CarType carType, const std::uint64_t nanoseconds) noexcept
+    {
+        std::atomic<std::uint64_t>& bucket = latency[SlotOf(carType)][LatencyHistogram::IndexOf(nanoseconds)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void RecordTrace(const TraceEvent& event) noexcept
+    {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        if (trace.size() < MAX_TRACE_EVENTS) {
+            try {
+                trace.push_back(event);
+            } catch (const std::bad_alloc&) {
+            }
+        }
+    }
+
+    void MergeFrom(ProfileShard& other) noexcept
+    {
+        for (std::size_t type = 0; type < PROFILED_CAR_TYPES; ++type) {
+            for (std::size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+                const std::uint64_t value = other.latency[type][i].load(std::memory_order_relaxed);
+                latency[type][i].store(latency[type][i].load(std::memory_order_relaxed) + value,
+                                       std::memory_order_relaxed);
+            }
+        }
+        std::lock_guard<std::mutex> lock(traceMutex);
+        std::lock_guard<std::mutex> otherLock(other.traceMutex);
+        try {
+            for (const TraceEvent& event : other.trace) {
+                if (trace.size() >= MAX_TRACE_EVENTS) {
+                    break;
+                }
+                trace.push_back(event);
+            }
+        } catch (const std::bad_alloc&) {
+        }
+    }
+
+    void Clear(void) noexcept
+    {
+        for (auto& histogram : latency) {
+            for (auto& bucket : histogram) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+        std::lock_guard<std::mutex> lock(traceMutex);
+        trace.clear();
+    }
+
+    static std::atomic<unsigned> nextTid;
+
+    unsigned tid;
+    std::atomic<std::uint64_t> latency[PROFILED_CAR_TYPES][LatencyHistogram::BUCKETS]{};
+    std::mutex traceMutex;  // trace由所属线程追加、导出方读取，用锁保护
+    std::vector<TraceEvent> trace;
+};
+
+std::atomic<unsigned> ProfileShard::nextTid{1};
+
+using ProfileShards = ThreadShards<ProfileShard>;
+
+bool WriteFile(const std::string& path, const std::string& text) noexcept
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    return std::fclose(file) == 0 && written;
+}
+}  // namespace
+
+std::size_t LatencyHistogram::IndexOf(const std::uint64_t value) noexcept
+{
+    if (value < SUB_BUCKETS) {
+        return static_cast<std::size_t>(value);
+    }
+    const unsigned exponent = 63 - __builtin_clzll(value);
+    return (exponent - 3) * SUB_BUCKETS + ((value >> (exponent - 4)) & (SUB_BUCKETS - 1));
+}
+
+std::uint64_t LatencyHistogram::UpperBound(const std::size_t index) noexcept
+{
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const unsigned exponent = static_cast<unsigned>(index / SUB_BUCKETS) + 3;
+    const std::uint64_t width = 1ull << (exponent - 4);
+    const std::uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) * width;
+    return lower + (width - 1);
+}
+
+void LatencyHistogram::Record(const std::uint64_t value) noexcept
+{
+    ++buckets[IndexOf(value)];
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& rhs) noexcept
+{
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        buckets[i] += rhs.buckets[i];
+    }
+}
+
+std::uint64_t LatencyHistogram::Count(void) const noexcept
+{
+    std::uint64_t count = 0;
+    for (const std::uint64_t bucket : buckets) {
+        count += bucket;
+    }
+    return count;
+}
+
+std::uint64_t LatencyHistogram::Max(void) const noexcept
+{
+    for (std::size_t i = BUCKETS; i > 0; --i) {
+        if (buckets[i - 1] != 0) {
+            return UpperBound(i - 1);
+        }
+    }
+    return 0;
+}
+
+std::uint64_t LatencyHistogram::Percentile(const double quantile) const noexcept
+{
+    const std::uint64_t count = Count();
+    if (count == 0) {
+        return 0;
+    }
+    // 第rank个样本(从1开始)所在的桶
+    std::uint64_t rank = static_cast<std::uint64_t>(quantile * count + 0.5);
+    rank = rank == 0 ? 1 : (rank > count ? count : rank);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return UpperBound(i);
+        }
+    }
+    return Max();
+}
+
+std::uint64_t ProfileClock(void) noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+void FinishExecuteProfile(const unsigned mode, const CarType carType, const std::uint64_t start) noexcept
+{
+    const std::uint64_t end = ProfileClock();
+    ProfileShard& shard = ProfileShards::Local();
+    if ((mode & PROFILE_LATENCY) != 0) {
+        shard.RecordLatency(carType, end - start);
+    }
+    if ((mode & PROFILE_TRACE) != 0) {
+        shard.RecordTrace(TraceEvent{"Execute", shard.tid, carType, start, end - start});
+    }
+}
+
+void RecordTraceSpan(const char* name, const CarType carType, const std::uint64_t start) noexcept
+{
+    const std::uint64_t end = ProfileClock();
+    ProfileShard& shard = ProfileShards::Local();
+    shard.RecordTrace(TraceEvent{name, shard.tid, carType, start, end - start});
+}
+
+void SetProfilingMode(const unsigned mode) noexcept
+{
+    activeProfilingMode.store(mode, std::memory_order_relaxed);
+}
+
+unsigned GetProfilingMode(void) noexcept
+{
+    return ActiveProfilingMode();
+}
+
+void ResetProfiling(void) noexcept
+{
+    ProfileShards::Instance().ForEach([](ProfileShard& shard) { shard.Clear(); });
+}
+
+LatencyHistogram SnapshotLatency(const CarType carType) noexcept
+{
+    LatencyHistogram histogram;
+    const std::size_t slot = SlotOf(carType);
+    ProfileShards::Instance().ForEach([&histogram, slot](const ProfileShard& shard) {
+        for (std::size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+            histogram.buckets[i] += shard.latency[slot][i].load(std::memory_order_relaxed);
+        }
+    });
+    return histogram;
+}
+
+bool WriteLatencyReport(const std::string& path) noexcept
+{
+    try {
+        std::string text = "carType count p50_ns p99_ns p999_ns max_ns\n";
+        const std::size_t carTypes = CarTypeCount();
+        for (std::size_t slot = 0; slot < carTypes; ++slot) {
+            const CarType carType = static_cast<CarType>(slot);
+            const LatencyHistogram histogram = SnapshotLatency(carType);
+            char line[160];
+            std::snprintf(line, sizeof(line), "%s %llu %llu %llu %llu %llu\n", CarTypeName(carType),
+                          static_cast<unsigned long long>(histogram.Count()),
+                          static_cast<unsigned long long>(histogram.Percentile(0.5)),
+                          static_cast<unsigned long long>(histogram.Percentile(0.99)),
+                          static_cast<unsigned long long>(histogram.Percentile(0.999)),
+                          static_cast<unsigned long long>(histogram.Max()));
+            text += line;
+        }
+        return WriteFile(path, text);
+    } catch (...) {
+        return false;
+    }
+}
+
+bool WriteChromeTrace(const std::string& path) noexcept
+{
+    try {
+        std::string text = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        ProfileShards::Instance().ForEach([&text, &first](ProfileShard& shard) {
+            std::lock_guard<std::mutex> lock(shard.traceMutex);
+            for (const TraceEvent& event : shard.trace) {
+                // 时间单位为微秒，保留纳秒精度
+                char line[256];
+                std::snprintf(line, sizeof(line),
+                              "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                              "\"args\":{\"carType\":\"%s\"}}",
+                              first ? "" : ",", event.name, event.tid, event.start / 1000.0,
+                              event.duration / 1000.0, CarTypeName(event.carType));
+                text += line;
+                first = false;
+            }
+        });
+        text += "\n]}\n";
+        return WriteFile(path, text);
+    } catch (...) {
+        return false;
+    }
+}
+}  // namespace adas
@@ -0,0 +1,400 @@
+#include "Fleet.hpp"
+#include <algorithm>
+#include <new>
+#include <utility>
+#include "CollisionDetector.hpp"
+#include "ParallelFor.hpp"
+
+namespace adas
+{
+namespace
+{
+std::uint64_t CellKey(const std::int64_t cellX, const std::int64_t cellY) noexcept
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cellX)) << 32) |
+           static_cast<std::uint32_t>(cellY);
+}
+
+// 乘法散列，取高位作为桶号
+std::size_t BucketOf(const std::uint64_t key, const std::size_t mask) noexcept
+{
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+// Tick时每个线程一次领取的车辆数
+constexpr std::size_t TICK_BLOCK = 4096;
+
+std::uint64_t Distance(const std::int64_t dx, const std::int64_t dy) noexcept
+{
+    return static_cast<std::uint64_t>((dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy));
+}
+}  // namespace
+
+Fleet::Fleet(const unsigned cellBits) noexcept : cellBits(cellBits > 30 ? 30 : cellBits)
+{
+}
+
+Fleet::~Fleet() noexcept = default;
+
+VehicleId Fleet::Add(const Pose& pose, const CarMode& mode) noexcept
+{
+    ExecutorPool::Handle executor = pool.Acquire(pose, mode);
+    if (!executor || (freeIds.empty() && slots.size() >= INVALID_VEHICLE)) {
+        return INVALID_VEHICLE;
+    }
+    const bool reuse = !freeIds.empty();
+    const VehicleId id = reuse ? freeIds.back() : static_cast<VehicleId>(slots.size());
+    try {
+        if (!reuse) {
+            slots.emplace_back();
+            // Remove归还编号时不再分配内存
+            freeIds.reserve(slots.size());
+        }
+        Insert(id, pose.x, pose.y);
+    } catch (const std::bad_alloc&) {
+        if (!reuse && slots.size() == static_cast<std::size_t>(id) + 1) {
+            slots.pop_back();
+        }
+        return INVALID_VEHICLE;
+    }
+    if (reuse) {
+        freeIds.pop_back();
+    }
+    executor->SetObstacleMap(obstacles);
+    slots[id].executor = std::move(executor);
+    ++size;
+    return id;
+}
+
+void Fleet::Remove(const VehicleId id) noexcept
+{
+    if (!Contains(id)) {
+        return;
+    }
+    Slot& slot = slots[id];
+    Erase(slot.cell, slot.index);
+    slot.executor.reset();
+    freeIds.push_back(id);
+    --size;
+}
+
+bool Fleet::Contains(const VehicleId id) const noexcept
+{
+    return id < slots.size() && slots[id].executor != nullptr;
+}
+
+void Fleet::Execute(const VehicleId id, const std::string& commands)
+{
+    if (!Contains(id)) {
+        return;
+    }
+    Slot& slot = slots[id];
+    slot.executor->Execute(commands);
+    const Pose pose = slot.executor->Query();
+    const Cell& current = cells[slot.cell];
+    if ((pose.x >> cellBits) == current.x && (pose.y >> cellBits) == current.y) {
+        Entry& entry = cells[slot.cell].entries[slot.index];
+        entry.x = pose.x;
+        entry.y = pose.y;
+        return;
+    }
+    // 先加入新格子再从旧格子移除，加入失败时索引保持不变
+    const std::uint32_t oldCell = slot.cell;
+    const std::uint32_t oldIndex = slot.index;
+    Insert(id, pose.x, pose.y);
+    Erase(oldCell, oldIndex);
+}
+
+void Fleet::TickOne(const VehicleId id, const std::string* commands) noexcept
+{
+    Slot& slot = slots[id];
+    VehicleMove& move = moves[id];
+    if (slot.executor == nullptr) {
+        move.id = INVALID_VEHICLE;
+        return;
+    }
+    Entry& entry = cells[slot.cell].entries[slot.index];
+    move = VehicleMove{{entry.x, entry.y}, {entry.x, entry.y}, id};
+    if (commands == nullptr || commands->empty()) {
+        return;
+    }
+    slot.executor->Execute(*commands);
+    const Pose pose = slot.executor->Query();
+    move.to = GridPoint{pose.x, pose.y};
+    const Cell& current = cells[slot.cell];
+    if ((pose.x >> cellBits) == current.x && (pose.y >> cellBits) == current.y) {
+        entry.x = pose.x;
+        entry.y = pose.y;
+    }
+}
+
+void Fleet::Tick(const std::vector<std::string>& commands, std::vector<Collision>& collisions, const unsigned threads)
+{
+    if (detector == nullptr) {
+        detector.reset(new CollisionDetector());
+    }
+    moves.resize(slots.size());
+
+    // 各车辆的执行器和索引项互不相干，可以并行执行；换格子要改动共享的格子表，留到之后依次处理
+    const std::size_t blocks = (slots.size() + TICK_BLOCK - 1) / TICK_BLOCK;
+    ParallelFor(blocks, threads, [this, &commands](const std::size_t block) {
+        const std::size_t end = std::min(slots.size(), (block + 1) * TICK_BLOCK);
+        for (std::size_t id = block * TICK_BLOCK; id < end; ++id) {
+            TickOne(static_cast<VehicleId>(id), id < commands.size() ? &commands[id] : nullptr);
+        }
+    });
+    for (const VehicleMove& move : moves) {
+        if (move.id == INVALID_VEHICLE) {
+            continue;
+        }
+        const Slot& slot = slots[move.id];
+        const Cell& current = cells[slot.cell];
+        if ((move.to.x >> cellBits) != current.x || (move.to.y >> cellBits) != current.y) {
+            const std::uint32_t oldCell = slot.cell;
+            const std::uint32_t oldIndex = slot.index;
+            Insert(move.id, move.to.x, move.to.y);
+            Erase(oldCell, oldIndex);
+        }
+    }
+
+    detector->Detect(moves, threads, collisions);
+}
+
+const Executor& Fleet::Vehicle(const VehicleId id) const noexcept
+{
+    return *slots[id].executor;
+}
+
+GridPoint Fleet::Position(const VehicleId id) const noexcept
+{
+    const Slot& slot = slots[id];
+    const Entry& entry = cells[slot.cell].entries[slot.index];
+    return GridPoint{entry.x, entry.y};
+}
+
+void Fleet::SetObstacleMap(const ObstacleMap* map) noexcept
+{
+    obstacles = map;
+    for (Slot& slot : slots) {
+        if (slot.executor != nullptr) {
+            slot.executor->SetObstacleMap(map);
+        }
+    }
+}
+
+std::uint32_t Fleet::FindCell(const std::int64_t cellX, const std::int64_t cellY) const noexcept
+{
+    if (buckets.empty()) {
+        return NO_CELL;
+    }
+    const std::uint64_t key = CellKey(cellX, cellY);
+    const std::size_t mask = buckets.size() - 1;
+    for (std::size_t bucket = BucketOf(key, mask);; bucket = (bucket + 1) & mask) {
+        if (buckets[bucket].cell == NO_CELL || buckets[bucket].key == key) {
+            return buckets[bucket].cell;
+        }
+    }
+}
+
+std::uint32_t Fleet::FindOrAddCell(const std::int64_t cellX, const std::int64_t cellY)
+{
+    const std::uint32_t found = FindCell(cellX, cellY);
+    if (found != NO_CELL) {
+        return found;
+    }
+
+    // 先完成可能失败的分配，再修改表
+    if ((cells.size() + 1) * 2 > buckets.size()) {
+        std::vector<Bucket> larger(buckets.empty() ? 64 : buckets.size() * 2, Bucket{0, NO_CELL});
+        const std::size_t mask = larger.size() - 1;
+        for (std::uint32_t i = 0; i < cells.size(); ++i) {
+            const std::uint64_t key = CellKey(cells[i].x, cells[i].y);
+            std::size_t bucket = BucketOf(key, mask);
+            while (larger[bucket].cell != NO_CELL) {
+                bucket = (bucket + 1) & mask;
+            }
+            larger[bucket] = Bucket{key, i};
+        }
+        buckets.swap(larger);
+    }
+    cells.push_back(Cell{cellX, cellY, {}});
+
+    const std::uint32_t cell = static_cast<std::uint32_t>(cells.size() - 1);
+    const std::uint64_t key = CellKey(cellX, cellY);
+    const std::size_t mask = buckets.size() - 1;
+    std::size_t bucket = BucketOf(key, mask);
+    while (buckets[bucket].cell != NO_CELL) {
+        bucket = (bucket + 1) & mask;
+    }
+    buckets[bucket] = Bucket{key, cell};
+
+    if (minCellX > maxCellX) {
+        minCellX = maxCellX = cellX;
+        minCellY = maxCellY = cellY;
+    }
+    minCellX = std::min(minCellX, cellX);
+    maxCellX = std::max(maxCellX, cellX);
+    minCellY = std::min(minCellY, cellY);
+    maxCellY = std::max(maxCellY, cellY);
+    return cell;
+}
+
+void Fleet::Insert(const VehicleId id, const int x, const int y)
+{
+    const std::uint32_t cell = FindOrAddCell(x >> cellBits, y >> cellBits);
+    std::vector<Entry>& entries = cells[cell].entries;
+    entries.push_back(Entry{x, y, id});
+    slots[id].cell = cell;
+    slots[id].index = static_cast<std::uint32_t>(entries.size() - 1);
+}
+
+void Fleet::Erase(const std::uint32_t cell, const std::uint32_t index) noexcept
+{
+    std::vector<Entry>& entries = cells[cell].entries;
+    // 用最后一项填补空位
+    if (static_cast<std::size_t>(index) + 1 != entries.size()) {
+        entries[index] = entries.back();
+        slots[entries[index].id].index = index;
+    }
+    entries.pop_back();
+}
+
+void Fleet::QueryRect(const GridPoint& corner, const GridPoint& opposite, std::vector<VehicleId>& result) const
+{
+    result.clear();
+    const int lowX = std::min(corner.x, opposite.x);
+    const int highX = std::max(corner.x, opposite.x);
+    const int lowY = std::min(corner.y, opposite.y);
+    const int highY = std::max(corner.y, opposite.y);
+    const auto collect = [&](const std::vector<Entry>& entries) {
+        for (const Entry& entry : entries) {
+            if (entry.x >= lowX && entry.x <= highX && entry.y >= lowY && entry.y <= highY) {
+                result.push_back(entry.id);
+            }
+        }
+    };
+
+    const std::int64_t cellX0 = lowX >> cellBits;
+    const std::int64_t cellX1 = highX >> cellBits;
+    const std::int64_t cellY0 = lowY >> cellBits;
+    const std::int64_t cellY1 = highY >> cellBits;
+    // 矩形覆盖的格子比已有的格子还多时，改为遍历已有的格子
+    const std::uint64_t width = static_cast<std::uint64_t>(cellX1 - cellX0 + 1);
+    const std::uint64_t height = static_cast<std::uint64_t>(cellY1 - cellY0 + 1);
+    if (width <= cells.size() && height <= cells.size() / width) {
+        for (std::int64_t cellY = cellY0; cellY <= cellY1; ++cellY) {
+            for (std::int64_t cellX = cellX0; cellX <= cellX1; ++cellX) {
+                const std::uint32_t cell = FindCell(cellX, cellY);
+                if (cell != NO_CELL) {
+                    collect(cells[cell].entries);
+                }
+            }
+        }
+        return;
+    }
+    for (const Cell& cell : cells) {
+        if (cell.x >= cellX0 && cell.x <= cellX1 && cell.y >= cellY0 && cell.y <= cellY1) {
+            collect(cell.entries);
+        }
+    }
+}
+
+void Fleet::QueryNearest(const GridPoint& center, const std::size_t k, std::vector<VehicleId>& result) const
+{
+    result.clear();
+    if (k == 0 || size == 0) {
+        return;
+    }
+
+    // 已找到的最近k辆车，堆顶是其中最远的
+    using Candidate = std::pair<std::uint64_t, VehicleId>;
+    std::vector<Candidate> best;
+    best.reserve(std::min(k, size));
+    const auto collect = [&](const std::vector<Entry>& entries) {
+        for (const Entry& entry : entries) {
+            const std::int64_t dx = static_cast<std::int64_t>(entry.x) - center.x;
+            const std::int64_t dy = static_cast<std::int64_t>(entry.y) - center.y;
+            const Candidate candidate{Distance(dx, dy), entry.id};
+            if (best.size() < k) {
+                best.push_back(candidate);
+                std::push_heap(best.begin(), best.end());
+            } else if (candidate < best.front()) {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = candidate;
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+    };
+    const auto visit = [&](const std::int64_t cellX, const std::int64_t cellY) {
+        const std::uint32_t cell = FindCell(cellX, cellY);
+        if (cell != NO_CELL) {
+            collect(cells[cell].entries);
+        }
+    };
+
+    // 按切比雪夫距离一圈圈向外搜索格子。第r圈(r >= 1)的格子与center的曼哈顿距离至少为
+    // (r - 1) * 格子边长 + 1，第k近的车不比这更远时外圈不会有更近的车
+    const std::int64_t cellX = center.x >> cellBits;
+    const std::int64_t cellY = center.y >> cellBits;
+    const std::int64_t first = std::max({std::int64_t{0}, cellX - maxCellX, minCellX - cellX, cellY - maxCellY,
+                                         minCellY - cellY});
+    const std::int64_t last = std::max({cellX - minCellX, maxCellX - cellX, cellY - minCellY, maxCellY - cellY});
+    // 车辆稀疏或不足k辆时圈里大多是空格子，查过的格子数超过已有格子数后改为直接遍历已有的格子
+    std::uint64_t probes = 0;
+    bool scanAll = false;
+    for (std::int64_t ring = first; ring <= last; ++ring) {
+        if (best.size() == k && ring >= 1 &&
+            best.front().first <= static_cast<std::uint64_t>(ring - 1) << cellBits) {
+            break;
+        }
+        // 本圈截到已有格子范围内的格子数
+        const auto inside = [](const std::int64_t v, const std::int64_t low, const std::int64_t high) {
+            return v >= low && v <= high ? 1 : 0;
+        };
+        const std::int64_t rows = inside(cellY - ring, minCellY, maxCellY) + inside(cellY + ring, minCellY, maxCellY);
+        const std::int64_t columns =
+            inside(cellX - ring, minCellX, maxCellX) + inside(cellX + ring, minCellX, maxCellX);
+        const std::int64_t rowCells = std::max<std::int64_t>(
+            0, std::min(cellX + ring, maxCellX) - std::max(cellX - ring, minCellX) + 1);
+        const std::int64_t columnCells = std::max<std::int64_t>(
+            0, std::min(cellY + ring - 1, maxCellY) - std::max(cellY - ring + 1, minCellY) + 1);
+        probes += ring == 0 ? 1 : static_cast<std::uint64_t>(rows * rowCells + columns * columnCells);
+        if (probes > cells.size()) {
+            scanAll = true;
+            break;
+        }
+        if (ring == 0) {
+            visit(cellX, cellY);
+            continue;
+        }
+        // 上下两行含角，左右两列不含角，都截到已有格子的范围内
+        for (const std::int64_t y : {cellY - ring, cellY + ring}) {
+            if (y >= minCellY && y <= maxCellY) {
+                for (std::int64_t x = std::max(cellX - ring, minCellX); x <= std::min(cellX + ring, maxCellX); ++x) {
+                    visit(x, y);
+                }
+            }
+        }
+        for (const std::int64_t x : {cellX - ring, cellX + ring}) {
+            if (x >= minCellX && x <= maxCellX) {
+                for (std::int64_t y = std::max(cellY - ring + 1, minCellY); y <= std::min(cellY + ring - 1, maxCellY);
+                     ++y) {
+                    visit(x, y);
+                }
+            }
+        }
+    }
+
+    if (scanAll) {
+        best.clear();
+        for (const Cell& cell : cells) {
+            collect(cell.entries);
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    for (const Candidate& candidate : best) {
+        result.push_back(candidate.second);
+    }
+}
+}  // namespace adas
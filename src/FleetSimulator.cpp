@@ -0,0 +1,128 @@
+#include "FleetSimulator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <thread>
+#include "BatchQuery.hpp"
+#include "ParallelFor.hpp"
+
+namespace adas
+{
+namespace
+{
+// 每个线程一次领取的车辆数
+constexpr std::size_t TICK_BLOCK = 1024;
+
+std::uint64_t NowNs(void) noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+}  // namespace
+
+FleetSimulator::Snapshot::Snapshot(Snapshot&& other) noexcept : buffer(other.buffer)
+{
+    other.buffer = nullptr;
+}
+
+FleetSimulator::Snapshot::~Snapshot() noexcept
+{
+    if (buffer != nullptr) {
+        buffer->readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+FleetSimulator::FleetSimulator(const std::vector<Pose>& poses, const FleetSimulatorOptions& options)
+    : FleetSimulator(poses, std::vector<CarMode>(poses.size()), options)
+{
+}
+
+FleetSimulator::FleetSimulator(const std::vector<Pose>& poses, const std::vector<CarMode>& modes,
+                               const FleetSimulatorOptions& options)
+    : options(options), pool(std::max<std::size_t>(poses.size(), 1))
+{
+    vehicles.reserve(poses.size());
+    executors.reserve(poses.size());
+    for (std::size_t i = 0; i < poses.size(); ++i) {
+        ExecutorPool::Handle vehicle = pool.Acquire(poses[i], i < modes.size() ? modes[i] : CarMode{});
+        if (!vehicle) {
+            throw std::bad_alloc();
+        }
+        executors.push_back(vehicle.get());
+        vehicles.push_back(std::move(vehicle));
+    }
+    for (Buffer& buffer : buffers) {
+        buffer.x.resize(poses.size());
+        buffer.y.resize(poses.size());
+        buffer.heading.resize(poses.size());
+        buffer.mode.resize(poses.size());
+    }
+    Publish(buffers[0], 0, poses.size());
+}
+
+void FleetSimulator::Publish(Buffer& buffer, const std::size_t begin, const std::size_t end) noexcept
+{
+    const PoseColumns columns{buffer.x.data() + begin, buffer.y.data() + begin, buffer.heading.data() + begin,
+                              buffer.mode.data() + begin};
+    QueryBatch(executors.data() + begin, end - begin, columns);
+}
+
+void FleetSimulator::Tick(const std::vector<std::string>& commands)
+{
+    const std::uint64_t start = NowNs();
+    const unsigned current = front.load(std::memory_order_relaxed);
+    Buffer& back = buffers[current ^ 1];
+    // 等还在读上上个tick的读者离开。与Read配对使用顺序一致的内存序：
+    // 读者要么在这里之前登记并被看到，要么之后登记并发现front已经变了而放弃这个缓冲
+    while (back.readers.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+    }
+    const std::uint64_t ready = NowNs();
+
+    const auto run = [this, &commands, &back](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end && i < commands.size(); ++i) {
+            if (!commands[i].empty()) {
+                vehicles[i]->Execute(commands[i]);
+            }
+        }
+        Publish(back, begin, end);
+    };
+    const std::size_t size = vehicles.size();
+    if (options.deterministic) {
+        run(0, size);
+    } else {
+        ParallelFor((size + TICK_BLOCK - 1) / TICK_BLOCK, options.threads, [&run, size](const std::size_t block) {
+            run(block * TICK_BLOCK, std::min(size, (block + 1) * TICK_BLOCK));
+        });
+    }
+    back.tick = buffers[current].tick + 1;
+    front.store(current ^ 1, std::memory_order_seq_cst);
+
+    const std::uint64_t elapsed = NowNs() - start;
+    for (std::size_t i = 0; i < size && i < commands.size(); ++i) {
+        stats.commands += commands[i].size();
+    }
+    stats.minNs = stats.ticks == 0 ? elapsed : std::min(stats.minNs, elapsed);
+    stats.maxNs = std::max(stats.maxNs, elapsed);
+    ++stats.ticks;
+    stats.lastNs = elapsed;
+    stats.totalNs += elapsed;
+    stats.lastWaitNs = ready - start;
+    stats.totalWaitNs += ready - start;
+}
+
+FleetSimulator::Snapshot FleetSimulator::Read(void) const noexcept
+{
+    for (;;) {
+        const unsigned current = front.load(std::memory_order_seq_cst);
+        const Buffer& buffer = buffers[current];
+        buffer.readers.fetch_add(1, std::memory_order_seq_cst);
+        if (front.load(std::memory_order_seq_cst) == current) {
+            return Snapshot(&buffer);
+        }
+        // Tick在登记前切换了缓冲，这个缓冲可能正在被改写
+        buffer.readers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+}  // namespace adas
@@ -0,0 +1,86 @@
+#include "FrameHandler.hpp"
+#include <cstring>
+#include <new>
+
+namespace adas
+{
+void FrameHandler::Handle(const RequestHeader& header, const char* payload, Response& response,
+                          CommandServerStats& stats) noexcept
+{
+    ++stats.frames;
+    response.type = header.type;
+    response.vehicle = header.vehicle;
+    response.tag = header.tag;
+    response.status = static_cast<std::uint16_t>(FrameStatus::OK);
+    const VehicleRegistry::Guard guard;
+    Executor* executor = registry.Find(guard, header.vehicle);
+    switch (static_cast<FrameType>(header.type)) {
+    case FrameType::EXECUTE:
+        if (executor == nullptr && registry.Insert(header.vehicle, {0, 0, 'N'})) {
+            executor = registry.Find(guard, header.vehicle);
+        }
+        if (executor == nullptr) {
+            response.status = static_cast<std::uint16_t>(FrameStatus::NO_MEMORY);
+            return;
+        }
+        try {
+            commands.assign(payload, header.length);
+        } catch (const std::bad_alloc&) {
+            response.status = static_cast<std::uint16_t>(FrameStatus::NO_MEMORY);
+            return;
+        }
+        executor->Execute(commands);
+        stats.commandBytes += header.length;
+        break;
+    case FrameType::QUERY:
+    case FrameType::REMOVE:
+        if (header.length != 0) {
+            response.status = static_cast<std::uint16_t>(FrameStatus::BAD_FRAME);
+            ++stats.badFrames;
+            return;
+        }
+        if (executor == nullptr) {
+            response.status = static_cast<std::uint16_t>(FrameStatus::UNKNOWN_VEHICLE);
+            return;
+        }
+        break;
+    case FrameType::RESET: {
+        if (header.length != sizeof(ResetPayload)) {
+            response.status = static_cast<std::uint16_t>(FrameStatus::BAD_FRAME);
+            ++stats.badFrames;
+            return;
+        }
+        ResetPayload reset;
+        std::memcpy(&reset, payload, sizeof(reset));
+        const Pose pose{reset.x, reset.y, reset.heading};
+        const CarMode mode{static_cast<CarType>(reset.carType), reset.fast != 0, reset.reverse != 0};
+        if (executor != nullptr) {
+            executor->Reset(pose, mode);
+        } else if (registry.Insert(header.vehicle, pose, mode)) {
+            executor = registry.Find(guard, header.vehicle);
+        } else {
+            response.status = static_cast<std::uint16_t>(FrameStatus::NO_MEMORY);
+            return;
+        }
+        break;
+    }
+    default:
+        response.status = static_cast<std::uint16_t>(FrameStatus::BAD_FRAME);
+        ++stats.badFrames;
+        return;
+    }
+
+    const Pose pose = executor->Query();
+    const CarMode mode = executor->QueryMode();
+    response.x = pose.x;
+    response.y = pose.y;
+    response.heading = pose.heading;
+    response.carType = static_cast<std::uint8_t>(mode.carType);
+    response.fast = static_cast<std::uint8_t>(mode.fast);
+    response.reverse = static_cast<std::uint8_t>(mode.reverse);
+    // 执行器在guard离开前不会被复用，移除前的位姿已经读出
+    if (static_cast<FrameType>(header.type) == FrameType::REMOVE) {
+        registry.Remove(header.vehicle);
+    }
+}
+}  // namespace adas
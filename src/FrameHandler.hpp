@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "CommandProtocol.hpp"
+#include "CommandServer.hpp"
+#include "VehicleRegistry.hpp"
+
+namespace adas
+{
+// 指令服务的请求处理：按车辆编号在注册表中找到执行器，执行一个请求帧并填好应答。
+// 套接字服务和共享内存服务共用，Handle只能在一个线程上调用
+class FrameHandler final
+{
+public:
+    FrameHandler(void) noexcept = default;
+
+    FrameHandler(const FrameHandler&) = delete;
+    FrameHandler& operator=(const FrameHandler&) = delete;
+
+public:
+    // payload为连续的header.length字节，调用方已确认length不超过MAX_FRAME_PAYLOAD
+    void Handle(const RequestHeader& header, const char* payload, Response& response,
+                CommandServerStats& stats) noexcept;
+
+    std::size_t Vehicles(void) const noexcept
+    {
+        return registry.Size();
+    }
+
+private:
+    VehicleRegistry registry;
+    std::string commands;  // EXECUTE负载的复用缓冲
+};
+}  // namespace adas
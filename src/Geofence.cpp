@@ -0,0 +1,203 @@
+#include "Geofence.hpp"
+#include <algorithm>
+#include <new>
+#include <utility>
+
+namespace adas
+{
+namespace
+{
+// 边与某一行的交点 whole + rest / den，0 <= rest < den
+struct Crossing
+{
+    std::int64_t whole;
+    std::uint64_t rest;
+    std::uint64_t den;
+};
+
+bool operator<(const Crossing& lhs, const Crossing& rhs) noexcept
+{
+    if (lhs.whole != rhs.whole) {
+        return lhs.whole < rhs.whole;
+    }
+    return static_cast<unsigned __int128>(lhs.rest) * rhs.den < static_cast<unsigned __int128>(rhs.rest) * lhs.den;
+}
+
+// 沿行方向的坐标u和行号v；按列编译时交换x和y
+struct Vertex
+{
+    std::int64_t u;
+    std::int64_t v;
+};
+
+// 边a->b与第line行的交点，调用方保证a.v != b.v。坐标差可达2^32，乘积用128位
+Crossing CrossingAt(const Vertex& a, const Vertex& b, const std::int64_t line) noexcept
+{
+    __int128 num = static_cast<__int128>(line - a.v) * (b.u - a.u);
+    __int128 den = b.v - a.v;
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    __int128 whole = num / den;
+    if (num % den < 0) {
+        --whole;
+    }
+    const __int128 rest = num - whole * den;
+    return Crossing{static_cast<std::int64_t>(whole + a.u), static_cast<std::uint64_t>(rest),
+                    static_cast<std::uint64_t>(den)};
+}
+}  // namespace
+
+Geofence Geofence::Rectangle(const GridPoint& corner, const GridPoint& opposite) noexcept
+{
+    Geofence fence;
+    fence.xRange = Interval{std::min(corner.x, opposite.x), std::max(corner.x, opposite.x)};
+    fence.yRange = Interval{std::min(corner.y, opposite.y), std::max(corner.y, opposite.y)};
+    return fence;
+}
+
+bool Geofence::Polygon(const std::vector<GridPoint>& vertices, Geofence& result) noexcept
+{
+    Geofence fence;
+    fence.rectangle = false;
+    if (vertices.empty()) {
+        result = std::move(fence);
+        return true;
+    }
+
+    fence.xRange = Interval{vertices[0].x, vertices[0].x};
+    fence.yRange = Interval{vertices[0].y, vertices[0].y};
+    for (const GridPoint& vertex : vertices) {
+        fence.xRange = Interval{std::min(fence.xRange.low, vertex.x), std::max(fence.xRange.high, vertex.x)};
+        fence.yRange = Interval{std::min(fence.yRange.low, vertex.y), std::max(fence.yRange.high, vertex.y)};
+    }
+    const std::uint64_t lines = static_cast<std::uint64_t>(static_cast<std::int64_t>(fence.xRange.high) -
+                                                           fence.xRange.low + fence.yRange.high - fence.yRange.low + 2);
+    if (lines > MAX_POLYGON_LINES || lines * vertices.size() > MAX_POLYGON_COST) {
+        return false;
+    }
+
+    // 每一行：内部格点由奇偶规则的交点配对得到(交点按下闭上开计，顶点不会重复)，
+    // 边界格点单独加入，最后合并相接的区间
+    const auto compile = [&vertices](const bool transposed, const Interval& range, Lines& lines) {
+        std::vector<Vertex> polygon;
+        polygon.reserve(vertices.size());
+        for (const GridPoint& vertex : vertices) {
+            polygon.push_back(transposed ? Vertex{vertex.y, vertex.x} : Vertex{vertex.x, vertex.y});
+        }
+
+        lines.first = range.low;
+        lines.offsets.assign(1, 0);
+        std::vector<Crossing> crossings;
+        std::vector<Interval> spans;
+        for (std::int64_t line = range.low; line <= range.high; ++line) {
+            crossings.clear();
+            spans.clear();
+            for (std::size_t i = 0; i < polygon.size(); ++i) {
+                const Vertex& a = polygon[i];
+                const Vertex& b = polygon[i + 1 < polygon.size() ? i + 1 : 0];
+                if (line < std::min(a.v, b.v) || line > std::max(a.v, b.v)) {
+                    continue;
+                }
+                if (a.v == b.v) {
+                    spans.push_back(
+                        Interval{static_cast<int>(std::min(a.u, b.u)), static_cast<int>(std::max(a.u, b.u))});
+                    continue;
+                }
+                const Crossing crossing = CrossingAt(a, b, line);
+                if (crossing.rest == 0) {
+                    spans.push_back(Interval{static_cast<int>(crossing.whole), static_cast<int>(crossing.whole)});
+                }
+                if (line < std::max(a.v, b.v)) {
+                    crossings.push_back(crossing);
+                }
+            }
+
+            std::sort(crossings.begin(), crossings.end());
+            for (std::size_t i = 0; i + 1 < crossings.size(); i += 2) {
+                const std::int64_t low = crossings[i].whole + (crossings[i].rest != 0 ? 1 : 0);
+                const std::int64_t high = crossings[i + 1].whole;
+                if (low <= high) {
+                    spans.push_back(Interval{static_cast<int>(low), static_cast<int>(high)});
+                }
+            }
+
+            std::sort(spans.begin(), spans.end(),
+                      [](const Interval& lhs, const Interval& rhs) { return lhs.low < rhs.low; });
+            const std::size_t begin = lines.intervals.size();
+            for (const Interval& span : spans) {
+                if (lines.intervals.size() > begin &&
+                    static_cast<std::int64_t>(span.low) <= static_cast<std::int64_t>(lines.intervals.back().high) + 1) {
+                    lines.intervals.back().high = std::max(lines.intervals.back().high, span.high);
+                } else {
+                    lines.intervals.push_back(span);
+                }
+            }
+            lines.offsets.push_back(lines.intervals.size());
+        }
+    };
+    try {
+        compile(false, fence.yRange, fence.rows);
+        compile(true, fence.xRange, fence.columns);
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    result = std::move(fence);
+    return true;
+}
+
+const Geofence::Interval* Geofence::Lines::Find(const int line, const int pos) const noexcept
+{
+    const std::int64_t index = static_cast<std::int64_t>(line) - first;
+    if (index < 0 || index + 1 >= static_cast<std::int64_t>(offsets.size())) {
+        return nullptr;
+    }
+    const Interval* begin = intervals.data() + offsets[index];
+    const Interval* end = intervals.data() + offsets[index + 1];
+    // 第一个low大于pos的区间的前一个
+    const Interval* next = std::upper_bound(
+        begin, end, pos, [](const int value, const Interval& interval) { return value < interval.low; });
+    if (next == begin || (next - 1)->high < pos) {
+        return nullptr;
+    }
+    return next - 1;
+}
+
+bool Geofence::Contains(const GridPoint& point) const noexcept
+{
+    if (rectangle) {
+        return point.x >= xRange.low && point.x <= xRange.high && point.y >= yRange.low && point.y <= yRange.high;
+    }
+    return rows.Find(point.y, point.x) != nullptr;
+}
+
+std::uint64_t Geofence::StepsInside(const GridPoint& from, const int dirX, const int dirY,
+                                    const std::uint64_t steps) const noexcept
+{
+    // 围栏内的格点在一行(列)上是若干连续区间，只要找到from所在的区间
+    const bool horizontal = dirX != 0;
+    Interval span{};
+    if (rectangle) {
+        if (!Contains(from)) {
+            return 0;
+        }
+        span = horizontal ? xRange : yRange;
+    } else {
+        const Interval* found = horizontal ? rows.Find(from.y, from.x) : columns.Find(from.x, from.y);
+        if (found == nullptr) {
+            return 0;
+        }
+        span = *found;
+    }
+
+    const int pos = horizontal ? from.x : from.y;
+    const int dir = horizontal ? dirX : dirY;
+    if (dir == 0) {
+        return steps;
+    }
+    const std::uint64_t room = static_cast<std::uint64_t>(dir > 0 ? static_cast<std::int64_t>(span.high) - pos
+                                                                  : static_cast<std::int64_t>(pos) - span.low);
+    return room < steps ? room : steps;
+}
+}  // namespace adas
@@ -0,0 +1,139 @@
+#include "LazyExecutorImpl.hpp"
+#include <new>
+#include "Profiler.hpp"
+
+namespace adas
+{
+LazyExecutor* LazyExecutor::NewLazyExecutor(const Pose& pose, const CarMode& mode, const LazyOptions& options) noexcept
+{
+    return new (std::nothrow) LazyExecutorImpl(pose, mode, options);
+}
+
+LazyExecutorImpl::LazyExecutorImpl(const Pose& pose, const CarMode& mode, const LazyOptions& options) noexcept
+    : executor(pose, mode), maxPendingBytes(options.maxPendingBytes == 0 ? 1 : options.maxPendingBytes)
+{
+}
+
+LazyExecutorImpl::~LazyExecutorImpl() noexcept
+{
+    // 待执行的指令也要计入进程级计数
+    FlushPending();
+}
+
+void LazyExecutorImpl::Execute(const std::string& commands) noexcept
+{
+    if (pending.size() + commands.size() > maxPendingBytes) {
+        FlushPending();
+    }
+    if (commands.size() > maxPendingBytes) {
+        executor.Replay(commands, 1);
+        return;
+    }
+
+    try {
+        pending.append(commands);
+    } catch (const std::bad_alloc&) {
+        FlushPending();
+        executor.Replay(commands, 1);
+        return;
+    }
+    ++pendingCalls;
+    // TR只在同一次Execute内配对：末尾的T本来就是未知字符，换掉以免与下一次开头的R配对
+    if (!pending.empty() && pending.back() == 'T') {
+        pending.back() = '?';
+    }
+}
+
+std::size_t LazyExecutorImpl::ExecuteSome(ExecuteCursor& cursor, const std::size_t maxCommands) noexcept
+{
+    // 分片执行本身就是为了限制单次耗时，不再追加到日志
+    FlushPending();
+    return executor.ExecuteSome(cursor, maxCommands);
+}
+
+std::size_t LazyExecutorImpl::ExecuteWithin(const std::string& commands, const Geofence& fence) noexcept
+{
+    // 停在哪里取决于当前位置，先执行完日志
+    FlushPending();
+    return executor.ExecuteWithin(commands, fence);
+}
+
+void LazyExecutorImpl::FlushPending(void) const noexcept
+{
+    if (pendingCalls == 0) {
+        return;
+    }
+    TraceSpan span("LazyFlush", executor.GetMode().carType);
+    executor.Replay(pending, pendingCalls);
+    pending.clear();
+    pendingCalls = 0;
+}
+
+Pose LazyExecutorImpl::Query(void) const noexcept
+{
+    FlushPending();
+    return executor.GetPose();
+}
+
+CarMode LazyExecutorImpl::QueryMode(void) const noexcept
+{
+    FlushPending();
+    return executor.GetMode();
+}
+
+PublishedState LazyExecutorImpl::QueryPublished(void) const noexcept
+{
+    // 不能在其他线程执行日志，只读内部执行器已发布的状态
+    return executor.QueryPublished();
+}
+
+void LazyExecutorImpl::Reset(const Pose& pose, const CarMode& mode) noexcept
+{
+    // 与立即执行一致：Reset前追加的指令照常计数和投递事件
+    FlushPending();
+    executor.Reset(pose, mode);
+}
+
+void LazyExecutorImpl::SetListener(ExecutorListener* listener) noexcept
+{
+    // 已追加的指令的事件属于原来的监听器
+    FlushPending();
+    executor.SetListener(listener);
+}
+
+void LazyExecutorImpl::SetObstacleMap(const ObstacleMap* map) noexcept
+{
+    // 已追加的指令按追加时的地图执行
+    FlushPending();
+    executor.SetObstacleMap(map);
+}
+
+ExecutorCounters LazyExecutorImpl::QueryCounters(void) const noexcept
+{
+    FlushPending();
+    return executor.QueryCounters();
+}
+
+PathStats LazyExecutorImpl::QueryStats(void) const noexcept
+{
+    FlushPending();
+    return executor.QueryStats();
+}
+
+void LazyExecutorImpl::ResetStats(void) noexcept
+{
+    // 已追加的指令属于上一段统计
+    FlushPending();
+    executor.ResetStats();
+}
+
+void LazyExecutorImpl::Flush(void) noexcept
+{
+    FlushPending();
+}
+
+std::size_t LazyExecutorImpl::PendingBytes(void) const noexcept
+{
+    return pending.size();
+}
+}  // namespace adas
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include "ExecutorImpl.hpp"
+#include "LazyExecutor.hpp"
+
+namespace adas
+{
+// 日志就是原样拼接的指令串；查询接口是const的，执行日志的成员因此为mutable
+class LazyExecutorImpl final : public LazyExecutor
+{
+public:
+    LazyExecutorImpl(const Pose& pose, const CarMode& mode, const LazyOptions& options) noexcept;
+    ~LazyExecutorImpl() noexcept;
+
+    LazyExecutorImpl(const LazyExecutorImpl&) = delete;
+    LazyExecutorImpl& operator=(const LazyExecutorImpl&) = delete;
+
+public:
+    void Execute(const std::string& command) noexcept override;
+    std::size_t ExecuteSome(ExecuteCursor& cursor, const std::size_t maxCommands) noexcept override;
+    std::size_t ExecuteWithin(const std::string& commands, const Geofence& fence) noexcept override;
+    Pose Query(void) const noexcept override;
+    CarMode QueryMode(void) const noexcept override;
+    PublishedState QueryPublished(void) const noexcept override;
+    void Reset(const Pose& pose, const CarMode& mode = CarMode{}) noexcept override;
+    void SetListener(ExecutorListener* listener) noexcept override;
+    void SetObstacleMap(const ObstacleMap* map) noexcept override;
+    ExecutorCounters QueryCounters(void) const noexcept override;
+    PathStats QueryStats(void) const noexcept override;
+    void ResetStats(void) noexcept override;
+    void Flush(void) noexcept override;
+    std::size_t PendingBytes(void) const noexcept override;
+
+private:
+    void FlushPending(void) const noexcept;
+
+private:
+    mutable ExecutorImpl executor;
+    mutable std::string pending;
+    mutable std::uint64_t pendingCalls{0};  // 日志中合并的Execute次数
+    std::size_t maxPendingBytes;
+};
+}  // namespace adas
@@ -0,0 +1,100 @@
+#include "ObstacleMap.hpp"
+
+namespace adas
+{
+namespace
+{
+// 负坐标按算术右移向下取整到所在的块
+std::uint64_t TileKey(const std::int64_t tileX, const std::int64_t tileY) noexcept
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(tileX)) << 32) |
+           static_cast<std::uint32_t>(tileY);
+}
+
+constexpr std::int64_t BIT_MASK = ObstacleMap::TILE_SIZE - 1;
+}  // namespace
+
+void ObstacleMap::Block(const GridPoint& cell)
+{
+    const std::uint64_t key = TileKey(cell.x >> TILE_BITS, cell.y >> TILE_BITS);
+    auto found = index.find(key);
+    if (found == index.end()) {
+        tiles.emplace_back();
+        found = index.emplace(key, tiles.size() - 1).first;
+    }
+    Tile& tile = tiles[found->second];
+    tile.rows[cell.y & BIT_MASK] |= 1ull << (cell.x & BIT_MASK);
+    tile.columns[cell.x & BIT_MASK] |= 1ull << (cell.y & BIT_MASK);
+}
+
+void ObstacleMap::Unblock(const GridPoint& cell) noexcept
+{
+    // 块清空后不回收，地图很少删除障碍
+    const auto found = index.find(TileKey(cell.x >> TILE_BITS, cell.y >> TILE_BITS));
+    if (found == index.end()) {
+        return;
+    }
+    Tile& tile = tiles[found->second];
+    tile.rows[cell.y & BIT_MASK] &= ~(1ull << (cell.x & BIT_MASK));
+    tile.columns[cell.x & BIT_MASK] &= ~(1ull << (cell.y & BIT_MASK));
+}
+
+bool ObstacleMap::Blocked(const GridPoint& cell) const noexcept
+{
+    const Tile* tile = Find(cell.x >> TILE_BITS, cell.y >> TILE_BITS);
+    return tile != nullptr && ((tile->rows[cell.y & BIT_MASK] >> (cell.x & BIT_MASK)) & 1) != 0;
+}
+
+const ObstacleMap::Tile* ObstacleMap::Find(const std::int64_t tileX, const std::int64_t tileY) const noexcept
+{
+    const auto found = index.find(TileKey(tileX, tileY));
+    return found == index.end() ? nullptr : &tiles[found->second];
+}
+
+std::uint64_t ObstacleMap::FreeSteps(const GridPoint& from, const int dirX, const int dirY,
+                                     const std::uint64_t steps) const noexcept
+{
+    if (tiles.empty() || (dirX == 0 && dirY == 0)) {
+        return steps;
+    }
+    const std::uint64_t hit =
+        dirX != 0 ? Scan(true, from.y, from.x, dirX, steps) : Scan(false, from.x, from.y, dirY, steps);
+    return hit - 1;
+}
+
+std::uint64_t ObstacleMap::Scan(const bool horizontal, const std::int64_t line, const std::int64_t pos, const int dir,
+                                const std::uint64_t steps) const noexcept
+{
+    const std::int64_t lineTile = line >> TILE_BITS;
+    const std::int64_t lineBit = line & BIT_MASK;
+    std::uint64_t done = 0;
+    while (done < steps) {
+        // 下一个待查的格子，以及本块内沿dir方向还剩的格数
+        const std::int64_t next = pos + dir * static_cast<std::int64_t>(done + 1);
+        const unsigned bit = static_cast<unsigned>(next & BIT_MASK);
+        const std::uint64_t left = dir > 0 ? TILE_SIZE - bit : bit + 1;
+        const std::uint64_t count = left < steps - done ? left : steps - done;
+        const Tile* tile = horizontal ? Find(next >> TILE_BITS, lineTile) : Find(lineTile, next >> TILE_BITS);
+        if (tile != nullptr) {
+            const std::uint64_t word = horizontal ? tile->rows[lineBit] : tile->columns[lineBit];
+            if (dir > 0) {
+                // 第bit位移到最低位，保留count位
+                std::uint64_t bits = word >> bit;
+                bits &= count < TILE_SIZE ? (1ull << count) - 1 : ~0ull;
+                if (bits != 0) {
+                    return done + 1 + static_cast<std::uint64_t>(__builtin_ctzll(bits));
+                }
+            } else {
+                // 第bit位移到最高位，保留count位
+                std::uint64_t bits = word << (TILE_SIZE - 1 - bit);
+                bits &= count < TILE_SIZE ? ~(~0ull >> count) : ~0ull;
+                if (bits != 0) {
+                    return done + 1 + static_cast<std::uint64_t>(__builtin_clzll(bits));
+                }
+            }
+        }
+        done += count;
+    }
+    return steps + 1;
+}
+}  // namespace adas
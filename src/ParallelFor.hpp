@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace adas
+{
+// threads为0时取硬件线程数
+inline unsigned ResolveThreads(const unsigned threads) noexcept
+{
+    if (threads != 0) {
+        return threads;
+    }
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+// 把[0, count)分给多个线程，按下标动态领取；body(index)必须可并发调用。
+// 只有一个线程或一个任务时直接在调用线程执行。创建线程失败时由已有线程做完全部任务、等它们结束，
+// 再抛出std::system_error
+template <typename Body>
+void ParallelFor(const std::size_t count, const unsigned threads, Body body)
+{
+    const std::size_t workers = std::min<std::size_t>(ResolveThreads(threads), count);
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto work = [&next, &body, count] {
+        for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            body(i);
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    try {
+        for (std::size_t i = 1; i < workers; ++i) {
+            pool.emplace_back(work);
+        }
+    } catch (const std::system_error&) {
+        // 已启动的线程引用着本帧的next和body，必须等它们结束才能离开
+        work();
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        throw;
+    }
+    work();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+}  // namespace adas
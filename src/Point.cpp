@@ -23,14 +23,4 @@ Point& Point::operator+=(const Point& rhs) noexcept
     y += rhs.y;
     return *this;
 }
-
-int Point::GetX(void) const noexcept
-{
-    return x;
-}
-
-int Point::GetY(void) const noexcept
-{
-    return y;
-}
 } // namespace adas
\ No newline at end of file
@@ -10,8 +10,15 @@ public:
     Point& operator+=(const Point& rhs) noexcept;
 
 public:
-    int GetX(void) const noexcept;
-    int GetY(void) const noexcept;
+    // 查询热路径上的访问器内联定义，避免跨编译单元调用
+    int GetX(void) const noexcept
+    {
+        return x;
+    }
+    int GetY(void) const noexcept
+    {
+        return y;
+    }
 
 private:
     int x;
@@ -2,14 +2,15 @@
 
 namespace adas
 {
-PoseHandler::PoseHandler(const Pose& pose) noexcept
-    : point(pose.x, pose.y), facing(&Direction::GetDirection(pose.heading))
+PoseHandler::PoseHandler(const Pose& pose, const bool fast, const bool reverse) noexcept
+    : point(pose.x, pose.y), facing(&Direction::GetDirection(pose.heading)), fast(fast), reverse(reverse)
 {
 }
 
 void PoseHandler::Move() noexcept
 {
     point += facing->Move();
+    ++steps;
 }
 
 void PoseHandler::TurnLeft() noexcept
@@ -27,29 +28,24 @@ void PoseHandler::Fast() noexcept
     fast = !fast;
 }
 
-bool PoseHandler::IsFast() const noexcept
-{
-    return fast;
-}
-
 void PoseHandler::Reverse() noexcept
 {
     reverse = !reverse;
 }
 
-bool PoseHandler::IsReverse() const noexcept
-{
-    return reverse;
-}
-
 void PoseHandler::MoveBackward() noexcept
 {
     point += facing->Backward();
+    ++steps;
 }
 
-Pose PoseHandler::Query() const noexcept
+void PoseHandler::Reset(const Pose& pose, const bool fast, const bool reverse) noexcept
 {
-    return Pose{point.GetX(), point.GetY(), facing->GetHeading()};
+    point = Point(pose.x, pose.y);
+    facing = &Direction::GetDirection(pose.heading);
+    this->fast = fast;
+    this->reverse = reverse;
+    steps = 0;
 }
 
 } // namespace adas
\ No newline at end of file
@@ -2,13 +2,14 @@
 #include "Executor.hpp"
 #include "Direction.hpp"
 #include "Point.hpp"
+#include <cstdint>
 
 namespace adas
 {
 class PoseHandler final
 {
 public:
-    PoseHandler(const Pose& pose) noexcept;
+    PoseHandler(const Pose& pose, const bool fast = false, const bool reverse = false) noexcept;
     PoseHandler(const PoseHandler&) = delete;
     PoseHandler& operator=(const PoseHandler&) = delete;
 
@@ -17,16 +18,32 @@ public:
     void TurnLeft(void) noexcept;
     void TurnRight(void) noexcept;
     void Fast(void) noexcept;
-    bool IsFast(void) const noexcept;
+    bool IsFast(void) const noexcept
+    {
+        return fast;
+    }
     void Reverse(void) noexcept;
-    bool IsReverse(void) const noexcept;
+    bool IsReverse(void) const noexcept
+    {
+        return reverse;
+    }
     void MoveBackward() noexcept;
-    Pose Query(void) const noexcept;
+    Pose Query(void) const noexcept
+    {
+        return Pose{point.GetX(), point.GetY(), facing->GetHeading()};
+    }
+    void Reset(const Pose& pose, const bool fast = false, const bool reverse = false) noexcept;
+    // 累计移动格数(含后退)
+    std::uint64_t GetSteps(void) const noexcept
+    {
+        return steps;
+    }
 
 private:
     Point point;
     const Direction* facing;
     bool fast{false};
     bool reverse{false};
+    std::uint64_t steps{0};
 };
 } // namespace adas
\ No newline at end of file
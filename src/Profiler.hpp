@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "ExecutorProfiler.hpp"
+
+namespace adas
+{
+extern std::atomic<unsigned> activeProfilingMode;
+
+inline unsigned ActiveProfilingMode(void) noexcept
+{
+    return activeProfilingMode.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ProfileClock(void) noexcept;
+void FinishExecuteProfile(const unsigned mode, const CarType carType, const std::uint64_t start) noexcept;
+void RecordTraceSpan(const char* name, const CarType carType, const std::uint64_t start) noexcept;
+
+// 覆盖一次Execute：按开始时的车型记录耗时，并可选地记录trace区间
+class ExecuteProfile final
+{
+public:
+    explicit ExecuteProfile(const CarType carType) noexcept : mode(ActiveProfilingMode()), carType(carType)
+    {
+        if (mode != PROFILE_NONE) {
+            start = ProfileClock();
+        }
+    }
+    ~ExecuteProfile() noexcept
+    {
+        if (mode != PROFILE_NONE) {
+            FinishExecuteProfile(mode, carType, start);
+        }
+    }
+
+    ExecuteProfile(const ExecuteProfile&) = delete;
+    ExecuteProfile& operator=(const ExecuteProfile&) = delete;
+
+private:
+    unsigned mode;
+    CarType carType;
+    std::uint64_t start{0};
+};
+
+// 只记录trace的区间，用于命令表重建、车型切换等
+class TraceSpan final
+{
+public:
+    TraceSpan(const char* name, const CarType carType) noexcept
+        : name((ActiveProfilingMode() & PROFILE_TRACE) != 0 ? name : nullptr), carType(carType)
+    {
+        if (this->name != nullptr) {
+            start = ProfileClock();
+        }
+    }
+    ~TraceSpan() noexcept
+    {
+        if (name != nullptr) {
+            RecordTraceSpan(name, carType, start);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;  // 未开启trace时为空
+    CarType carType;
+    std::uint64_t start{0};
+};
+}  // namespace adas
@@ -0,0 +1,125 @@
+#include "ReferenceExecutor.hpp"
+
+namespace adas
+{
+namespace
+{
+constexpr char HEADINGS[] = {'E', 'S', 'W', 'N'};
+constexpr int DX[] = {1, 0, -1, 0};
+constexpr int DY[] = {0, -1, 0, 1};
+
+unsigned HeadingIndex(const char heading) noexcept
+{
+    for (unsigned i = 0; i < 4; ++i) {
+        if (HEADINGS[i] == heading) {
+            return i;
+        }
+    }
+    return 3;  // 非法朝向按N处理
+}
+}  // namespace
+
+ReferenceExecutor::ReferenceExecutor(const Pose& pose, const CarMode& mode) noexcept
+    : x(pose.x), y(pose.y), heading(HeadingIndex(pose.heading)), mode(mode)
+{
+}
+
+void ReferenceExecutor::Step(const int count) noexcept
+{
+    // 倒车时沿朝向反方向移动
+    const int sign = mode.reverse ? -1 : 1;
+    x += DX[heading] * count * sign;
+    y += DY[heading] * count * sign;
+}
+
+void ReferenceExecutor::Turn(const bool left) noexcept
+{
+    heading = (heading + (left ? 3 : 1)) % 4;
+}
+
+void ReferenceExecutor::TurnCommand(const bool left) noexcept
+{
+    // 倒车时左右互换
+    const bool turnLeft = mode.reverse ? !left : left;
+    switch (mode.carType) {
+    case CarType::SPORTS:
+        Step(mode.fast ? 1 : 0);
+        Turn(turnLeft);
+        Step(1);
+        break;
+    case CarType::BUS:
+        Step(mode.fast ? 2 : 1);
+        Turn(turnLeft);
+        break;
+    default:
+        Step(mode.fast ? 1 : 0);
+        Turn(turnLeft);
+        break;
+    }
+}
+
+void ReferenceExecutor::SwitchTo(const CarType type) noexcept
+{
+    mode = CarMode{type, false, false};
+}
+
+void ReferenceExecutor::Execute(const std::string& commands) noexcept
+{
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        switch (commands[i]) {
+        case 'M':
+            Step(mode.carType == CarType::SPORTS ? (mode.fast ? 4 : 2) : (mode.fast ? 2 : 1));
+            break;
+        case 'L':
+            TurnCommand(true);
+            break;
+        case 'R':
+            TurnCommand(false);
+            break;
+        case 'F':
+            mode.fast = !mode.fast;
+            break;
+        case 'B':
+            mode.reverse = !mode.reverse;
+            break;
+        case 'N':
+            // Bus不能切换到跑车
+            if (mode.carType != CarType::BUS) {
+                SwitchTo(mode.carType == CarType::NORMAL ? CarType::SPORTS : CarType::NORMAL);
+            }
+            break;
+        case 'U':
+            SwitchTo(mode.carType == CarType::BUS ? CarType::NORMAL : CarType::BUS);
+            break;
+        case 'T':
+            if (i + 1 >= commands.size() || commands[i + 1] != 'R') {
+                break;  // 单独的T是未知字符
+            }
+            ++i;
+            // 所有车型都按普通车掉头，倒车时忽略；加速时每步都先前进一格
+            if (mode.reverse) {
+                break;
+            }
+            if (mode.fast) {
+                Step(1);
+            }
+            Turn(true);
+            Step(1);
+            Turn(true);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+Pose ReferenceExecutor::Query(void) const noexcept
+{
+    return Pose{x, y, HEADINGS[heading]};
+}
+
+CarMode ReferenceExecutor::QueryMode(void) const noexcept
+{
+    return mode;
+}
+}  // namespace adas
@@ -0,0 +1,136 @@
+#include "RoundRobinScheduler.hpp"
+#include <new>
+
+namespace adas
+{
+RoundRobinScheduler::RoundRobinScheduler(const std::size_t quantum) noexcept : quantum(quantum == 0 ? 1 : quantum)
+{
+}
+
+bool RoundRobinScheduler::Submit(Executor& executor, std::string commands) noexcept
+{
+    try {
+        auto found = laneOf.find(&executor);
+        if (found == laneOf.end()) {
+            if (freeLanes.empty()) {
+                freeLanes.reserve(lanes.size() + 1);
+                lanes.push_back(Lane{nullptr, {}, 0});
+                freeLanes.push_back(lanes.size() - 1);
+            }
+            // 之后入队失败时lane留在laneOf中，没有任务也不在active中，下次提交或Remove时处理
+            found = laneOf.emplace(&executor, freeLanes.back()).first;
+            freeLanes.pop_back();
+            lanes[found->second].executor = &executor;
+        }
+        Lane& lane = lanes[found->second];
+        if (lane.tasks.empty()) {
+            // 先预留active的位置，失败时不留下半入队的任务
+            active.reserve(active.size() + 1);
+            lane.tasks.push_back(std::move(commands));
+            active.push_back(found->second);
+        } else {
+            lane.tasks.push_back(std::move(commands));
+        }
+        return true;
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+}
+
+std::size_t RoundRobinScheduler::RunSlice(void) noexcept
+{
+    const std::size_t index = active[next];
+    Lane& lane = lanes[index];
+    ExecuteCursor cursor(lane.tasks.front());
+    cursor.offset = lane.offset;
+    const std::size_t executed = lane.executor->ExecuteSome(cursor, quantum);
+    lane.offset = cursor.offset;
+    if (cursor.Done()) {
+        lane.tasks.pop_front();
+        lane.offset = 0;
+    }
+
+    if (lane.tasks.empty()) {
+        Deactivate(next);
+        ReleaseLane(index);
+    } else if (++next >= active.size()) {
+        next = 0;
+    }
+    return executed;
+}
+
+void RoundRobinScheduler::Deactivate(const std::size_t position) noexcept
+{
+    // 用末尾的lane填补空位，它在本轮稍后仍会轮到
+    active[position] = active.back();
+    active.pop_back();
+    if (next >= active.size()) {
+        next = 0;
+    }
+}
+
+void RoundRobinScheduler::ReleaseLane(const std::size_t index) noexcept
+{
+    Lane& lane = lanes[index];
+    laneOf.erase(lane.executor);
+    lane.executor = nullptr;
+    lane.tasks.clear();
+    lane.offset = 0;
+    freeLanes.push_back(index);
+}
+
+std::size_t RoundRobinScheduler::Remove(Executor& executor) noexcept
+{
+    const auto found = laneOf.find(&executor);
+    if (found == laneOf.end()) {
+        return 0;
+    }
+    const std::size_t index = found->second;
+    const std::size_t dropped = lanes[index].tasks.size();
+    for (std::size_t position = 0; position < active.size(); ++position) {
+        if (active[position] == index) {
+            Deactivate(position);
+            break;
+        }
+    }
+    ReleaseLane(index);
+    return dropped;
+}
+
+std::size_t RoundRobinScheduler::RunRound(void) noexcept
+{
+    std::size_t executed = 0;
+    for (std::size_t slices = active.size(); slices > 0 && !active.empty(); --slices) {
+        executed += RunSlice();
+    }
+    return executed;
+}
+
+std::size_t RoundRobinScheduler::RunUntil(const std::chrono::steady_clock::time_point deadline) noexcept
+{
+    std::size_t executed = 0;
+    while (!active.empty() && std::chrono::steady_clock::now() < deadline) {
+        executed += RunSlice();
+    }
+    return executed;
+}
+
+std::size_t RoundRobinScheduler::RunAll(void) noexcept
+{
+    std::size_t executed = 0;
+    while (!active.empty()) {
+        executed += RunSlice();
+    }
+    return executed;
+}
+
+bool RoundRobinScheduler::Idle(void) const noexcept
+{
+    return active.empty();
+}
+
+std::size_t RoundRobinScheduler::ActiveExecutors(void) const noexcept
+{
+    return active.size();
+}
+}  // namespace adas
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace adas
+{
+// 单写者顺序锁，保护两个64位字。写者每次发布四次普通存储，从不等待；
+// 读者在写者发布到一半时重试，读到的两个字一定来自同一次发布
+class SeqlockPair final
+{
+public:
+    SeqlockPair(const std::uint64_t first, const std::uint64_t second) noexcept : words{{first}, {second}}
+    {
+    }
+
+    SeqlockPair(const SeqlockPair&) = delete;
+    SeqlockPair& operator=(const SeqlockPair&) = delete;
+
+public:
+    // 只能由唯一的写者调用
+    void Publish(const std::uint64_t first, const std::uint64_t second) noexcept
+    {
+        const std::uint64_t begin = sequence.load(std::memory_order_relaxed) + 1;
+        sequence.store(begin, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        words[0].store(first, std::memory_order_relaxed);
+        words[1].store(second, std::memory_order_relaxed);
+        sequence.store(begin + 1, std::memory_order_release);
+    }
+
+    // 任意线程调用，返回发布次数
+    std::uint64_t Read(std::uint64_t& first, std::uint64_t& second) const noexcept
+    {
+        for (;;) {
+            const std::uint64_t before = sequence.load(std::memory_order_acquire);
+            first = words[0].load(std::memory_order_relaxed);
+            second = words[1].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((before & 1) == 0 && sequence.load(std::memory_order_relaxed) == before) {
+                return before / 2;
+            }
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> sequence{0};  // 奇数表示写者正在发布
+    std::atomic<std::uint64_t> words[2];
+};
+}  // namespace adas
@@ -0,0 +1,100 @@
+#pragma once
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+namespace adas
+{
+// 共享内存段中的单生产者单消费者字节环。head、tail只增不减，位置对容量取模；
+// 生产者整帧写完后才前移head，消费者看到的总是完整的帧，帧可以跨过环尾回绕
+struct ShmRing
+{
+    alignas(64) std::atomic<std::uint64_t> head{0};  // 生产者写入
+    alignas(64) std::atomic<std::uint64_t> tail{0};  // 消费者写入
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ring positions must be lock-free across processes");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "futex words must be lock-free across processes");
+
+// 从环内position处(已取模)开始写入size字节，跨过环尾时分两段
+inline void RingCopyIn(char* data, const std::uint64_t capacity, const std::uint64_t position, const char* bytes,
+                       const std::size_t size) noexcept
+{
+    const std::size_t first = static_cast<std::size_t>(capacity - position) < size
+                                  ? static_cast<std::size_t>(capacity - position)
+                                  : size;
+    std::memcpy(data + position, bytes, first);
+    std::memcpy(data, bytes + first, size - first);
+}
+
+inline void RingCopyOut(const char* data, const std::uint64_t capacity, const std::uint64_t position, char* bytes,
+                        const std::size_t size) noexcept
+{
+    const std::size_t first = static_cast<std::size_t>(capacity - position) < size
+                                  ? static_cast<std::size_t>(capacity - position)
+                                  : size;
+    std::memcpy(bytes, data + position, first);
+    std::memcpy(bytes + first, data, size - first);
+}
+
+// 跨进程的futex：共享映射上不能用FUTEX_PRIVATE_FLAG。word仍等于expected时睡眠，timeoutNs为0时不超时
+inline void FutexWait(std::atomic<std::uint32_t>& word, const std::uint32_t expected,
+                      const std::uint64_t timeoutNs = 0) noexcept
+{
+    timespec timeout{static_cast<std::time_t>(timeoutNs / 1000000000), static_cast<long>(timeoutNs % 1000000000)};
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected,
+              timeoutNs == 0 ? nullptr : &timeout, nullptr, 0);
+}
+
+inline void FutexWake(std::atomic<std::uint32_t>& word) noexcept
+{
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+// 睡眠的一方先读序号、再置sleeping、最后检查条件；唤醒的一方先发布数据，看到sleeping才递增序号并唤醒。
+// 两边都用顺序一致的内存序，至少一方能看到另一方的写入，不会丢失唤醒。
+// 唤醒方用交换清掉sleeping，睡眠方被调度之前的后续提交不再重复进入系统调用
+struct ShmDoorbell
+{
+    std::atomic<std::uint32_t> sequence{0};
+    std::atomic<std::uint32_t> sleeping{0};
+
+    void Ring(void) noexcept
+    {
+        if (sleeping.load(std::memory_order_seq_cst) != 0 && sleeping.exchange(0, std::memory_order_seq_cst) != 0) {
+            sequence.fetch_add(1, std::memory_order_seq_cst);
+            FutexWake(sequence);
+        }
+    }
+};
+
+enum ShmSlotState : std::uint32_t {
+    SLOT_FREE = 0,
+    SLOT_ATTACHED = 1,  // 客户端占用
+    SLOT_DETACHED = 2,  // 客户端已断开，等服务端清空环后置为空闲
+};
+
+// 共享内存段的开头，之后依次是各槽位；magic最后写入，客户端看到它时其余字段已初始化
+struct ShmSegment
+{
+    std::atomic<std::uint64_t> magic{0};
+    std::uint32_t version{0};
+    std::uint32_t slots{0};
+    std::uint64_t ringBytes{0};
+    alignas(64) ShmDoorbell server{};  // 客户端提交请求后唤醒服务端
+};
+
+// 槽位头之后是请求环和应答环的数据区，各ringBytes字节
+struct ShmSlot
+{
+    alignas(64) std::atomic<std::uint32_t> state{SLOT_FREE};
+    ShmDoorbell client{};  // 服务端写入应答后唤醒客户端
+    ShmRing requests{};
+    ShmRing responses{};
+};
+}  // namespace adas
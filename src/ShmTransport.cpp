@@ -0,0 +1,402 @@
+#include "ShmTransport.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <chrono>
+#include <new>
+#include <thread>
+#include "FrameHandler.hpp"
+#include "ShmRing.hpp"
+
+namespace adas
+{
+namespace
+{
+constexpr std::uint64_t MAGIC = 0x6D68735F73646161ull;
+constexpr std::uint32_t VERSION = 1;
+// 每次Poll每个槽位最多处理的帧数，避免一个客户端占住消费循环
+constexpr std::size_t SLOT_BATCH = 256;
+// 睡眠前再尝试的轮数，短暂的空闲不进入futex。单核上对方只有在本线程让出CPU后才能运行，不自旋
+unsigned SpinRounds(void) noexcept
+{
+    static const unsigned rounds = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+    return rounds;
+}
+
+constexpr std::size_t Align64(const std::size_t size) noexcept
+{
+    return (size + 63) & ~std::size_t{63};
+}
+
+std::uint64_t RoundRingBytes(const std::size_t requested) noexcept
+{
+    std::uint64_t bytes = 64;
+    while (bytes < requested) {
+        bytes *= 2;
+    }
+    return bytes;
+}
+
+std::size_t SlotBytes(const std::uint64_t ringBytes) noexcept
+{
+    return Align64(sizeof(ShmSlot)) + static_cast<std::size_t>(2 * ringBytes);
+}
+
+std::size_t SegmentBytes(const std::uint32_t slots, const std::uint64_t ringBytes) noexcept
+{
+    return Align64(sizeof(ShmSegment)) + slots * SlotBytes(ringBytes);
+}
+
+ShmSlot* SlotOf(ShmSegment* segment, const unsigned index) noexcept
+{
+    return reinterpret_cast<ShmSlot*>(reinterpret_cast<char*>(segment) + Align64(sizeof(ShmSegment)) +
+                                      index * SlotBytes(segment->ringBytes));
+}
+
+char* RequestData(ShmSlot* slot) noexcept
+{
+    return reinterpret_cast<char*>(slot) + Align64(sizeof(ShmSlot));
+}
+
+char* ResponseData(ShmSlot* slot, const std::uint64_t ringBytes) noexcept
+{
+    return RequestData(slot) + ringBytes;
+}
+
+std::uint64_t NowNs(void) noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+}  // namespace
+
+ShmCommandServer::ShmCommandServer(const std::string& name, const ShmTransportOptions& options) noexcept
+    : name(name), options(options)
+{
+}
+
+ShmCommandServer::~ShmCommandServer() noexcept
+{
+    if (segment != nullptr) {
+        ::munmap(segment, size);
+        ::shm_unlink(name.c_str());
+    }
+}
+
+bool ShmCommandServer::Create(void) noexcept
+{
+    const std::uint64_t ringBytes = RoundRingBytes(options.ringBytes);
+    try {
+        handler.reset(new FrameHandler());
+        scratch.resize(static_cast<std::size_t>(ringBytes));
+        attached.assign(options.slots, false);
+    } catch (const std::bad_alloc&) {
+        errno = ENOMEM;
+        return false;
+    }
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    size = SegmentBytes(options.slots, ringBytes);
+    void* base = ::ftruncate(fd, static_cast<off_t>(size)) == 0
+                     ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                     : MAP_FAILED;
+    const int error = errno;
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        errno = error;
+        return false;
+    }
+
+    segment = new (base) ShmSegment();
+    segment->version = VERSION;
+    segment->slots = options.slots;
+    segment->ringBytes = ringBytes;
+    for (unsigned i = 0; i < options.slots; ++i) {
+        new (SlotOf(segment, i)) ShmSlot();
+    }
+    segment->magic.store(MAGIC, std::memory_order_release);
+    return true;
+}
+
+std::size_t ShmCommandServer::Vehicles(void) const noexcept
+{
+    return handler == nullptr ? 0 : handler->Vehicles();
+}
+
+ShmSlot& ShmCommandServer::SlotAt(const unsigned index) const noexcept
+{
+    return *SlotOf(segment, index);
+}
+
+std::size_t ShmCommandServer::Poll(void) noexcept
+{
+    std::size_t frames = 0;
+    for (unsigned i = 0; i < options.slots; ++i) {
+        frames += PollSlot(i);
+    }
+    return frames;
+}
+
+std::size_t ShmCommandServer::PollSlot(const unsigned index) noexcept
+{
+    ShmSlot& slot = SlotAt(index);
+    const std::uint32_t state = slot.state.load(std::memory_order_acquire);
+    if (state == SLOT_DETACHED) {
+        // 只有服务端写这些字段，清空后再放出槽位，下一个客户端看到的是空环
+        slot.requests.head.store(0, std::memory_order_relaxed);
+        slot.requests.tail.store(0, std::memory_order_relaxed);
+        slot.responses.head.store(0, std::memory_order_relaxed);
+        slot.responses.tail.store(0, std::memory_order_relaxed);
+        slot.client.sequence.store(0, std::memory_order_relaxed);
+        slot.client.sleeping.store(0, std::memory_order_relaxed);
+        slot.state.store(SLOT_FREE, std::memory_order_release);
+        if (attached[index]) {
+            attached[index] = false;
+            ++stats.closed;
+        }
+        return 0;
+    }
+    if (state != SLOT_ATTACHED) {
+        return 0;
+    }
+    if (!attached[index]) {
+        attached[index] = true;
+        ++stats.accepted;
+    }
+
+    const std::uint64_t capacity = segment->ringBytes;
+    const std::uint64_t mask = capacity - 1;
+    const char* requests = RequestData(&slot);
+    char* responses = ResponseData(&slot, capacity);
+    const std::uint64_t requestHead = slot.requests.head.load(std::memory_order_seq_cst);
+    std::uint64_t requestTail = slot.requests.tail.load(std::memory_order_relaxed);
+    std::uint64_t responseHead = slot.responses.head.load(std::memory_order_relaxed);
+    const std::uint64_t responseTail = slot.responses.tail.load(std::memory_order_acquire);
+
+    if (requestHead - requestTail > capacity) {
+        // head由客户端写入，不可信：超出环容量说明环已损坏，丢弃其中全部字节
+        requestTail = requestHead;
+        ++stats.badFrames;
+    }
+
+    // 应答环的tail同样由客户端写入，超出容量时视为已满，不再向其中写入
+    std::size_t frames = 0;
+    while (frames < SLOT_BATCH && requestHead - requestTail >= sizeof(RequestHeader) &&
+           responseHead - responseTail <= capacity - sizeof(Response)) {
+        RequestHeader header;
+        RingCopyOut(requests, capacity, requestTail & mask, reinterpret_cast<char*>(&header), sizeof(header));
+        const std::uint64_t total = sizeof(header) + static_cast<std::uint64_t>(header.length);
+        if (header.length > MAX_FRAME_PAYLOAD || total > capacity || total > requestHead - requestTail) {
+            // 客户端库只发布完整且不超过环容量的帧，否则说明环已损坏，丢弃其中剩余的字节。
+            // 帧不超过环容量，跨过环尾的负载才放得进scratch
+            requestTail = requestHead;
+            ++stats.badFrames;
+            break;
+        }
+        const std::uint64_t position = (requestTail + sizeof(header)) & mask;
+        const char* payload = requests + position;
+        if (position + header.length > capacity) {
+            RingCopyOut(requests, capacity, position, scratch.data(), header.length);
+            payload = scratch.data();
+        }
+        Response response{};
+        handler->Handle(header, payload, response, stats);
+        RingCopyIn(responses, capacity, responseHead & mask, reinterpret_cast<const char*>(&response),
+                   sizeof(response));
+        responseHead += sizeof(response);
+        requestTail += total;
+        ++frames;
+    }
+    if (requestTail != slot.requests.tail.load(std::memory_order_relaxed)) {
+        slot.requests.tail.store(requestTail, std::memory_order_release);
+    }
+    if (frames != 0) {
+        slot.responses.head.store(responseHead, std::memory_order_seq_cst);
+        slot.client.Ring();
+    }
+    return frames;
+}
+
+void ShmCommandServer::Run(void) noexcept
+{
+    while (!stopping.load(std::memory_order_acquire)) {
+        bool busy = false;
+        for (unsigned round = 0; round < SpinRounds() && !busy; ++round) {
+            busy = Poll() != 0;
+        }
+        if (busy) {
+            continue;
+        }
+        // 先读序号再声明睡眠，之后到达的请求要么被这次Poll看到，要么让序号变化使FutexWait立即返回
+        const std::uint32_t sequence = segment->server.sequence.load(std::memory_order_seq_cst);
+        segment->server.sleeping.store(1, std::memory_order_seq_cst);
+        if (Poll() == 0 && !stopping.load(std::memory_order_acquire)) {
+            FutexWait(segment->server.sequence, sequence);
+        }
+        segment->server.sleeping.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ShmCommandServer::Stop(void) noexcept
+{
+    stopping.store(true, std::memory_order_release);
+    if (segment != nullptr) {
+        segment->server.sequence.fetch_add(1, std::memory_order_seq_cst);
+        FutexWake(segment->server.sequence);
+    }
+}
+
+ShmCommandClient::~ShmCommandClient() noexcept
+{
+    Detach();
+}
+
+bool ShmCommandClient::Attach(const std::string& name) noexcept
+{
+    Detach();
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status;
+    void* base = MAP_FAILED;
+    if (::fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(ShmSegment)) {
+        size = static_cast<std::size_t>(status.st_size);
+        base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    } else {
+        errno = EPROTO;
+    }
+    const int error = errno;
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        errno = error;
+        return false;
+    }
+
+    segment = static_cast<ShmSegment*>(base);
+    if (segment->magic.load(std::memory_order_acquire) != MAGIC || segment->version != VERSION ||
+        SegmentBytes(segment->slots, segment->ringBytes) != size) {
+        ::munmap(base, size);
+        segment = nullptr;
+        errno = EPROTO;
+        return false;
+    }
+    for (unsigned i = 0; i < segment->slots; ++i) {
+        ShmSlot* candidate = SlotOf(segment, i);
+        std::uint32_t expected = SLOT_FREE;
+        if (candidate->state.compare_exchange_strong(expected, SLOT_ATTACHED, std::memory_order_acq_rel)) {
+            slot = candidate;
+            capacity = segment->ringBytes;
+            requestData = RequestData(slot);
+            responseData = ResponseData(slot, capacity);
+            return true;
+        }
+    }
+    ::munmap(base, size);
+    segment = nullptr;
+    errno = EBUSY;
+    return false;
+}
+
+void ShmCommandClient::Detach(void) noexcept
+{
+    if (segment == nullptr) {
+        return;
+    }
+    if (slot != nullptr) {
+        slot->state.store(SLOT_DETACHED, std::memory_order_release);
+        segment->server.Ring();
+    }
+    ::munmap(segment, size);
+    segment = nullptr;
+    slot = nullptr;
+}
+
+bool ShmCommandClient::Submit(const FrameType type, const std::uint64_t vehicle, const std::uint64_t tag,
+                              const char* payload, const std::size_t length) noexcept
+{
+    const std::uint64_t total = sizeof(RequestHeader) + static_cast<std::uint64_t>(length);
+    if (slot == nullptr || length > MAX_FRAME_PAYLOAD || total > capacity) {
+        return false;
+    }
+    const std::uint64_t head = slot->requests.head.load(std::memory_order_relaxed);
+    if (capacity - (head - slot->requests.tail.load(std::memory_order_acquire)) < total) {
+        return false;
+    }
+    const RequestHeader header{static_cast<std::uint32_t>(length), static_cast<std::uint16_t>(type), 0, vehicle, tag};
+    const std::uint64_t mask = capacity - 1;
+    RingCopyIn(requestData, capacity, head & mask, reinterpret_cast<const char*>(&header), sizeof(header));
+    if (length != 0) {
+        RingCopyIn(requestData, capacity, (head + sizeof(header)) & mask, payload, length);
+    }
+    slot->requests.head.store(head + total, std::memory_order_seq_cst);
+    segment->server.Ring();
+    return true;
+}
+
+bool ShmCommandClient::SubmitExecute(const std::uint64_t vehicle, const std::uint64_t tag,
+                                     const std::string& commands) noexcept
+{
+    return Submit(FrameType::EXECUTE, vehicle, tag, commands.data(), commands.size());
+}
+
+bool ShmCommandClient::SubmitReset(const std::uint64_t vehicle, const std::uint64_t tag, const Pose& pose,
+                                   const CarMode& mode) noexcept
+{
+    const ResetPayload payload{pose.x,
+                               pose.y,
+                               pose.heading,
+                               static_cast<std::uint8_t>(mode.carType),
+                               static_cast<std::uint8_t>(mode.fast),
+                               static_cast<std::uint8_t>(mode.reverse)};
+    return Submit(FrameType::RESET, vehicle, tag, reinterpret_cast<const char*>(&payload), sizeof(payload));
+}
+
+std::size_t ShmCommandClient::Take(Response* responses, const std::size_t max) noexcept
+{
+    const std::uint64_t head = slot->responses.head.load(std::memory_order_seq_cst);
+    const std::uint64_t tail = slot->responses.tail.load(std::memory_order_relaxed);
+    std::size_t count = static_cast<std::size_t>((head - tail) / sizeof(Response));
+    count = count < max ? count : max;
+    if (count != 0) {
+        RingCopyOut(responseData, capacity, tail & (capacity - 1), reinterpret_cast<char*>(responses),
+                    count * sizeof(Response));
+        slot->responses.tail.store(tail + count * sizeof(Response), std::memory_order_release);
+    }
+    return count;
+}
+
+std::size_t ShmCommandClient::Receive(Response* responses, const std::size_t max,
+                                      const std::uint64_t timeoutNs) noexcept
+{
+    if (slot == nullptr || max == 0) {
+        return 0;
+    }
+    std::size_t count = Take(responses, max);
+    for (unsigned round = 0; count == 0 && timeoutNs != 0 && round < SpinRounds(); ++round) {
+        count = Take(responses, max);
+    }
+    if (count != 0 || timeoutNs == 0) {
+        return count;
+    }
+    const std::uint64_t deadline = NowNs() + timeoutNs;
+    for (;;) {
+        const std::uint32_t sequence = slot->client.sequence.load(std::memory_order_seq_cst);
+        slot->client.sleeping.store(1, std::memory_order_seq_cst);
+        count = Take(responses, max);
+        const std::uint64_t now = NowNs();
+        if (count != 0 || now >= deadline) {
+            slot->client.sleeping.store(0, std::memory_order_relaxed);
+            return count;
+        }
+        FutexWait(slot->client.sequence, sequence, deadline - now);
+        slot->client.sleeping.store(0, std::memory_order_relaxed);
+    }
+}
+}  // namespace adas
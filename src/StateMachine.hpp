@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "StateMachineEvaluator.hpp"
+#include "VehicleTable.hpp"
+
+namespace adas
+{
+// 分类后TR记在T的位置，R的位置记为空操作
+constexpr unsigned CLASS_NOP = CLASS_COUNT;
+constexpr unsigned FSM_CLASSES = CLASS_COUNT + 1;
+constexpr std::size_t FSM_BLOCK = 64;
+
+// 只对当前线程生效的实现选择，优先于SetEvaluatorIsa，析构时恢复。
+// 差分校验用它在多个线程上同时校验不同的实现，不影响其他线程
+class ThreadEvaluatorIsa final
+{
+public:
+    explicit ThreadEvaluatorIsa(const EvaluatorIsa isa) noexcept;
+    ~ThreadEvaluatorIsa() noexcept;
+
+    ThreadEvaluatorIsa(const ThreadEvaluatorIsa&) = delete;
+    ThreadEvaluatorIsa& operator=(const ThreadEvaluatorIsa&) = delete;
+
+private:
+    unsigned char saved;
+};
+
+// 某车型的成对转移表，首次使用时由VehicleTable生成，之后一直有效
+struct FsmTables;
+
+const FsmTables& FsmTablesOf(const CarType carType) noexcept;
+
+// 把data[pos, pos + length)分类写入classes，length不超过FSM_BLOCK；
+// 返回N/U所在位置的位图，T是否与R配对看整个指令串
+std::uint64_t ClassifyCommands(const EvaluatorIsa isa, const char* data, const std::size_t size, const std::size_t pos,
+                               const std::size_t length, unsigned char* classes) noexcept;
+
+// 整块都是同一类别(不含N/U)时可以用闭式结果一步折叠
+bool UniformBlock(const unsigned char* classes) noexcept;
+void FoldBlock(const FsmTables& tables, const unsigned commandClass, int& x, int& y, unsigned& state, PathBox& box,
+               std::uint64_t* counters) noexcept;
+
+// 从state出发执行classes[0, length)，其中不能有N/U；累加位移与计数，经过的格子并入box
+void EvaluateClasses(const EvaluatorIsa isa, const FsmTables& tables, const unsigned char* classes,
+                     const std::size_t length, int& x, int& y, unsigned& state, PathBox& box,
+                     std::uint64_t* counters) noexcept;
+}  // namespace adas
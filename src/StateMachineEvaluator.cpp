@@ -0,0 +1,506 @@
+#include "StateMachineEvaluator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include "ExecutorMetrics.hpp"
+#include "StateMachine.hpp"
+#include "VehicleTypes.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ADAS_FSM_X86 1
+#endif
+
+namespace adas
+{
+// 两条指令合成一项：对16个起始状态分别给出终止状态、位移、格数和忽略的TR数。
+// next两半相同，AVX2下一次pshufb同时得到dx和dy
+struct alignas(64) PairEntry
+{
+    unsigned char next[32];
+    signed char disp[32];     // 前16个为dx，后16个为dy
+    unsigned char aux[32];    // 前16个为格数，后16个为倒车时忽略的TR数
+    signed char mid[32];      // 第一条指令后的位移，与disp一起给出路径的外接矩形
+    unsigned char count[16];  // 按类别计数，与起始状态无关
+};
+
+// 同一条指令连续执行一整块(FSM_BLOCK次)的闭式结果
+struct BlockEntry
+{
+    unsigned char next[16];
+    int dx[16];
+    int dy[16];
+    PathBox box[16];  // 相对起点的外接矩形
+    unsigned steps[16];
+    unsigned ignored[16];
+};
+
+struct FsmTables
+{
+    PairEntry pairs[FSM_CLASSES * FSM_CLASSES];
+    unsigned group;                        // 8位累加不溢出的最大组长(指令对数)
+    unsigned char counterOf[FSM_CLASSES];  // 与状态无关的类别对应的计数槽位
+    BlockEntry blocks[CLASS_COUNT];
+};
+
+namespace
+{
+constexpr unsigned char UNSET_ISA = 0xFF;
+std::atomic<unsigned char> activeIsa{UNSET_ISA};
+thread_local unsigned char threadIsa = UNSET_ISA;  // ThreadEvaluatorIsa的选择
+
+const unsigned TR_IGNORED = static_cast<unsigned>(ExecutorCounter::TR_IGNORED_IN_REVERSE);
+
+void Build(const VehicleTable& table, FsmTables& tables) noexcept
+{
+    int maxDisp = 1;
+    int maxSteps = 1;
+    for (unsigned first = 0; first < FSM_CLASSES; ++first) {
+        for (unsigned second = 0; second < FSM_CLASSES; ++second) {
+            PairEntry& entry = tables.pairs[first * FSM_CLASSES + second];
+            entry = PairEntry{};
+            for (unsigned start = 0; start < VEHICLE_STATES; ++start) {
+                unsigned state = start;
+                int dx = 0;
+                int dy = 0;
+                int steps = 0;
+                int ignored = 0;
+                int midX = 0;
+                int midY = 0;
+                for (const unsigned commandClass : {first, second}) {
+                    // 循环结束时为第二条指令之前的位移
+                    midX = dx;
+                    midY = dy;
+                    if (commandClass == CLASS_NOP) {
+                        continue;
+                    }
+                    const Transition& transition = table[state][commandClass];
+                    dx += transition.dx;
+                    dy += transition.dy;
+                    steps += transition.steps;
+                    ignored += transition.counter == TR_IGNORED ? 1 : 0;
+                    state = transition.next;
+                }
+                entry.next[start] = entry.next[start + 16] = static_cast<unsigned char>(state);
+                entry.disp[start] = static_cast<signed char>(dx);
+                entry.disp[start + 16] = static_cast<signed char>(dy);
+                entry.aux[start] = static_cast<unsigned char>(steps);
+                entry.aux[start + 16] = static_cast<unsigned char>(ignored);
+                entry.mid[start] = static_cast<signed char>(midX);
+                entry.mid[start + 16] = static_cast<signed char>(midY);
+                maxDisp = std::max({maxDisp, std::abs(dx), std::abs(dy), std::abs(midX), std::abs(midY)});
+                maxSteps = std::max(maxSteps, steps);
+            }
+            ++entry.count[first];
+            ++entry.count[second];
+        }
+    }
+    // 每对最多计2条指令，组长不超过32对即一个块
+    const unsigned group = std::min({32, 127 / maxDisp, 255 / maxSteps});
+    tables.group = group == 0 ? 1 : group;
+    for (unsigned commandClass = 0; commandClass < CLASS_COUNT; ++commandClass) {
+        tables.counterOf[commandClass] = table[0][commandClass].counter;
+        BlockEntry& block = tables.blocks[commandClass];
+        block = BlockEntry{};
+        for (unsigned start = 0; start < VEHICLE_STATES; ++start) {
+            unsigned state = start;
+            for (std::size_t i = 0; i < FSM_BLOCK; ++i) {
+                const Transition& transition = table[state][commandClass];
+                block.dx[start] += transition.dx;
+                block.dy[start] += transition.dy;
+                block.box[start].Include(block.dx[start], block.dy[start]);
+                block.steps[start] += transition.steps;
+                block.ignored[start] += transition.counter == TR_IGNORED ? 1 : 0;
+                state = transition.next;
+            }
+            block.next[start] = static_cast<unsigned char>(state);
+        }
+    }
+}
+
+// 一组结束时按实际状态取出对应通道，并入执行器状态
+void Merge(const FsmTables& tables, const unsigned char* next, const signed char* disp, const signed char* low,
+           const signed char* high, const unsigned char* aux, const unsigned char* count, int& x, int& y,
+           unsigned& state, PathBox& box, std::uint64_t* counters) noexcept
+{
+    box.Include(x + low[state], x + high[state], y + low[state + 16], y + high[state + 16]);
+    x += disp[state];
+    y += disp[state + 16];
+    counters[static_cast<unsigned>(ExecutorCounter::GRID_STEPS)] += aux[state];
+    const unsigned ignored = aux[state + 16];
+    for (unsigned commandClass = 0; commandClass < CLASS_COUNT; ++commandClass) {
+        if (commandClass == CLASS_TR) {
+            counters[static_cast<unsigned>(ExecutorCounter::COMMAND_TR)] += count[commandClass] - ignored;
+            counters[TR_IGNORED] += ignored;
+        } else {
+            counters[tables.counterOf[commandClass]] += count[commandClass];
+        }
+    }
+    state = next[state];
+}
+
+unsigned PairIndex(const unsigned char* classes, const std::size_t i, const std::size_t length) noexcept
+{
+    return classes[i] * FSM_CLASSES + (i + 1 < length ? classes[i + 1] : CLASS_NOP);
+}
+
+void EvaluateScalar(const FsmTables& tables, const unsigned char* classes, const std::size_t length, int& x, int& y,
+                    unsigned& state, PathBox& box, std::uint64_t* counters) noexcept
+{
+    for (std::size_t i = 0; i < length; i += 2) {
+        const PairEntry& entry = tables.pairs[PairIndex(classes, i, length)];
+        // 每组只有一对，路径范围就是中点和终点
+        box.Include(x + entry.mid[state], y + entry.mid[state + 16]);
+        Merge(tables, entry.next, entry.disp, entry.disp, entry.disp, entry.aux, entry.count, x, y, state, box,
+              counters);
+    }
+}
+
+unsigned char ScalarClass(const char* data, const std::size_t size, const std::size_t i) noexcept
+{
+    const unsigned commandClass = COMMAND_CLASS[data[i]];
+    if (commandClass == CLASS_T) {
+        return i + 1 < size && data[i + 1] == 'R' ? CLASS_TR : CLASS_JUNK;
+    }
+    if (commandClass == CLASS_R && i > 0 && data[i - 1] == 'T') {
+        return CLASS_NOP;
+    }
+    return static_cast<unsigned char>(commandClass);
+}
+
+std::uint64_t ClassifyScalar(const char* data, const std::size_t size, const std::size_t pos, const std::size_t length,
+                             unsigned char* classes) noexcept
+{
+    std::uint64_t switches = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        classes[i] = ScalarClass(data, size, pos + i);
+        if (classes[i] == CLASS_N || classes[i] == CLASS_U) {
+            switches |= 1ull << i;
+        }
+    }
+    return switches;
+}
+
+#ifdef ADAS_FSM_X86
+// 按高半字节4/5和低半字节查类别，其余字符为0即CLASS_JUNK
+#define ADAS_FSM_HIGH4 0, 0, CLASS_B, 0, 0, 0, CLASS_F, 0, 0, 0, 0, 0, CLASS_L, CLASS_M, CLASS_N, 0
+#define ADAS_FSM_HIGH5 0, 0, CLASS_R, 0, CLASS_T, CLASS_U, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+
+__attribute__((target("ssse3"))) std::uint64_t ClassifySsse3(const char* data, unsigned char* classes) noexcept
+{
+    const __m128i high4 = _mm_setr_epi8(ADAS_FSM_HIGH4);
+    const __m128i high5 = _mm_setr_epi8(ADAS_FSM_HIGH5);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    std::uint64_t switches = 0;
+    for (unsigned part = 0; part < FSM_BLOCK; part += 16) {
+        const char* bytes = data + part;
+        const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes - 1));
+        const __m128i following = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 1));
+        const __m128i low = _mm_and_si128(current, nibble);
+        const __m128i high = _mm_and_si128(_mm_srli_epi16(current, 4), nibble);
+        __m128i result =
+            _mm_or_si128(_mm_and_si128(_mm_shuffle_epi8(high4, low), _mm_cmpeq_epi8(high, _mm_set1_epi8(4))),
+                         _mm_and_si128(_mm_shuffle_epi8(high5, low), _mm_cmpeq_epi8(high, _mm_set1_epi8(5))));
+        const __m128i isT = _mm_cmpeq_epi8(current, _mm_set1_epi8('T'));
+        const __m128i turnRound = _mm_and_si128(isT, _mm_cmpeq_epi8(following, _mm_set1_epi8('R')));
+        const __m128i nop =
+            _mm_and_si128(_mm_cmpeq_epi8(current, _mm_set1_epi8('R')), _mm_cmpeq_epi8(previous, _mm_set1_epi8('T')));
+        result = _mm_or_si128(_mm_andnot_si128(isT, result), _mm_and_si128(turnRound, _mm_set1_epi8(CLASS_TR)));
+        result = _mm_or_si128(_mm_andnot_si128(nop, result), _mm_and_si128(nop, _mm_set1_epi8(CLASS_NOP)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(classes + part), result);
+        const __m128i carSwitch = _mm_or_si128(_mm_cmpeq_epi8(result, _mm_set1_epi8(CLASS_N)),
+                                               _mm_cmpeq_epi8(result, _mm_set1_epi8(CLASS_U)));
+        switches |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(carSwitch))) << part;
+    }
+    return switches;
+}
+
+__attribute__((target("avx2"))) std::uint64_t ClassifyAvx2(const char* data, unsigned char* classes) noexcept
+{
+    const __m256i high4 = _mm256_setr_epi8(ADAS_FSM_HIGH4, ADAS_FSM_HIGH4);
+    const __m256i high5 = _mm256_setr_epi8(ADAS_FSM_HIGH5, ADAS_FSM_HIGH5);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    std::uint64_t switches = 0;
+    for (unsigned part = 0; part < FSM_BLOCK; part += 32) {
+        const char* bytes = data + part;
+        const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+        const __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes - 1));
+        const __m256i following = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + 1));
+        const __m256i low = _mm256_and_si256(current, nibble);
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(current, 4), nibble);
+        __m256i result = _mm256_or_si256(
+            _mm256_and_si256(_mm256_shuffle_epi8(high4, low), _mm256_cmpeq_epi8(high, _mm256_set1_epi8(4))),
+            _mm256_and_si256(_mm256_shuffle_epi8(high5, low), _mm256_cmpeq_epi8(high, _mm256_set1_epi8(5))));
+        const __m256i isT = _mm256_cmpeq_epi8(current, _mm256_set1_epi8('T'));
+        const __m256i turnRound = _mm256_and_si256(isT, _mm256_cmpeq_epi8(following, _mm256_set1_epi8('R')));
+        const __m256i nop = _mm256_and_si256(_mm256_cmpeq_epi8(current, _mm256_set1_epi8('R')),
+                                             _mm256_cmpeq_epi8(previous, _mm256_set1_epi8('T')));
+        result = _mm256_or_si256(_mm256_andnot_si256(isT, result),
+                                 _mm256_and_si256(turnRound, _mm256_set1_epi8(CLASS_TR)));
+        result = _mm256_or_si256(_mm256_andnot_si256(nop, result), _mm256_and_si256(nop, _mm256_set1_epi8(CLASS_NOP)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(classes + part), result);
+        const __m256i carSwitch = _mm256_or_si256(_mm256_cmpeq_epi8(result, _mm256_set1_epi8(CLASS_N)),
+                                                  _mm256_cmpeq_epi8(result, _mm256_set1_epi8(CLASS_U)));
+        switches |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(carSwitch))) << part;
+    }
+    return switches;
+}
+
+#undef ADAS_FSM_HIGH4
+#undef ADAS_FSM_HIGH5
+
+// SSSE3没有有符号的pminsb/pmaxsb：翻转符号位后按无符号比较
+__attribute__((target("ssse3"))) inline __m128i Biased(const __m128i value) noexcept
+{
+    return _mm_xor_si128(value, _mm_set1_epi8(static_cast<char>(0x80)));
+}
+
+// 向量实现的length为偶数，每对都是完整的两条指令。
+// 每个通道对应一个起始状态：v[s]为从s出发的当前状态，位移等按v查表后逐通道累加；
+// 外接矩形按组内每条指令后的累计位移求最小和最大值，以偏置形式累计
+__attribute__((target("ssse3"))) void EvaluateSsse3(const FsmTables& tables, const unsigned char* classes,
+                                                    const std::size_t length, int& x, int& y, unsigned& state,
+                                                    PathBox& box, std::uint64_t* counters) noexcept
+{
+    const __m128i identity = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    alignas(16) unsigned char next[16];
+    alignas(16) signed char disp[32];
+    alignas(16) signed char low[32];
+    alignas(16) signed char high[32];
+    alignas(16) unsigned char aux[32];
+    alignas(16) unsigned char count[16];
+    std::size_t i = 0;
+    while (i < length) {
+        const std::size_t end = std::min(length, i + 2 * static_cast<std::size_t>(tables.group));
+        __m128i current = identity;
+        __m128i dx = _mm_setzero_si128();
+        __m128i dy = _mm_setzero_si128();
+        __m128i steps = _mm_setzero_si128();
+        __m128i ignored = _mm_setzero_si128();
+        __m128i lowX = Biased(_mm_setzero_si128());
+        __m128i lowY = lowX;
+        __m128i highX = lowX;
+        __m128i highY = lowX;
+        __m128i counts = _mm_setzero_si128();
+        for (; i < end; i += 2) {
+            const PairEntry& entry = tables.pairs[classes[i] * FSM_CLASSES + classes[i + 1]];
+            const __m128i* lanes = reinterpret_cast<const __m128i*>(&entry);
+            const __m128i midX = Biased(_mm_add_epi8(dx, _mm_shuffle_epi8(_mm_load_si128(lanes + 6), current)));
+            const __m128i midY = Biased(_mm_add_epi8(dy, _mm_shuffle_epi8(_mm_load_si128(lanes + 7), current)));
+            dx = _mm_add_epi8(dx, _mm_shuffle_epi8(_mm_load_si128(lanes + 2), current));
+            dy = _mm_add_epi8(dy, _mm_shuffle_epi8(_mm_load_si128(lanes + 3), current));
+            const __m128i endX = Biased(dx);
+            const __m128i endY = Biased(dy);
+            lowX = _mm_min_epu8(lowX, _mm_min_epu8(midX, endX));
+            lowY = _mm_min_epu8(lowY, _mm_min_epu8(midY, endY));
+            highX = _mm_max_epu8(highX, _mm_max_epu8(midX, endX));
+            highY = _mm_max_epu8(highY, _mm_max_epu8(midY, endY));
+            steps = _mm_add_epi8(steps, _mm_shuffle_epi8(_mm_load_si128(lanes + 4), current));
+            ignored = _mm_add_epi8(ignored, _mm_shuffle_epi8(_mm_load_si128(lanes + 5), current));
+            counts = _mm_add_epi8(counts, _mm_load_si128(lanes + 8));
+            current = _mm_shuffle_epi8(_mm_load_si128(lanes), current);
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(next), current);
+        _mm_store_si128(reinterpret_cast<__m128i*>(disp), dx);
+        _mm_store_si128(reinterpret_cast<__m128i*>(disp + 16), dy);
+        _mm_store_si128(reinterpret_cast<__m128i*>(low), Biased(lowX));
+        _mm_store_si128(reinterpret_cast<__m128i*>(low + 16), Biased(lowY));
+        _mm_store_si128(reinterpret_cast<__m128i*>(high), Biased(highX));
+        _mm_store_si128(reinterpret_cast<__m128i*>(high + 16), Biased(highY));
+        _mm_store_si128(reinterpret_cast<__m128i*>(aux), steps);
+        _mm_store_si128(reinterpret_cast<__m128i*>(aux + 16), ignored);
+        _mm_store_si128(reinterpret_cast<__m128i*>(count), counts);
+        Merge(tables, next, disp, low, high, aux, count, x, y, state, box, counters);
+    }
+}
+
+// 两个128位通道各放一份状态向量，一次pshufb同时得到dx和dy(格数和忽略的TR数、中点同理)
+__attribute__((target("avx2"))) void EvaluateAvx2(const FsmTables& tables, const unsigned char* classes,
+                                                  const std::size_t length, int& x, int& y, unsigned& state,
+                                                  PathBox& box, std::uint64_t* counters) noexcept
+{
+    const __m256i identity = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5,
+                                              6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    alignas(32) unsigned char next[32];
+    alignas(32) signed char disp[32];
+    alignas(32) signed char low[32];
+    alignas(32) signed char high[32];
+    alignas(32) unsigned char aux[32];
+    alignas(16) unsigned char count[16];
+    std::size_t i = 0;
+    while (i < length) {
+        const std::size_t end = std::min(length, i + 2 * static_cast<std::size_t>(tables.group));
+        __m256i current = identity;
+        __m256i displacement = _mm256_setzero_si256();
+        __m256i lower = _mm256_setzero_si256();
+        __m256i higher = _mm256_setzero_si256();
+        __m256i auxiliary = _mm256_setzero_si256();
+        __m128i counts = _mm_setzero_si128();
+        for (; i < end; i += 2) {
+            const PairEntry& entry = tables.pairs[classes[i] * FSM_CLASSES + classes[i + 1]];
+            const __m256i* lanes = reinterpret_cast<const __m256i*>(&entry);
+            const __m256i middle =
+                _mm256_add_epi8(displacement, _mm256_shuffle_epi8(_mm256_load_si256(lanes + 3), current));
+            displacement = _mm256_add_epi8(displacement, _mm256_shuffle_epi8(_mm256_load_si256(lanes + 1), current));
+            lower = _mm256_min_epi8(lower, _mm256_min_epi8(middle, displacement));
+            higher = _mm256_max_epi8(higher, _mm256_max_epi8(middle, displacement));
+            auxiliary = _mm256_add_epi8(auxiliary, _mm256_shuffle_epi8(_mm256_load_si256(lanes + 2), current));
+            counts = _mm_add_epi8(counts, _mm_load_si128(reinterpret_cast<const __m128i*>(entry.count)));
+            current = _mm256_shuffle_epi8(_mm256_load_si256(lanes), current);
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(next), current);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(disp), displacement);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(low), lower);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(high), higher);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(aux), auxiliary);
+        _mm_store_si128(reinterpret_cast<__m128i*>(count), counts);
+        Merge(tables, next, disp, low, high, aux, count, x, y, state, box, counters);
+    }
+}
+#endif
+
+EvaluatorIsa Clamp(const EvaluatorIsa isa) noexcept
+{
+    const EvaluatorIsa best = BestEvaluatorIsa();
+    return static_cast<unsigned>(isa) > static_cast<unsigned>(best) ? best : isa;
+}
+}  // namespace
+
+EvaluatorIsa BestEvaluatorIsa(void) noexcept
+{
+#ifdef ADAS_FSM_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return EvaluatorIsa::AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return EvaluatorIsa::SSSE3;
+    }
+#endif
+    return EvaluatorIsa::SCALAR;
+}
+
+EvaluatorIsa SetEvaluatorIsa(const EvaluatorIsa isa) noexcept
+{
+    const EvaluatorIsa effective = Clamp(isa);
+    activeIsa.store(static_cast<unsigned char>(effective), std::memory_order_relaxed);
+    return effective;
+}
+
+EvaluatorIsa GetEvaluatorIsa(void) noexcept
+{
+    if (threadIsa != UNSET_ISA) {
+        return static_cast<EvaluatorIsa>(threadIsa);
+    }
+    const unsigned char isa = activeIsa.load(std::memory_order_relaxed);
+    if (isa != UNSET_ISA) {
+        return static_cast<EvaluatorIsa>(isa);
+    }
+    const EvaluatorIsa best = BestEvaluatorIsa();
+    activeIsa.store(static_cast<unsigned char>(best), std::memory_order_relaxed);
+    return best;
+}
+
+ThreadEvaluatorIsa::ThreadEvaluatorIsa(const EvaluatorIsa isa) noexcept : saved(threadIsa)
+{
+    threadIsa = static_cast<unsigned char>(Clamp(isa));
+}
+
+ThreadEvaluatorIsa::~ThreadEvaluatorIsa() noexcept
+{
+    threadIsa = saved;
+}
+
+const FsmTables& FsmTablesOf(const CarType carType) noexcept
+{
+    // 车型只追加不修改，表生成一次后无需再加锁
+    static FsmTables tables[MAX_CAR_TYPES];
+    static std::atomic<bool> built[MAX_CAR_TYPES];
+    static std::mutex mutex;
+    const std::size_t slot = static_cast<std::size_t>(carType) < CarTypeCount() ? static_cast<std::size_t>(carType) : 0;
+    if (!built[slot].load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!built[slot].load(std::memory_order_relaxed)) {
+            Build(TableOf(static_cast<CarType>(slot)), tables[slot]);
+            built[slot].store(true, std::memory_order_release);
+        }
+    }
+    return tables[slot];
+}
+
+std::uint64_t ClassifyCommands(const EvaluatorIsa isa, const char* data, const std::size_t size, const std::size_t pos,
+                               const std::size_t length, unsigned char* classes) noexcept
+{
+    // 向量实现要读块前一个和块后一个字符
+#ifdef ADAS_FSM_X86
+    if (length == FSM_BLOCK && pos > 0 && pos + FSM_BLOCK < size) {
+        switch (isa) {
+        case EvaluatorIsa::AVX2:
+            return ClassifyAvx2(data + pos, classes);
+        case EvaluatorIsa::SSSE3:
+            return ClassifySsse3(data + pos, classes);
+        default:
+            break;
+        }
+    }
+#endif
+    (void)isa;
+    return ClassifyScalar(data, size, pos, length, classes);
+}
+
+bool UniformBlock(const unsigned char* classes) noexcept
+{
+    std::uint64_t words[FSM_BLOCK / 8];
+    std::memcpy(words, classes, FSM_BLOCK);
+    const std::uint64_t pattern = classes[0] * 0x0101010101010101ull;
+    std::uint64_t diff = 0;
+    for (const std::uint64_t word : words) {
+        diff |= word ^ pattern;
+    }
+    return diff == 0;
+}
+
+void FoldBlock(const FsmTables& tables, const unsigned commandClass, int& x, int& y, unsigned& state, PathBox& box,
+               std::uint64_t* counters) noexcept
+{
+    const BlockEntry& block = tables.blocks[commandClass];
+    const PathBox& offset = block.box[state];
+    box.Include(x + offset.minX, x + offset.maxX, y + offset.minY, y + offset.maxY);
+    x += block.dx[state];
+    y += block.dy[state];
+    counters[static_cast<unsigned>(ExecutorCounter::GRID_STEPS)] += block.steps[state];
+    if (commandClass == CLASS_TR) {
+        counters[static_cast<unsigned>(ExecutorCounter::COMMAND_TR)] += FSM_BLOCK - block.ignored[state];
+        counters[TR_IGNORED] += block.ignored[state];
+    } else {
+        counters[tables.counterOf[commandClass]] += FSM_BLOCK;
+    }
+    state = block.next[state];
+}
+
+void EvaluateClasses(const EvaluatorIsa isa, const FsmTables& tables, const unsigned char* classes,
+                     const std::size_t length, int& x, int& y, unsigned& state, PathBox& box,
+                     std::uint64_t* counters) noexcept
+{
+#ifdef ADAS_FSM_X86
+    // 奇数长度时最后一条单独按标量合并，向量循环内不必检查下一条是否越界
+    const std::size_t pairs = length & ~static_cast<std::size_t>(1);
+    switch (isa) {
+    case EvaluatorIsa::AVX2:
+        EvaluateAvx2(tables, classes, pairs, x, y, state, box, counters);
+        EvaluateScalar(tables, classes + pairs, length - pairs, x, y, state, box, counters);
+        return;
+    case EvaluatorIsa::SSSE3:
+        EvaluateSsse3(tables, classes, pairs, x, y, state, box, counters);
+        EvaluateScalar(tables, classes + pairs, length - pairs, x, y, state, box, counters);
+        return;
+    default:
+        break;
+    }
+#endif
+    (void)isa;
+    EvaluateScalar(tables, classes, length, x, y, state, box, counters);
+}
+}  // namespace adas
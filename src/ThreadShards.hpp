@@ -0,0 +1,77 @@
+#pragma once
+#include <mutex>
+#include <vector>
+
+namespace adas
+{
+// 线程分片注册表：每个线程持有一个Shard，只有所属线程写入；
+// 读取方在锁内遍历存活分片。线程退出时分片内容并入retired，不会丢失。
+// Shard需要提供 void MergeFrom(Shard&) noexcept
+template <typename Shard>
+class ThreadShards final
+{
+public:
+    static ThreadShards& Instance(void) noexcept
+    {
+        // 有意泄漏，保证线程退出时注册表仍然有效
+        static ThreadShards* shards = new ThreadShards();
+        return *shards;
+    }
+
+    // 当前线程的分片；平凡类型的thread_local指针没有初始化检查，热路径只读指针
+    static Shard& Local(void) noexcept
+    {
+        static thread_local Shard* shard = nullptr;
+        if (shard == nullptr) {
+            shard = &LocalOwner().shard;
+        }
+        return *shard;
+    }
+
+    // 在锁内依次访问已退出线程的合并分片和所有存活分片
+    template <typename Visitor>
+    void ForEach(Visitor visitor)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        visitor(retired);
+        for (Shard* shard : shards) {
+            visitor(*shard);
+        }
+    }
+
+private:
+    struct Owner final
+    {
+        Owner(void)
+        {
+            ThreadShards& registry = Instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.shards.push_back(&shard);
+        }
+        ~Owner() noexcept
+        {
+            ThreadShards& registry = Instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.retired.MergeFrom(shard);
+            for (auto it = registry.shards.begin(); it != registry.shards.end(); ++it) {
+                if (*it == &shard) {
+                    registry.shards.erase(it);
+                    break;
+                }
+            }
+        }
+
+        Shard shard;
+    };
+
+    static Owner& LocalOwner(void)
+    {
+        static thread_local Owner owner;
+        return owner;
+    }
+
+    std::mutex mutex;
+    std::vector<Shard*> shards;
+    Shard retired;
+};
+}  // namespace adas
@@ -0,0 +1,301 @@
+#include "VehicleRegistry.hpp"
+#include <new>
+#include "EpochDomain.hpp"
+
+namespace adas
+{
+namespace
+{
+constexpr std::size_t MIN_CAPACITY = 16;
+// 每攒够这么多待回收对象尝试推进一次纪元
+constexpr std::size_t RECLAIM_BATCH = 64;
+
+// 墓碑只比较地址，不解引用
+char tombstoneTag;
+
+std::uint64_t Mix(std::uint64_t value) noexcept
+{
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ull;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+std::uint64_t HashOf(const std::uint64_t id) noexcept
+{
+    return Mix(id);
+}
+
+// FNV-1a再混合；与编号的散列加以区分，两种键不会相等
+std::uint64_t HashOf(const std::string& name) noexcept
+{
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+    }
+    return Mix(hash ^ 0x5BD1E995ull);
+}
+}  // namespace
+
+VehicleRegistry::Guard::Guard(void) noexcept : record(&EpochDomain::Enter())
+{
+}
+
+VehicleRegistry::Guard::~Guard() noexcept
+{
+    EpochDomain::Leave(*record);
+}
+
+VehicleRegistry::VehicleRegistry(const unsigned shardBits) noexcept
+    : shardBits(shardBits > 12 ? 12 : shardBits), shards(new (std::nothrow) Shard[std::size_t{1} << this->shardBits])
+{
+}
+
+VehicleRegistry::~VehicleRegistry() noexcept
+{
+    if (shards == nullptr) {
+        return;
+    }
+    for (std::size_t i = 0; i < (std::size_t{1} << shardBits); ++i) {
+        Shard& shard = shards[i];
+        for (const Retired& retired : shard.limbo) {
+            delete retired.entry;
+            delete retired.table;
+        }
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        if (table != nullptr) {
+            for (std::size_t slot = 0; slot <= table->mask; ++slot) {
+                Entry* entry = table->slots[slot].load(std::memory_order_relaxed);
+                if (entry != nullptr && entry != reinterpret_cast<Entry*>(&tombstoneTag)) {
+                    delete entry;
+                }
+            }
+            delete table;
+        }
+    }
+}
+
+VehicleRegistry::Shard& VehicleRegistry::ShardOf(const std::uint64_t hash) const noexcept
+{
+    // 高位选分片，低位选槽位
+    return shards[shardBits == 0 ? 0 : static_cast<std::size_t>(hash >> (64 - shardBits))];
+}
+
+VehicleRegistry::Table* VehicleRegistry::NewTable(const std::size_t capacity) noexcept
+{
+    std::unique_ptr<Table> table(new (std::nothrow) Table());
+    if (table == nullptr) {
+        return nullptr;
+    }
+    table->slots.reset(new (std::nothrow) std::atomic<Entry*>[capacity]);
+    if (table->slots == nullptr) {
+        return nullptr;
+    }
+    for (std::size_t i = 0; i < capacity; ++i) {
+        table->slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+    table->mask = capacity - 1;
+    return table.release();
+}
+
+bool VehicleRegistry::Insert(const std::uint64_t id, const Pose& pose, const CarMode& mode) noexcept
+{
+    return Insert(HashOf(id), id, nullptr, pose, mode);
+}
+
+bool VehicleRegistry::Insert(const std::string& name, const Pose& pose, const CarMode& mode) noexcept
+{
+    return Insert(HashOf(name), 0, &name, pose, mode);
+}
+
+bool VehicleRegistry::Remove(const std::uint64_t id) noexcept
+{
+    return Remove(HashOf(id), id, nullptr);
+}
+
+bool VehicleRegistry::Remove(const std::string& name) noexcept
+{
+    return Remove(HashOf(name), 0, &name);
+}
+
+Executor* VehicleRegistry::Find(const Guard&, const std::uint64_t id) const noexcept
+{
+    return Find(HashOf(id), id, nullptr);
+}
+
+Executor* VehicleRegistry::Find(const Guard&, const std::string& name) const noexcept
+{
+    return Find(HashOf(name), 0, &name);
+}
+
+Executor* VehicleRegistry::Find(const std::uint64_t hash, const std::uint64_t id,
+                                const std::string* name) const noexcept
+{
+    if (shards == nullptr) {
+        return nullptr;
+    }
+    const Table* table = ShardOf(hash).table.load(std::memory_order_acquire);
+    if (table == nullptr) {
+        return nullptr;
+    }
+    for (std::size_t slot = hash & table->mask;; slot = (slot + 1) & table->mask) {
+        const Entry* entry = table->slots[slot].load(std::memory_order_acquire);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        if (entry != reinterpret_cast<Entry*>(&tombstoneTag) && entry->hash == hash &&
+            (name == nullptr ? !entry->named && entry->id == id : entry->named && entry->name == *name)) {
+            return entry->executor.get();
+        }
+    }
+}
+
+bool VehicleRegistry::Insert(const std::uint64_t hash, const std::uint64_t id, const std::string* name,
+                             const Pose& pose, const CarMode& mode) noexcept
+{
+    if (shards == nullptr) {
+        return false;
+    }
+    Shard& shard = ShardOf(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (Find(hash, id, name) != nullptr || !Reserve(shard)) {
+        return false;
+    }
+
+    std::unique_ptr<Entry> entry(new (std::nothrow) Entry{hash, id, {}, name != nullptr, {}});
+    if (entry == nullptr) {
+        return false;
+    }
+    try {
+        if (name != nullptr) {
+            entry->name = *name;
+        }
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    entry->executor = shard.pool.Acquire(pose, mode);
+    if (!entry->executor) {
+        return false;
+    }
+
+    // 表项填好后再以release发布，读者看到指针时内容已完整
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    std::size_t slot = hash & table->mask;
+    Entry* current = table->slots[slot].load(std::memory_order_relaxed);
+    while (current != nullptr && current != reinterpret_cast<Entry*>(&tombstoneTag)) {
+        slot = (slot + 1) & table->mask;
+        current = table->slots[slot].load(std::memory_order_relaxed);
+    }
+    if (current == nullptr) {
+        ++shard.used;
+    }
+    table->slots[slot].store(entry.release(), std::memory_order_release);
+    ++shard.live;
+    size.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool VehicleRegistry::Remove(const std::uint64_t hash, const std::uint64_t id, const std::string* name) noexcept
+{
+    if (shards == nullptr) {
+        return false;
+    }
+    Shard& shard = ShardOf(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    if (table == nullptr) {
+        return false;
+    }
+    for (std::size_t slot = hash & table->mask;; slot = (slot + 1) & table->mask) {
+        Entry* entry = table->slots[slot].load(std::memory_order_relaxed);
+        if (entry == nullptr) {
+            return false;
+        }
+        if (entry != reinterpret_cast<Entry*>(&tombstoneTag) && entry->hash == hash &&
+            (name == nullptr ? !entry->named && entry->id == id : entry->named && entry->name == *name)) {
+            // 先预留待回收的位置，内存不足时不做任何修改
+            try {
+                shard.limbo.reserve(shard.limbo.size() + 1);
+            } catch (const std::bad_alloc&) {
+                return false;
+            }
+            table->slots[slot].store(reinterpret_cast<Entry*>(&tombstoneTag), std::memory_order_release);
+            Retire(shard, entry, nullptr);
+            --shard.live;
+            size.fetch_sub(1, std::memory_order_relaxed);
+            Reclaim(shard);
+            return true;
+        }
+    }
+}
+
+bool VehicleRegistry::Reserve(Shard& shard) noexcept
+{
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    // 装载率(含墓碑)不超过1/2
+    if (table != nullptr && (shard.used + 1) * 2 <= table->mask + 1) {
+        return true;
+    }
+    std::size_t capacity = MIN_CAPACITY;
+    while (capacity < (shard.live + 1) * 4) {
+        capacity *= 2;
+    }
+    Table* larger = NewTable(capacity);
+    if (larger == nullptr) {
+        return false;
+    }
+    if (table != nullptr) {
+        try {
+            shard.limbo.reserve(shard.limbo.size() + 1);
+        } catch (const std::bad_alloc&) {
+            delete larger;
+            return false;
+        }
+        for (std::size_t i = 0; i <= table->mask; ++i) {
+            Entry* entry = table->slots[i].load(std::memory_order_relaxed);
+            if (entry == nullptr || entry == reinterpret_cast<Entry*>(&tombstoneTag)) {
+                continue;
+            }
+            std::size_t slot = entry->hash & larger->mask;
+            while (larger->slots[slot].load(std::memory_order_relaxed) != nullptr) {
+                slot = (slot + 1) & larger->mask;
+            }
+            larger->slots[slot].store(entry, std::memory_order_relaxed);
+        }
+    }
+    // 读者可能还在旧表上查找，旧表与表项一样延迟回收；旧表中的表项已搬到新表，不随旧表释放
+    shard.table.store(larger, std::memory_order_release);
+    shard.used = shard.live;
+    if (table != nullptr) {
+        Retire(shard, nullptr, table);
+        Reclaim(shard);
+    }
+    return true;
+}
+
+void VehicleRegistry::Retire(Shard& shard, Entry* entry, Table* table) noexcept
+{
+    // 摘除之后再读纪元：此后进入的读者看不到被摘除的对象，之前进入的读者的纪元不会比它大
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    shard.limbo.push_back(Retired{EpochDomain::Current(), entry, table});
+}
+
+void VehicleRegistry::Reclaim(Shard& shard) noexcept
+{
+    if (shard.limbo.size() < RECLAIM_BATCH) {
+        return;
+    }
+    const std::uint64_t epoch = EpochDomain::TryAdvance();
+    std::size_t kept = 0;
+    for (const Retired& retired : shard.limbo) {
+        if (retired.retired + 2 <= epoch) {
+            delete retired.entry;
+            delete retired.table;
+        } else {
+            shard.limbo[kept++] = retired;
+        }
+    }
+    shard.limbo.resize(kept);
+}
+}  // namespace adas
@@ -0,0 +1,108 @@
+#pragma once
+#include "Executor.hpp"
+
+namespace adas
+{
+// 指令按字节分类；T要看下一个字符才能确定是TR还是未知字符，不出现在转移表中
+enum CommandClass : unsigned char {
+    CLASS_JUNK,
+    CLASS_M,
+    CLASS_L,
+    CLASS_R,
+    CLASS_F,
+    CLASS_B,
+    CLASS_N,
+    CLASS_U,
+    CLASS_TR,
+    CLASS_COUNT,
+    CLASS_T = CLASS_COUNT
+};
+
+struct CommandClassTable
+{
+    constexpr CommandClassTable(void) noexcept : values{}
+    {
+        values['M'] = CLASS_M;
+        values['L'] = CLASS_L;
+        values['R'] = CLASS_R;
+        values['F'] = CLASS_F;
+        values['B'] = CLASS_B;
+        values['N'] = CLASS_N;
+        values['U'] = CLASS_U;
+        values['T'] = CLASS_T;
+    }
+
+    unsigned operator[](const char c) const noexcept
+    {
+        return values[static_cast<unsigned char>(c)];
+    }
+
+    unsigned char values[256];
+};
+
+inline constexpr CommandClassTable COMMAND_CLASS{};
+
+// 车型内的状态：朝向(ESWN) * 4 + 加速 * 2 + 倒车
+constexpr unsigned VEHICLE_STATES = 16;
+constexpr unsigned char NO_SWITCH = 0xFF;
+
+struct Transition
+{
+    signed char dx;
+    signed char dy;
+    unsigned char next;      // 转移后的车型内状态
+    unsigned char counter;   // 累加的ExecutorCounter
+    unsigned char steps;     // 移动格数
+    unsigned char switchTo;  // 切换到的车型，不切换为NO_SWITCH
+    unsigned char reserved[2];
+};
+
+using VehicleTable = Transition[VEHICLE_STATES][CLASS_COUNT];
+
+// 行驶路径的外接矩形。每条指令的路径最多拐一个弯，拐点在两端点的外接矩形内，
+// 因此只需并入每条指令执行后的位置
+struct PathBox
+{
+    // 矩形很少扩大，用分支而不是无条件写回，逐条执行时不会形成经过内存的依赖链
+    void Include(const int lowX, const int highX, const int lowY, const int highY) noexcept
+    {
+        if (lowX < minX) {
+            minX = lowX;
+        }
+        if (highX > maxX) {
+            maxX = highX;
+        }
+        if (lowY < minY) {
+            minY = lowY;
+        }
+        if (highY > maxY) {
+            maxY = highY;
+        }
+    }
+
+    void Include(const int x, const int y) noexcept
+    {
+        Include(x, x, y, y);
+    }
+
+    int minX;
+    int maxX;
+    int minY;
+    int maxY;
+};
+
+// 未注册的车型返回NORMAL的表；返回的引用在进程内一直有效
+const VehicleTable& TableOf(const CarType carType) noexcept;
+
+unsigned HeadingIndex(const char heading) noexcept;
+
+inline char HeadingOf(const unsigned state) noexcept
+{
+    return "ESWN"[state >> 2];
+}
+
+inline unsigned StateOf(const char heading, const bool fast, const bool reverse) noexcept
+{
+    return (HeadingIndex(heading) << 2) | (fast ? 2u : 0u) | (reverse ? 1u : 0u);
+}
+}  // namespace adas
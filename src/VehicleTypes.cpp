@@ -0,0 +1,391 @@
+#include "VehicleTypes.hpp"
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include "ExecutorMetrics.hpp"
+#include "PoseHandler.hpp"
+#include "Profiler.hpp"
+#include "VehicleTable.hpp"
+
+namespace adas
+{
+namespace
+{
+// 内置车型，下标即CarType的取值
+std::vector<VehicleSpec> BuiltinSpecs(void)
+{
+    VehicleSpec normal;
+    normal.name = "NORMAL";
+    normal.onN = "SPORTS";
+    normal.onU = "BUS";
+
+    // 跑车转向后总要再走一格
+    VehicleSpec sports;
+    sports.name = "SPORTS";
+    sports.move[0] = 2;
+    sports.move[1] = 4;
+    sports.turnAfter[0] = 1;
+    sports.turnAfter[1] = 1;
+    sports.onN = "NORMAL";
+    sports.onU = "BUS";
+
+    // Bus先按M的距离移动再转向，不能切换到跑车
+    VehicleSpec bus;
+    bus.name = "BUS";
+    bus.turnBefore[0] = 1;
+    bus.turnBefore[1] = 2;
+    bus.onU = "NORMAL";
+
+    return {normal, sports, bus};
+}
+
+unsigned char CounterSlot(const ExecutorCounter counter) noexcept
+{
+    return static_cast<unsigned char>(counter);
+}
+
+void Step(PoseHandler& handler, const unsigned count) noexcept
+{
+    for (unsigned i = 0; i < count; ++i) {
+        if (handler.IsReverse()) {
+            handler.MoveBackward();
+        } else {
+            handler.Move();
+        }
+    }
+}
+
+void Turn(PoseHandler& handler, const bool left) noexcept
+{
+    // 倒车时左右互换
+    if (left != handler.IsReverse()) {
+        handler.TurnLeft();
+    } else {
+        handler.TurnRight();
+    }
+}
+
+// 掉头对所有车型相同：倒车时忽略，加速时每次左转前先前进一格
+ExecutorCounter TurnRound(PoseHandler& handler) noexcept
+{
+    if (handler.IsReverse()) {
+        return ExecutorCounter::TR_IGNORED_IN_REVERSE;
+    }
+    if (handler.IsFast()) {
+        handler.Move();
+    }
+    handler.TurnLeft();
+    handler.Move();
+    handler.TurnLeft();
+    return ExecutorCounter::COMMAND_TR;
+}
+
+// 在原点模拟一条指令，得到位移、新状态与计数
+Transition Simulate(const VehicleSpec& spec, const unsigned state, const unsigned commandClass,
+                    const unsigned char onN, const unsigned char onU) noexcept
+{
+    PoseHandler handler({0, 0, HeadingOf(state)}, (state & 2) != 0, (state & 1) != 0);
+    const unsigned speed = handler.IsFast() ? 1 : 0;
+    ExecutorCounter counter = ExecutorCounter::UNKNOWN_SKIPPED;
+    unsigned char switchTo = NO_SWITCH;
+    switch (commandClass) {
+    case CLASS_M:
+        Step(handler, spec.move[speed]);
+        counter = ExecutorCounter::COMMAND_M;
+        break;
+    case CLASS_L:
+    case CLASS_R:
+        Step(handler, spec.turnBefore[speed]);
+        Turn(handler, commandClass == CLASS_L);
+        Step(handler, spec.turnAfter[speed]);
+        counter = commandClass == CLASS_L ? ExecutorCounter::COMMAND_L : ExecutorCounter::COMMAND_R;
+        break;
+    case CLASS_F:
+        handler.Fast();
+        counter = ExecutorCounter::COMMAND_F;
+        break;
+    case CLASS_B:
+        handler.Reverse();
+        counter = ExecutorCounter::COMMAND_B;
+        break;
+    case CLASS_N:
+    case CLASS_U:
+        switchTo = commandClass == CLASS_N ? onN : onU;
+        if (switchTo == NO_SWITCH) {
+            counter = ExecutorCounter::N_REFUSED_IN_BUS;
+        } else {
+            // 切换车型时重置加速和倒车状态，朝向不变
+            handler.Reset(handler.Query());
+            counter = commandClass == CLASS_N ? ExecutorCounter::COMMAND_N : ExecutorCounter::COMMAND_U;
+        }
+        break;
+    case CLASS_TR:
+        counter = TurnRound(handler);
+        break;
+    default:
+        break;
+    }
+
+    const Pose pose = handler.Query();
+    Transition transition{};
+    transition.dx = static_cast<signed char>(pose.x);
+    transition.dy = static_cast<signed char>(pose.y);
+    transition.next = static_cast<unsigned char>(StateOf(pose.heading, handler.IsFast(), handler.IsReverse()));
+    transition.counter = CounterSlot(counter);
+    transition.steps = static_cast<unsigned char>(handler.GetSteps());
+    transition.switchTo = switchTo;
+    return transition;
+}
+
+void Compile(const VehicleSpec& spec, const unsigned char onN, const unsigned char onU, VehicleTable& table) noexcept
+{
+    TraceSpan span("CommandTableRebuild", CarType::NORMAL);
+    for (unsigned state = 0; state < VEHICLE_STATES; ++state) {
+        for (unsigned commandClass = 0; commandClass < CLASS_COUNT; ++commandClass) {
+            table[state][commandClass] = Simulate(spec, state, commandClass, onN, onU);
+        }
+    }
+}
+
+// 表只追加不修改：先写好新车型的表和名字，再发布数量，读取方无需加锁
+class Registry final
+{
+public:
+    static Registry& Instance(void) noexcept
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    bool Register(const std::vector<VehicleSpec>& specs, std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::size_t base = count.load(std::memory_order_relaxed);
+        if (base + specs.size() > MAX_CAR_TYPES) {
+            error = "too many vehicle types, at most " + std::to_string(MAX_CAR_TYPES);
+            return false;
+        }
+
+        auto find = [this, base, &specs](const std::string& name) -> unsigned {
+            for (std::size_t i = 0; i < base; ++i) {
+                if (names[i] == name) {
+                    return static_cast<unsigned>(i);
+                }
+            }
+            for (std::size_t i = 0; i < specs.size(); ++i) {
+                if (specs[i].name == name) {
+                    return static_cast<unsigned>(base + i);
+                }
+            }
+            return NO_SWITCH;
+        };
+
+        std::vector<unsigned char> onN(specs.size(), NO_SWITCH);
+        std::vector<unsigned char> onU(specs.size(), NO_SWITCH);
+        for (std::size_t i = 0; i < specs.size(); ++i) {
+            const VehicleSpec& spec = specs[i];
+            if (!Validate(spec, error)) {
+                return false;
+            }
+            if (find(spec.name) != base + i) {
+                error = "vehicle type " + spec.name + " is already defined";
+                return false;
+            }
+            onN[i] = static_cast<unsigned char>(find(spec.onN));
+            onU[i] = static_cast<unsigned char>(find(spec.onU));
+            if (!spec.onN.empty() && onN[i] == NO_SWITCH) {
+                error = spec.name + ": unknown on_n target " + spec.onN;
+                return false;
+            }
+            if (onU[i] == NO_SWITCH) {
+                error = spec.name + ": unknown on_u target " + spec.onU;
+                return false;
+            }
+        }
+
+        for (std::size_t i = 0; i < specs.size(); ++i) {
+            names[base + i] = specs[i].name;
+            Compile(specs[i], onN[i], onU[i], tables[base + i]);
+        }
+        count.store(base + specs.size(), std::memory_order_release);
+        return true;
+    }
+
+    std::size_t Count(void) const noexcept
+    {
+        return count.load(std::memory_order_acquire);
+    }
+
+    const VehicleTable& Table(const std::size_t index) const noexcept
+    {
+        return tables[index];
+    }
+
+    const std::string& Name(const std::size_t index) const noexcept
+    {
+        return names[index];
+    }
+
+private:
+    Registry(void)
+    {
+        std::string error;
+        Register(BuiltinSpecs(), error);
+    }
+
+    static bool Validate(const VehicleSpec& spec, std::string& error)
+    {
+        if (spec.name.empty() || spec.name.find_first_of(" \t[]#=") != std::string::npos) {
+            error = "invalid vehicle type name \"" + spec.name + "\"";
+            return false;
+        }
+        for (unsigned speed = 0; speed < 2; ++speed) {
+            if (spec.move[speed] > MAX_VEHICLE_STEPS || spec.turnBefore[speed] > MAX_VEHICLE_STEPS ||
+                spec.turnAfter[speed] > MAX_VEHICLE_STEPS) {
+                error = spec.name + ": step counts must not exceed " + std::to_string(MAX_VEHICLE_STEPS);
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::atomic<std::size_t> count{0};
+    std::string names[MAX_CAR_TYPES];
+    VehicleTable tables[MAX_CAR_TYPES];
+};
+
+std::string Trim(const std::string& text)
+{
+    const std::size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+bool ParsePair(const std::string& value, unsigned (&pair)[2])
+{
+    std::istringstream stream(value);
+    std::string rest;
+    return static_cast<bool>(stream >> pair[0] >> pair[1]) && !(stream >> rest);
+}
+}  // namespace
+
+bool RegisterVehicleTypes(const std::vector<VehicleSpec>& specs, std::string& error)
+{
+    return Registry::Instance().Register(specs, error);
+}
+
+bool ParseVehicleTypes(const std::string& text, std::vector<VehicleSpec>& specs, std::string& error)
+{
+    std::istringstream stream(text);
+    std::string line;
+    for (unsigned number = 1; std::getline(stream, line); ++number) {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        const std::string where = "line " + std::to_string(number) + ": ";
+        if (line.front() == '[') {
+            if (line.back() != ']') {
+                error = where + "unterminated section";
+                return false;
+            }
+            specs.emplace_back();
+            specs.back().name = Trim(line.substr(1, line.size() - 2));
+            continue;
+        }
+
+        const std::size_t equal = line.find('=');
+        if (equal == std::string::npos || specs.empty()) {
+            error = where + (specs.empty() ? "key outside of a [vehicle] section" : "expected key = value");
+            return false;
+        }
+        const std::string key = Trim(line.substr(0, equal));
+        const std::string value = Trim(line.substr(equal + 1));
+        VehicleSpec& spec = specs.back();
+        bool valid = true;
+        if (key == "move") {
+            valid = ParsePair(value, spec.move);
+        } else if (key == "turn_before") {
+            valid = ParsePair(value, spec.turnBefore);
+        } else if (key == "turn_after") {
+            valid = ParsePair(value, spec.turnAfter);
+        } else if (key == "on_n") {
+            spec.onN = value == "-" ? std::string() : value;
+        } else if (key == "on_u") {
+            spec.onU = value;
+        } else {
+            error = where + "unknown key " + key;
+            return false;
+        }
+        if (!valid) {
+            error = where + key + " expects two step counts";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LoadVehicleTypes(const std::string& path, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    std::vector<VehicleSpec> specs;
+    return ParseVehicleTypes(text.str(), specs, error) && RegisterVehicleTypes(specs, error);
+}
+
+bool FindCarType(const std::string& name, CarType& type) noexcept
+{
+    const Registry& registry = Registry::Instance();
+    const std::size_t count = registry.Count();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (registry.Name(i) == name) {
+            type = static_cast<CarType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* CarTypeName(const CarType carType) noexcept
+{
+    const Registry& registry = Registry::Instance();
+    const std::size_t index = static_cast<std::size_t>(carType);
+    return index < registry.Count() ? registry.Name(index).c_str() : "UNKNOWN";
+}
+
+std::size_t CarTypeCount(void) noexcept
+{
+    return Registry::Instance().Count();
+}
+
+const VehicleTable& TableOf(const CarType carType) noexcept
+{
+    const Registry& registry = Registry::Instance();
+    const std::size_t index = static_cast<std::size_t>(carType);
+    return registry.Table(index < registry.Count() ? index : 0);
+}
+
+unsigned HeadingIndex(const char heading) noexcept
+{
+    switch (heading) {
+    case 'E':
+        return 0;
+    case 'S':
+        return 1;
+    case 'W':
+        return 2;
+    default:
+        return 3;  // 非法朝向按N处理
+    }
+}
+}  // namespace adas
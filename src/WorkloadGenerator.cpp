@@ -0,0 +1,225 @@
+#include "WorkloadGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include "ParallelFor.hpp"
+
+namespace adas
+{
+namespace
+{
+constexpr std::uint64_t FIXED_ONE = 1ull << 32;
+constexpr char OPCODE_CHARS[] = {'M', 'L', 'R', 'F', 'B'};
+// 不含指令字符和T，避免与后续字符拼成TR
+constexpr char JUNK_CHARS[] = "ACDEGHIJKOPQSVWXYZ0123456789 ";
+constexpr std::size_t JUNK_COUNT = sizeof(JUNK_CHARS) - 1;
+
+std::uint64_t ToFixed(const double probability) noexcept
+{
+    if (!(probability > 0.0)) {
+        return 0;
+    }
+    return probability >= 1.0 ? FIXED_ONE : static_cast<std::uint64_t>(probability * FIXED_ONE);
+}
+
+std::uint64_t SplitMix(std::uint64_t& state) noexcept
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// weights中权重为0(或负数)的项不会被选中；全为0时固定选fallback
+template <std::size_t N>
+void BuildCumulative(const double (&weights)[N], const std::size_t fallback, std::uint64_t (&cumulative)[N]) noexcept
+{
+    double total = 0;
+    std::size_t last = N;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (weights[i] > 0) {
+            total += weights[i];
+            last = i;
+        }
+    }
+    double sum = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (last == N) {
+            cumulative[i] = i >= fallback ? FIXED_ONE : 0;
+            continue;
+        }
+        sum += std::max(weights[i], 0.0);
+        // 最后一个非零权重补满，避免浮点误差让区间末端落空
+        cumulative[i] = i >= last ? FIXED_ONE : ToFixed(sum / total);
+    }
+}
+
+constexpr unsigned TABLE_BITS = 10;
+
+// 成功概率为p时首次成功前的失败次数，logStay = log(1 - p)；draw的高53位映射到(0, 1]
+std::size_t Geometric(const std::uint64_t draw, const double logStay) noexcept
+{
+    if (logStay == 0.0) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    const double uniform = static_cast<double>((draw >> 11) + 1) * 0x1.0p-53;
+    const double failures = std::floor(std::log(uniform) / logStay);
+    return failures < 1e18 ? static_cast<std::size_t>(failures) : std::numeric_limits<std::size_t>::max();
+}
+
+template <std::size_t N>
+std::size_t Pick(const std::uint64_t (&cumulative)[N], const std::uint64_t draw) noexcept
+{
+    std::size_t i = 0;
+    while (i + 1 < N && draw >= cumulative[i]) {
+        ++i;
+    }
+    return i;
+}
+}  // namespace
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig& config) noexcept : config(config)
+{
+    if (this->config.chunkSize == 0) {
+        this->config.chunkSize = WorkloadConfig{}.chunkSize;
+    }
+
+    const double junk = std::max(config.junkRate, 0.0);
+    const double carTypeSwitch = std::max(config.carTypeSwitchRate, 0.0);
+    const double turnRound = std::max(config.turnRoundRate, 0.0);
+    const double insert = junk + carTypeSwitch + turnRound;
+    insertLogStay = insert > 0 ? std::log1p(-std::min(insert, 1.0)) : 0.0;
+    junkThreshold = insert > 0 ? ToFixed(junk / insert) : 0;
+    switchThreshold = insert > 0 ? ToFixed((junk + carTypeSwitch) / insert) : 0;
+    busThreshold = ToFixed(config.busShare);
+    runLogStay = config.meanRunLength > 1.0 ? std::log1p(-1.0 / config.meanRunLength) : -HUGE_VAL;
+    // 失败次数随随机数单调不增，区间两端相同则整个区间相同
+    for (std::uint64_t bucket = 0; bucket < (1u << TABLE_BITS); ++bucket) {
+        const std::uint64_t first = bucket << (64 - TABLE_BITS);
+        const std::uint64_t last = first | ((1ull << (64 - TABLE_BITS)) - 1);
+        const std::size_t low = Geometric(first, runLogStay);
+        const bool exact = low == Geometric(last, runLogStay) && low < UINT32_MAX;
+        runTable[bucket] = exact ? static_cast<std::uint32_t>(low + 1) : 0;
+    }
+
+    const double weights[OPCODES] = {config.mix.move, config.mix.left, config.mix.right, config.mix.fast,
+                                     config.mix.back};
+    BuildCumulative(weights, 0, startCumulative);
+    for (unsigned current = 0; current < OPCODES; ++current) {
+        double others[OPCODES];
+        std::copy(weights, weights + OPCODES, others);
+        others[current] = 0;
+        // 没有其他可选指令时保持当前指令
+        BuildCumulative(others, current, nextCumulative[current]);
+    }
+}
+
+std::size_t WorkloadGenerator::RunLength(const std::uint64_t draw) const noexcept
+{
+    const std::uint32_t length = runTable[draw >> (64 - TABLE_BITS)];
+    return length != 0 ? length : Geometric(draw, runLogStay) + 1;
+}
+
+void WorkloadGenerator::GenerateChunk(char* out, const std::uint64_t chunk, const std::size_t length) const noexcept
+{
+    std::uint64_t state = config.seed;
+    state = SplitMix(state) ^ (chunk * 0xD1B54A32D192ED03ull);
+    std::size_t current = Pick(startCumulative, SplitMix(state) >> 32);
+
+    // 按游程整段填充，每段只采样一次随机数
+    std::size_t runLeft = RunLength(SplitMix(state));
+    std::size_t untilInsert = Geometric(SplitMix(state), insertLogStay);
+    std::size_t i = 0;
+    while (i < length) {
+        if (untilInsert == 0) {
+            untilInsert = Geometric(SplitMix(state), insertLogStay);
+            const std::uint64_t draw = SplitMix(state);
+            const std::uint64_t high = draw >> 32;
+            const std::uint64_t low = draw & (FIXED_ONE - 1);
+            if (high < junkThreshold) {
+                out[i++] = JUNK_CHARS[low % JUNK_COUNT];
+                continue;
+            }
+            if (high < switchThreshold) {
+                out[i++] = low < busThreshold ? 'U' : 'N';
+                continue;
+            }
+            // TR不跨块，块尾放不下时改为普通指令
+            if (i + 1 < length) {
+                out[i++] = 'T';
+                out[i++] = 'R';
+                continue;
+            }
+            untilInsert = 1;
+        }
+
+        const std::size_t run = std::min({runLeft, untilInsert, length - i});
+        std::memset(out + i, OPCODE_CHARS[current], run);
+        i += run;
+        untilInsert -= run;
+        runLeft -= run;
+        if (runLeft == 0) {
+            current = Pick(nextCumulative[current], SplitMix(state) >> 32);
+            runLeft = RunLength(SplitMix(state));
+        }
+    }
+}
+
+void WorkloadGenerator::Generate(char* out, const std::size_t length, const unsigned threads) const
+{
+    const std::size_t chunkSize = config.chunkSize;
+    const std::size_t chunks = (length + chunkSize - 1) / chunkSize;
+    ParallelFor(chunks, threads, [this, out, length, chunkSize](const std::size_t chunk) {
+        const std::size_t offset = chunk * chunkSize;
+        GenerateChunk(out + offset, chunk, std::min(chunkSize, length - offset));
+    });
+}
+
+std::string WorkloadGenerator::Generate(const std::size_t length, const unsigned threads) const
+{
+    std::string commands(length, '\0');
+    Generate(&commands[0], length, threads);
+    return commands;
+}
+
+bool WorkloadGenerator::Write(std::FILE* file, const std::uint64_t length, const unsigned threads) const
+{
+    // 每轮每个线程生成若干块，写出后复用缓冲区
+    const std::size_t chunkSize = config.chunkSize;
+    const std::uint64_t blockChunks = static_cast<std::uint64_t>(ResolveThreads(threads)) * 4;
+    const std::uint64_t blockSize = std::min<std::uint64_t>(blockChunks * chunkSize, length);
+    std::unique_ptr<char[]> buffer(new (std::nothrow) char[blockSize == 0 ? 1 : blockSize]);
+    if (buffer == nullptr) {
+        return false;
+    }
+
+    for (std::uint64_t offset = 0; offset < length; offset += blockSize) {
+        const std::size_t size = static_cast<std::size_t>(std::min(blockSize, length - offset));
+        const std::uint64_t firstChunk = offset / chunkSize;
+        const std::size_t chunks = (size + chunkSize - 1) / chunkSize;
+        char* out = buffer.get();
+        ParallelFor(chunks, threads, [this, out, size, chunkSize, firstChunk](const std::size_t chunk) {
+            const std::size_t begin = chunk * chunkSize;
+            GenerateChunk(out + begin, firstChunk + chunk, std::min(chunkSize, size - begin));
+        });
+        if (std::fwrite(out, 1, size, file) != size) {
+            return false;
+        }
+    }
+    return std::fflush(file) == 0;
+}
+
+bool WorkloadGenerator::WriteFile(const std::string& path, const std::uint64_t length, const unsigned threads) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = Write(file, length, threads);
+    return std::fclose(file) == 0 && written;
+}
+}  // namespace adas
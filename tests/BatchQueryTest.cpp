@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "BatchQuery.hpp"
+#include "LazyExecutor.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+namespace
+{
+std::vector<std::unique_ptr<Executor>> MakeFleet(void)
+{
+    std::vector<std::unique_ptr<Executor>> fleet;
+    fleet.emplace_back(Executor::NewExecutor({0, 0, 'E'}));
+    fleet.emplace_back(Executor::NewExecutor({1, 2, 'N'}, {CarType::SPORTS, true, false}));
+    fleet.emplace_back(Executor::NewExecutor({-3, 4, 'S'}));
+    fleet[0]->Execute("MM");
+    fleet[1]->Execute("M");
+    fleet[2]->Execute("UB");
+    return fleet;
+}
+
+std::vector<const Executor*> Pointers(const std::vector<std::unique_ptr<Executor>>& fleet)
+{
+    std::vector<const Executor*> pointers;
+    for (const auto& executor : fleet) {
+        pointers.push_back(executor.get());
+    }
+    return pointers;
+}
+}  // namespace
+
+TEST(BatchQueryTest, should_fill_pose_span_same_as_query)
+{
+    // given
+    const auto fleet = MakeFleet();
+    const auto executors = Pointers(fleet);
+    std::vector<Pose> poses(fleet.size());
+
+    // when
+    QueryBatch(executors.data(), executors.size(), poses.data());
+
+    // then
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        ASSERT_EQ(fleet[i]->Query(), poses[i]);
+    }
+}
+
+TEST(BatchQueryTest, should_fill_columns_and_optional_mode)
+{
+    // given
+    const auto fleet = MakeFleet();
+    const auto executors = Pointers(fleet);
+    std::vector<int> x(fleet.size());
+    std::vector<int> y(fleet.size());
+    std::vector<char> heading(fleet.size());
+    std::vector<CarMode> modes(fleet.size());
+
+    // when
+    QueryBatch(executors.data(), executors.size(), PoseColumns{x.data(), y.data(), heading.data(), modes.data()});
+
+    // then
+    ASSERT_EQ(2, x[0]);
+    ASSERT_EQ(0, y[0]);
+    ASSERT_EQ('E', heading[0]);
+    ASSERT_EQ(6, y[1]);
+    ASSERT_EQ(CarType::SPORTS, modes[1].carType);
+    ASSERT_TRUE(modes[1].fast);
+    ASSERT_EQ(CarType::BUS, modes[2].carType);
+    ASSERT_TRUE(modes[2].reverse);
+    ASSERT_FALSE(modes[2].fast);
+}
+
+TEST(BatchQueryTest, should_flush_lazy_executors_mixed_with_eager_ones)
+{
+    // given
+    auto fleet = MakeFleet();
+    fleet.emplace_back(LazyExecutor::NewLazyExecutor({5, 5, 'W'}, {CarType::BUS, false, false}));
+    fleet.back()->Execute("MMTRM");
+    fleet.emplace_back(Executor::NewExecutor({5, 5, 'W'}, {CarType::BUS, false, false}));
+    fleet.back()->Execute("MMTRM");
+    const auto executors = Pointers(fleet);
+    std::vector<Pose> poses(fleet.size());
+    std::vector<CarMode> modes(fleet.size());
+
+    // when
+    QueryBatch(executors.data(), executors.size(), poses.data(), modes.data());
+
+    // then
+    const LazyExecutor& lazy = static_cast<const LazyExecutor&>(*fleet[3]);
+    ASSERT_EQ(0u, lazy.PendingBytes());
+    ASSERT_EQ(fleet[4]->Query(), poses[3]);
+    ASSERT_EQ(CarType::BUS, modes[3].carType);
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        ASSERT_EQ(fleet[i]->Query(), poses[i]);
+    }
+}
+}  // namespace adas
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "CommandScanner.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+const ScanIsa ALL_ISAS[] = {ScanIsa::SCALAR, ScanIsa::SSE2, ScanIsa::AVX2};
+
+// 长游程、夹杂未知字符和车型切换的指令串，覆盖跨块游程
+std::string LongRunCommands(const std::uint64_t seed, const std::size_t length)
+{
+    WorkloadConfig config;
+    config.seed = seed;
+    config.meanRunLength = 48.0;
+    config.junkRate = 0.002;
+    config.carTypeSwitchRate = 0.003;
+    config.turnRoundRate = 0.01;
+    config.chunkSize = 997;
+    std::string commands = WorkloadGenerator(config).Generate(length, 1);
+    commands.replace(100, 80, std::string(80, 'X'));
+    return commands;
+}
+
+bool IsJunk(const std::string& commands, const std::size_t i)
+{
+    const char c = commands[i];
+    if (c == 'T') {
+        return i + 1 >= commands.size() || commands[i + 1] != 'R';
+    }
+    return std::string("MLRFBNU").find(c) == std::string::npos;
+}
+}  // namespace
+
+TEST(CommandScannerTest, should_classify_block_into_opcode_masks)
+{
+    // given
+    const std::string block = "MLRFBNUTRTXM";
+
+    for (const ScanIsa isa : ALL_ISAS) {
+        // when
+        ClassMasks masks;
+        CommandScanner(isa).Classify(block.data(), block.size(), false, false, masks);
+
+        // then
+        ASSERT_EQ(0b100000000001u, masks.move);
+        ASSERT_EQ(0b000000000110u, masks.turn);
+        ASSERT_EQ(0b000000011000u, masks.toggle);
+        ASSERT_EQ(0b000001100000u, masks.carSwitch);
+        ASSERT_EQ(0b000010000000u, masks.turnRound);
+        ASSERT_EQ(0b011000000000u, masks.junk);
+    }
+}
+
+TEST(CommandScannerTest, should_pair_turn_round_across_blocks)
+{
+    // given
+    const std::string commands = std::string(63, 'L') + "TR" + std::string(10, 'M');
+
+    // when
+    ClassMasks first;
+    ClassMasks second;
+    const CommandScanner scanner;
+    scanner.Classify(commands.data(), 64, false, true, first);
+    scanner.Classify(commands.data() + 64, commands.size() - 64, true, false, second);
+
+    // then
+    ASSERT_EQ(1ull << 63, first.turnRound);
+    ASSERT_EQ(0u, first.junk);
+    ASSERT_EQ(0u, second.turn & 1);
+    ASSERT_EQ(0u, second.junk);
+}
+
+TEST(CommandScannerTest, should_split_on_switches_and_long_runs)
+{
+    // given
+    const std::string commands = std::string(40, 'M') + "LTRN" + std::string(70, 'X') + "MMU" + std::string(32, 'M');
+
+    // when
+    const std::vector<CommandSegment> segments = CommandScanner().Segments(commands.data(), commands.size());
+
+    // then
+    ASSERT_EQ(7u, segments.size());
+    ASSERT_EQ(SegmentKind::MOVES, segments[0].kind);
+    ASSERT_EQ(40u, segments[0].length);
+    ASSERT_EQ(SegmentKind::MIXED, segments[1].kind);
+    ASSERT_EQ(3u, segments[1].length);
+    ASSERT_EQ(SegmentKind::SWITCH, segments[2].kind);
+    ASSERT_EQ(SegmentKind::SKIP, segments[3].kind);
+    ASSERT_EQ(70u, segments[3].length);
+    ASSERT_EQ(SegmentKind::MIXED, segments[4].kind);
+    ASSERT_EQ(SegmentKind::SWITCH, segments[5].kind);
+    ASSERT_EQ(SegmentKind::MOVES, segments[6].kind);
+    ASSERT_EQ(32u, segments[6].length);
+}
+
+TEST(CommandScannerTest, all_isas_should_produce_same_homogeneous_segments)
+{
+    for (std::uint64_t seed = 1; seed <= 4; ++seed) {
+        // given
+        const std::string commands = LongRunCommands(seed, 20000 + seed * 37);
+        const std::vector<CommandSegment> expected =
+            CommandScanner(ScanIsa::SCALAR).Segments(commands.data(), commands.size());
+
+        // then
+        std::size_t offset = 0;
+        for (const CommandSegment& segment : expected) {
+            ASSERT_EQ(offset, segment.offset);
+            offset += segment.length;
+            for (std::size_t i = segment.offset; i < offset; ++i) {
+                if (segment.kind == SegmentKind::MOVES) {
+                    ASSERT_EQ('M', commands[i]);
+                } else if (segment.kind == SegmentKind::SKIP) {
+                    ASSERT_TRUE(IsJunk(commands, i));
+                } else if (segment.kind == SegmentKind::SWITCH) {
+                    ASSERT_EQ(1u, segment.length);
+                } else {
+                    ASSERT_NE('N', commands[i]);
+                    ASSERT_NE('U', commands[i]);
+                }
+            }
+            ASSERT_FALSE(offset < commands.size() && commands[offset - 1] == 'T' && commands[offset] == 'R');
+        }
+        ASSERT_EQ(commands.size(), offset);
+        for (const ScanIsa isa : ALL_ISAS) {
+            const std::vector<CommandSegment> actual = CommandScanner(isa).Segments(commands.data(), commands.size());
+            ASSERT_EQ(expected.size(), actual.size());
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(expected[i].offset, actual[i].offset);
+                ASSERT_EQ(expected[i].kind, actual[i].kind);
+            }
+        }
+    }
+}
+
+}  // namespace adas
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CommandServer.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+namespace
+{
+// 在后台线程上运行的服务，析构时停止
+class RunningServer final
+{
+public:
+    explicit RunningServer(const CommandServerOptions& options) : server(options)
+    {
+        listening = server.Listen();
+        if (listening) {
+            loop = std::thread([this] { server.Run(); });
+        }
+    }
+    ~RunningServer()
+    {
+        if (listening) {
+            server.Stop();
+            loop.join();
+        }
+    }
+
+    CommandServer server;
+    bool listening;
+    std::thread loop;
+};
+
+int ConnectUnix(const std::string& path)
+{
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+    return ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0 ? fd : -1;
+}
+
+int ConnectTcp(const std::uint16_t port)
+{
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0 ? fd : -1;
+}
+
+bool SendAll(const int fd, const char* data, std::size_t size)
+{
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+std::vector<Response> Receive(const int fd, const std::size_t count)
+{
+    std::vector<Response> responses(count);
+    char* data = reinterpret_cast<char*>(responses.data());
+    std::size_t size = count * sizeof(Response);
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, data, size, 0);
+        if (received <= 0) {
+            responses.resize(count - size / sizeof(Response));
+            break;
+        }
+        data += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return responses;
+}
+
+std::string SocketPath(const char* name)
+{
+    return "/tmp/training_server_test_" + std::to_string(::getpid()) + "_" + name;
+}
+}  // namespace
+
+TEST(CommandServerTest, should_reply_with_poses_in_request_order)
+{
+    // given
+    CommandServerOptions options;
+    options.unixPath = SocketPath("order");
+    RunningServer running(options);
+    ASSERT_TRUE(running.listening);
+    const int fd = ConnectUnix(options.unixPath);
+    ASSERT_GE(fd, 0);
+    const CarMode sports{CarType::SPORTS, false, false};
+    std::string frames;
+    AppendReset(frames, 7, 1, {1, 2, 'E'}, sports);
+    AppendExecute(frames, 7, 2, "MMFM");
+    AppendExecute(frames, 9, 3, "RM");
+    AppendRequest(frames, FrameType::QUERY, 8, 4);
+    AppendRequest(frames, FrameType::REMOVE, 7, 5);
+    AppendRequest(frames, FrameType::QUERY, 7, 6);
+    AppendRequest(frames, static_cast<FrameType>(99), 9, 7);
+
+    // when: 所有请求一次发出，不等应答
+    ASSERT_TRUE(SendAll(fd, frames.data(), frames.size()));
+    const std::vector<Response> responses = Receive(fd, 7);
+    ::close(fd);
+
+    // then
+    ASSERT_EQ(7u, responses.size());
+    for (std::uint64_t i = 0; i < responses.size(); ++i) {
+        ASSERT_EQ(i + 1, responses[i].tag);
+    }
+    std::unique_ptr<Executor> seven(Executor::NewExecutor({1, 2, 'E'}, sports));
+    seven->Execute("MMFM");
+    std::unique_ptr<Executor> nine(Executor::NewExecutor());
+    nine->Execute("RM");
+    const Pose reset{1, 2, 'E'};
+    ASSERT_EQ(reset, PoseOf(responses[0]));
+    ASSERT_EQ(CarType::SPORTS, ModeOf(responses[0]).carType);
+    ASSERT_EQ(seven->Query(), PoseOf(responses[1]));
+    ASSERT_TRUE(ModeOf(responses[1]).fast);
+    ASSERT_EQ(nine->Query(), PoseOf(responses[2]));
+    ASSERT_EQ(static_cast<std::uint16_t>(FrameStatus::UNKNOWN_VEHICLE), responses[3].status);
+    ASSERT_EQ(static_cast<std::uint16_t>(FrameStatus::OK), responses[4].status);
+    ASSERT_EQ(seven->Query(), PoseOf(responses[4]));
+    ASSERT_EQ(static_cast<std::uint16_t>(FrameStatus::UNKNOWN_VEHICLE), responses[5].status);
+    ASSERT_EQ(static_cast<std::uint16_t>(FrameStatus::BAD_FRAME), responses[6].status);
+}
+
+TEST(CommandServerTest, should_serve_many_connections_with_split_frames)
+{
+    // given
+    RunningServer running(CommandServerOptions{});
+    ASSERT_TRUE(running.listening);
+    const int connections = 300;
+    const int batches = 4;
+    std::mt19937 random(29);
+    std::vector<int> fds;
+    std::vector<std::string> frames(connections);
+    std::vector<std::unique_ptr<Executor>> expected;
+    for (int i = 0; i < connections; ++i) {
+        fds.push_back(ConnectTcp(running.server.Port()));
+        ASSERT_GE(fds.back(), 0);
+        expected.emplace_back(Executor::NewExecutor());
+        for (int batch = 0; batch < batches; ++batch) {
+            std::string commands;
+            for (std::size_t n = random() % 40; n > 0; --n) {
+                commands += "MMLRFBNU"[random() % 8];
+            }
+            AppendExecute(frames[i], static_cast<std::uint64_t>(i) + 1, static_cast<std::uint64_t>(batch), commands);
+            expected[i]->Execute(commands);
+        }
+    }
+
+    // when: 各连接交替发送，帧在任意位置被切开
+    std::vector<std::size_t> sent(connections, 0);
+    for (bool pending = true; pending;) {
+        pending = false;
+        for (int i = 0; i < connections; ++i) {
+            const std::size_t piece = std::min<std::size_t>(random() % 17 + 1, frames[i].size() - sent[i]);
+            ASSERT_TRUE(SendAll(fds[i], frames[i].data() + sent[i], piece));
+            sent[i] += piece;
+            pending = pending || sent[i] < frames[i].size();
+        }
+    }
+
+    // then
+    for (int i = 0; i < connections; ++i) {
+        const std::vector<Response> responses = Receive(fds[i], batches);
+        ASSERT_EQ(static_cast<std::size_t>(batches), responses.size());
+        ASSERT_EQ(static_cast<std::uint64_t>(i) + 1, responses.back().vehicle);
+        ASSERT_EQ(expected[i]->Query(), PoseOf(responses.back()));
+        ::close(fds[i]);
+    }
+
+    // when: 负载超长的帧
+    const int fd = ConnectTcp(running.server.Port());
+    const RequestHeader oversized{MAX_FRAME_PAYLOAD + 1, static_cast<std::uint16_t>(FrameType::EXECUTE), 0, 1, 0};
+    ASSERT_TRUE(SendAll(fd, reinterpret_cast<const char*>(&oversized), sizeof(oversized)));
+
+    // then: 服务端关闭连接
+    char byte;
+    ASSERT_EQ(0, ::recv(fd, &byte, 1, 0));
+    ::close(fd);
+}
+
+TEST(CommandServerTest, should_not_lose_responses_when_client_reads_slowly)
+{
+    // given: 应答总量超过服务端暂停读取的积压上限
+    CommandServerOptions options;
+    options.unixPath = SocketPath("slow");
+    RunningServer running(options);
+    ASSERT_TRUE(running.listening);
+    const int fd = ConnectUnix(options.unixPath);
+    ASSERT_GE(fd, 0);
+    const std::uint64_t count = 100000;
+    std::string frames;
+    for (std::uint64_t tag = 0; tag < count; ++tag) {
+        AppendExecute(frames, 1, tag, "M");
+    }
+
+    // when
+    std::thread writer([fd, &frames] { SendAll(fd, frames.data(), frames.size()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const std::vector<Response> responses = Receive(fd, count);
+    writer.join();
+    ::close(fd);
+
+    // then
+    ASSERT_EQ(count, responses.size());
+    for (std::uint64_t tag = 0; tag < count; ++tag) {
+        ASSERT_EQ(tag, responses[tag].tag);
+    }
+    const Pose target{0, static_cast<int>(count), 'N'};
+    ASSERT_EQ(target, PoseOf(responses.back()));
+}
+}  // namespace adas
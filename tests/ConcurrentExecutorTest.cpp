@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentExecutor.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+TEST(ConcurrentExecutorTest, drain_should_execute_batches_in_submit_order)
+{
+    // given
+    ConcurrentExecutor executor;
+    ASSERT_TRUE(executor.Submit("MM"));
+    ASSERT_TRUE(executor.Submit("R"));
+    ASSERT_TRUE(executor.Submit("M"));
+
+    // when
+    const std::size_t drained = executor.Drain();
+
+    // then
+    ASSERT_EQ(3u, drained);
+    ASSERT_EQ(3u, executor.Executed());
+    const Pose target{1, 2, 'E'};
+    ASSERT_EQ(target, executor.Vehicle().Query());
+    ASSERT_EQ(0u, executor.Drain());
+}
+
+TEST(ConcurrentExecutorTest, producers_should_not_lose_batches_with_manual_drain)
+{
+    // given
+    ConcurrentExecutor executor;
+    const int producers = 4;
+    const int batches = 5000;
+
+    // when: 消费者与生产者同时运行
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&executor, p] {
+            for (int i = 0; i < batches; ++i) {
+                executor.Submit(std::string(static_cast<std::size_t>(p + 1), 'M'));
+            }
+        });
+    }
+    std::uint64_t drained = 0;
+    while (drained < static_cast<std::uint64_t>(producers * batches)) {
+        drained += executor.Drain();
+        std::this_thread::yield();
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // then
+    const Pose target{0, (1 + 2 + 3 + 4) * batches, 'N'};
+    ASSERT_EQ(target, executor.Vehicle().Query());
+    ASSERT_EQ(static_cast<std::uint64_t>(producers * batches), executor.QueueLatency().Count());
+}
+
+TEST(ConcurrentExecutorTest, background_consumer_should_wake_and_finish_on_stop)
+{
+    // given
+    ConcurrentExecutor executor({0, 0, 'E'});
+    ASSERT_TRUE(executor.Start());
+    ASSERT_FALSE(executor.Start());
+
+    // when: 先等消费者睡眠，再分两批提交
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    executor.Submit("M");
+    while (executor.Executed() < 1) {
+        std::this_thread::yield();
+    }
+    std::vector<std::thread> threads;
+    for (int p = 0; p < 3; ++p) {
+        threads.emplace_back([&executor] {
+            for (int i = 0; i < 1000; ++i) {
+                executor.Submit("M");
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    executor.Stop();
+
+    // then
+    ASSERT_EQ(3001u, executor.Executed());
+    const Pose target{3001, 0, 'E'};
+    ASSERT_EQ(target, executor.Vehicle().Query());
+}
+}  // namespace adas
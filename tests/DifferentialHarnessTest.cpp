@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "DifferentialHarness.hpp"
+#include "PoseEq.hpp"
+#include "ReferenceExecutor.hpp"
+#include "StateMachineEvaluator.hpp"
+
+namespace adas
+{
+namespace
+{
+// 故意出错的引擎：Bus状态下把TR当作未知字符
+EngineState RunBusIgnoringTurnRound(const EngineState& initial, const std::string& commands)
+{
+    ReferenceExecutor executor(initial.pose, initial.mode);
+    for (const std::string& token : Tokenize(commands)) {
+        if (token != "TR" || executor.QueryMode().carType != CarType::BUS) {
+            executor.Execute(token);
+        }
+    }
+    return EngineState{executor.Query(), executor.QueryMode()};
+}
+}  // namespace
+
+TEST(ReferenceExecutorTest, should_keep_quirky_turn_semantics)
+{
+    // given
+    ReferenceExecutor sports({0, 0, 'E'}, {CarType::SPORTS, true, false});
+    ReferenceExecutor bus({0, 0, 'E'}, {CarType::BUS, false, true});
+
+    // when
+    sports.Execute("L");
+    bus.Execute("L");
+
+    // then
+    ASSERT_EQ(Pose({1, 1, 'N'}), sports.Query());
+    ASSERT_EQ(Pose({-1, 0, 'S'}), bus.Query());
+}
+
+TEST(DifferentialHarnessTest, should_tokenize_turn_round_as_one_step)
+{
+    // when
+    const std::vector<std::string> tokens = Tokenize("TTRMT");
+
+    // then
+    ASSERT_EQ((std::vector<std::string>{"T", "TR", "M", "T"}), tokens);
+}
+
+TEST(DifferentialHarnessTest, builtin_engines_should_cover_every_execution_path)
+{
+    // given: 每种CPU支持的向量化实现各一个引擎
+    std::vector<std::string> expected{"Executor", "ExecutorPool", "LazyExecutor", "ExecuteSome",
+                                      "ExecuteWithin", "Executor/ObstacleMap", "Executor/Listener",
+                                      "Executor/SCALAR"};
+    if (BestEvaluatorIsa() != EvaluatorIsa::SCALAR) {
+        expected.push_back("Executor/SSSE3");
+    }
+    if (BestEvaluatorIsa() == EvaluatorIsa::AVX2) {
+        expected.push_back("Executor/AVX2");
+    }
+
+    // when
+    const std::vector<std::string> names = DifferentialHarness::WithBuiltinEngines().EngineNames();
+
+    // then
+    ASSERT_EQ(expected, names);
+}
+
+TEST(DifferentialHarnessTest, builtin_engines_should_agree_with_reference)
+{
+    // given
+    const DifferentialHarness harness = DifferentialHarness::WithBuiltinEngines();
+    DifferentialOptions options;
+    options.cases = 2000;
+    options.threads = 2;
+
+    // when
+    const DifferentialReport report = harness.Run(options);
+
+    // then
+    ASSERT_TRUE(report.divergences.empty()) << FormatDivergence(report.divergences.front());
+    ASSERT_GT(report.commands, 0u);
+}
+
+TEST(DifferentialHarnessTest, should_report_first_diverging_step_and_minimal_reproducer)
+{
+    // given
+    DifferentialHarness harness;
+    harness.AddEngine("broken", RunBusIgnoringTurnRound);
+
+    // when
+    const std::vector<Divergence> divergences = harness.Check({{0, 0, 'N'}, CarMode{}}, "MMLTRUMMRTRFMTRL");
+
+    // then
+    ASSERT_EQ(1u, divergences.size());
+    const Divergence& divergence = divergences.front();
+    ASSERT_EQ("broken", divergence.engine);
+    ASSERT_EQ(8u, divergence.step);
+    ASSERT_EQ(9u, divergence.offset);
+    ASSERT_EQ("TR", divergence.token);
+    ASSERT_FALSE(SameState(divergence.expected, divergence.actual));
+    ASSERT_EQ("UTR", divergence.reproducer);
+}
+
+TEST(DifferentialHarnessTest, random_run_should_catch_broken_engine)
+{
+    // given
+    DifferentialHarness harness = DifferentialHarness::WithBuiltinEngines();
+    harness.AddEngine("broken", RunBusIgnoringTurnRound);
+    DifferentialOptions options;
+    options.cases = 5000;
+    options.threads = 2;
+
+    // when
+    const DifferentialReport report = harness.Run(options);
+
+    // then
+    ASSERT_EQ(1u, report.divergences.size());
+    ASSERT_EQ("broken", report.divergences.front().engine);
+    ASSERT_LE(report.divergences.front().reproducer.size(), 3u);
+}
+}  // namespace adas
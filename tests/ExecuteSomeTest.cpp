@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include "Executor.hpp"
+#include "ExecutorMetrics.hpp"
+#include "ExecutorPool.hpp"
+#include "LazyExecutor.hpp"
+#include "PoseEq.hpp"
+#include "RoundRobinScheduler.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+std::string TestCommands(void)
+{
+    WorkloadConfig config;
+    config.turnRoundRate = 0.05;
+    config.junkRate = 0.01;
+    config.carTypeSwitchRate = 0.01;
+    return WorkloadGenerator(config).Generate(5000, 1) + "MT";
+}
+
+void ExpectSameCounters(const ExecutorCounters& expected, const ExecutorCounters& actual)
+{
+    for (std::size_t i = 0; i < ExecutorCounters::SIZE; ++i) {
+        ASSERT_EQ(expected.values[i], actual.values[i]) << "counter " << i;
+    }
+}
+}  // namespace
+
+TEST(ExecuteSomeTest, slices_should_match_single_execute)
+{
+    // given
+    const std::string commands = TestCommands();
+    std::unique_ptr<Executor> expected(Executor::NewExecutor({0, 0, 'N'}, {CarType::SPORTS, true, false}));
+    expected->Execute(commands);
+
+    for (const std::size_t budget : {1u, 2u, 3u, 63u, 64u, 100u, 4096u}) {
+        std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'N'}, {CarType::SPORTS, true, false}));
+        ExecuteCursor cursor(commands);
+
+        // when
+        std::size_t executed = 0;
+        while (!cursor.Done()) {
+            const std::size_t count = executor->ExecuteSome(cursor, budget);
+            ASSERT_LE(count, budget);
+            ASSERT_TRUE(cursor.offset == 0 || commands[cursor.offset - 1] != 'T' || commands[cursor.offset] != 'R');
+            executed += count;
+        }
+
+        // then
+        ASSERT_EQ(expected->Query(), executor->Query()) << budget;
+        ASSERT_EQ(expected->QueryMode().carType, executor->QueryMode().carType);
+        ExpectSameCounters(expected->QueryCounters(), executor->QueryCounters());
+        const ExecutorCounters counters = executor->QueryCounters();
+        ASSERT_EQ(commands.size() - counters[ExecutorCounter::COMMAND_TR] -
+                      counters[ExecutorCounter::TR_IGNORED_IN_REVERSE],
+                  executed);
+    }
+}
+
+TEST(ExecuteSomeTest, turn_round_should_not_be_split_by_budget)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    const std::string commands = "MTRM";
+    ExecuteCursor cursor(commands);
+
+    // when
+    const std::size_t first = executor->ExecuteSome(cursor, 2);
+
+    // then
+    ASSERT_EQ(2u, first);
+    ASSERT_EQ(3u, cursor.offset);
+    const Pose target{-1, 1, 'S'};
+    ASSERT_EQ(target, executor->Query());
+    ASSERT_EQ(0u, executor->QueryCounters()[ExecutorCounter::EXECUTE_CALLS]);
+    ASSERT_EQ(1u, executor->ExecuteSome(cursor, 2));
+    ASSERT_TRUE(cursor.Done());
+    ASSERT_EQ(1u, executor->QueryCounters()[ExecutorCounter::EXECUTE_CALLS]);
+    ASSERT_EQ(0u, executor->ExecuteSome(cursor, 2));
+}
+
+TEST(ExecuteSomeTest, empty_string_should_count_one_execute)
+{
+    // given
+    std::unique_ptr<Executor> executor(LazyExecutor::NewLazyExecutor());
+    const std::string commands;
+    ExecuteCursor cursor(commands);
+
+    // when
+    executor->ExecuteSome(cursor, 10);
+
+    // then
+    ASSERT_TRUE(cursor.Done());
+    ASSERT_EQ(1u, executor->QueryCounters()[ExecutorCounter::EXECUTE_CALLS]);
+}
+
+TEST(ExecuteSomeTest, scheduler_should_not_let_long_string_block_others)
+{
+    // given
+    RoundRobinScheduler scheduler(100);
+    std::unique_ptr<Executor> busy(Executor::NewExecutor());
+    std::unique_ptr<Executor> light(Executor::NewExecutor());
+    ASSERT_TRUE(scheduler.Submit(*busy, std::string(100000, 'M')));
+    ASSERT_TRUE(scheduler.Submit(*light, "MMM"));
+    ASSERT_TRUE(scheduler.Submit(*light, "L"));
+
+    // when
+    const std::size_t executed = scheduler.RunRound();
+
+    // then
+    ASSERT_EQ(103u, executed);
+    const Pose lightAfterRound{0, 3, 'N'};
+    ASSERT_EQ(lightAfterRound, light->Query());
+    ASSERT_EQ(2u, scheduler.ActiveExecutors());
+    scheduler.RunRound();
+    ASSERT_EQ(1u, scheduler.ActiveExecutors());
+    scheduler.RunAll();
+    ASSERT_TRUE(scheduler.Idle());
+    const Pose busyTarget{0, 100000, 'N'};
+    const Pose lightTarget{0, 3, 'W'};
+    ASSERT_EQ(busyTarget, busy->Query());
+    ASSERT_EQ(lightTarget, light->Query());
+}
+
+TEST(ExecuteSomeTest, run_until_should_stop_at_deadline_and_resume)
+{
+    // given
+    RoundRobinScheduler scheduler(1000);
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    ASSERT_TRUE(scheduler.Submit(*executor, std::string(50000, 'M')));
+
+    // when
+    const std::size_t none = scheduler.RunUntil(std::chrono::steady_clock::now());
+    const std::size_t rest = scheduler.RunUntil(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+
+    // then
+    ASSERT_EQ(0u, none);
+    ASSERT_EQ(50000u, rest);
+    const Pose target{0, 50000, 'N'};
+    ASSERT_EQ(target, executor->Query());
+}
+
+TEST(ExecuteSomeTest, remove_should_drop_pending_tasks_of_one_executor)
+{
+    // given
+    RoundRobinScheduler scheduler(10);
+    std::unique_ptr<Executor> removed(Executor::NewExecutor());
+    std::unique_ptr<Executor> kept(Executor::NewExecutor());
+    ASSERT_TRUE(scheduler.Submit(*removed, std::string(25, 'M')));
+    ASSERT_TRUE(scheduler.Submit(*removed, "L"));
+    ASSERT_TRUE(scheduler.Submit(*kept, std::string(25, 'M')));
+    scheduler.RunRound();
+
+    // when
+    const std::size_t dropped = scheduler.Remove(*removed);
+
+    // then
+    ASSERT_EQ(2u, dropped);
+    ASSERT_EQ(0u, scheduler.Remove(*removed));
+    ASSERT_EQ(1u, scheduler.ActiveExecutors());
+    scheduler.RunAll();
+    const Pose removedTarget{0, 10, 'N'};
+    const Pose keptTarget{0, 25, 'N'};
+    ASSERT_EQ(removedTarget, removed->Query());
+    ASSERT_EQ(keptTarget, kept->Query());
+}
+
+TEST(ExecuteSomeTest, scheduler_should_forget_drained_executors_returned_to_pool)
+{
+    // given: 池把归还的执行器交给下一次Acquire，地址相同
+    RoundRobinScheduler scheduler(4);
+    ExecutorPool pool(1);
+    ExecutorPool::Handle first = pool.Acquire({0, 0, 'N'});
+    Executor* address = first.get();
+    ASSERT_TRUE(scheduler.Submit(*first, "MMMMMM"));
+    scheduler.RunAll();
+    first.reset();
+
+    // when
+    ExecutorPool::Handle second = pool.Acquire({5, 5, 'E'});
+    ASSERT_EQ(address, second.get());
+    ASSERT_TRUE(scheduler.Submit(*second, "MM"));
+    ExecutorPool::Handle third = pool.Acquire({0, 0, 'S'});
+    ASSERT_TRUE(scheduler.Submit(*third, "MMMMMM"));
+    scheduler.RunAll();
+
+    // then
+    const Pose secondTarget{7, 5, 'E'};
+    const Pose thirdTarget{0, -6, 'S'};
+    ASSERT_EQ(secondTarget, second->Query());
+    ASSERT_EQ(thirdTarget, third->Query());
+    ASSERT_TRUE(scheduler.Idle());
+}
+}  // namespace adas
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include "Executor.hpp"
+#include "ExecutorPool.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+// 直接构造的执行器应与回放切换指令得到的执行器行为一致
+TEST(ExecutorCarModeTest, sports_fast_reverse_should_behave_like_replaying_NFB)
+{
+    // given
+    std::unique_ptr<Executor> replayed(Executor::NewExecutor({0, 0, 'E'}));
+    replayed->Execute("NFB");
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}, {CarType::SPORTS, true, true}));
+
+    // when
+    replayed->Execute("MLMR");
+    executor->Execute("MLMR");
+
+    // then
+    ASSERT_EQ(replayed->Query(), executor->Query());
+}
+
+TEST(ExecutorCarModeTest, bus_fast_M_should_move_2_blocks)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'N'}, {CarType::BUS, true, false}));
+
+    // when
+    executor->Execute("M");
+
+    // then
+    const Pose target{0, 2, 'N'};
+    ASSERT_EQ(target, executor->Query());
+}
+
+TEST(ExecutorCarModeTest, bus_should_ignore_N_when_constructed_as_bus)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}, {CarType::BUS, false, false}));
+
+    // when
+    executor->Execute("NL");
+
+    // then
+    const Pose target{1, 0, 'N'};
+    ASSERT_EQ(target, executor->Query());
+}
+
+TEST(ExecutorCarModeTest, switching_car_type_should_clear_initial_fast_state)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}, {CarType::NORMAL, true, false}));
+
+    // when
+    executor->Execute("NM");
+
+    // then
+    const Pose target{2, 0, 'E'};
+    ASSERT_EQ(target, executor->Query());
+}
+
+TEST(ExecutorCarModeTest, pool_should_reset_executor_into_requested_mode)
+{
+    // given
+    ExecutorPool pool(1);
+    pool.Acquire({0, 0, 'E'}, {CarType::BUS, false, false}).reset();
+
+    // when
+    ExecutorPool::Handle executor = pool.Acquire({0, 0, 'E'}, {CarType::SPORTS, false, true});
+    executor->Execute("M");
+
+    // then
+    const Pose target{-2, 0, 'E'};
+    ASSERT_EQ(target, executor->Query());
+}
+}  // namespace adas
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "Executor.hpp"
+#include "ExecutorListener.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+namespace
+{
+class RecordingListener final : public ExecutorListener
+{
+public:
+    void OnEvents(const ExecutorEvent* events, const std::size_t count) noexcept override
+    {
+        ++batches;
+        this->events.insert(this->events.end(), events, events + count);
+    }
+
+    std::vector<ExecutorEvent> events;
+    int batches{0};
+};
+}  // namespace
+
+TEST(ExecutorListenerTest, should_coalesce_consecutive_moves_into_one_event)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}));
+    RecordingListener listener;
+    executor->SetListener(&listener);
+
+    // when
+    executor->Execute("MMMM");
+
+    // then
+    ASSERT_EQ(1, listener.batches);
+    ASSERT_EQ(1u, listener.events.size());
+    ASSERT_EQ(ExecutorEventType::MOVE, listener.events[0].type);
+    ASSERT_EQ(4u, listener.events[0].repeat);
+    const Pose from{0, 0, 'E'};
+    const Pose to{4, 0, 'E'};
+    ASSERT_EQ(from, listener.events[0].from);
+    ASSERT_EQ(to, listener.events[0].to);
+}
+
+TEST(ExecutorListenerTest, should_report_turn_mode_toggle_and_car_type_switch)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}));
+    RecordingListener listener;
+    executor->SetListener(&listener);
+
+    // when
+    executor->Execute("LFUTR");
+
+    // then
+    ASSERT_EQ(4u, listener.events.size());
+    ASSERT_EQ(ExecutorEventType::TURN, listener.events[0].type);
+    ASSERT_EQ(ExecutorEventType::MODE_TOGGLE, listener.events[1].type);
+    ASSERT_TRUE(listener.events[1].mode.fast);
+    ASSERT_EQ(ExecutorEventType::CAR_TYPE_SWITCH, listener.events[2].type);
+    ASSERT_EQ(CarType::BUS, listener.events[2].mode.carType);
+    ASSERT_EQ(ExecutorEventType::TURN, listener.events[3].type);
+    ASSERT_EQ('T', listener.events[3].command);
+}
+
+TEST(ExecutorListenerTest, should_not_report_refused_or_ignored_commands)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}, {CarType::BUS, false, true}));
+    RecordingListener listener;
+    executor->SetListener(&listener);
+
+    // when
+    executor->Execute("NTRX");
+
+    // then
+    ASSERT_TRUE(listener.events.empty());
+    ASSERT_EQ(0, listener.batches);
+}
+
+TEST(ExecutorListenerTest, should_stop_reporting_after_listener_removed)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}));
+    RecordingListener listener;
+    executor->SetListener(&listener);
+    executor->Execute("M");
+
+    // when
+    executor->SetListener(nullptr);
+    executor->Execute("M");
+
+    // then
+    ASSERT_EQ(1u, listener.events.size());
+    const Pose target{2, 0, 'E'};
+    ASSERT_EQ(target, executor->Query());
+}
+}  // namespace adas
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include "Executor.hpp"
+#include "ExecutorMetrics.hpp"
+
+namespace adas
+{
+TEST(ExecutorMetricsTest, should_count_commands_by_opcode_and_skipped_ones)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}));
+
+    // when
+    executor->Execute("MMLXBTRFUN");
+
+    // then
+    const ExecutorCounters counters = executor->QueryCounters();
+    ASSERT_EQ(2u, counters[ExecutorCounter::COMMAND_M]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::COMMAND_L]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::COMMAND_B]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::COMMAND_F]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::COMMAND_U]);
+    ASSERT_EQ(0u, counters[ExecutorCounter::COMMAND_N]);
+    ASSERT_EQ(0u, counters[ExecutorCounter::COMMAND_TR]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::UNKNOWN_SKIPPED]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::TR_IGNORED_IN_REVERSE]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::N_REFUSED_IN_BUS]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::CAR_TYPE_SWITCHES]);
+    ASSERT_EQ(2u, counters[ExecutorCounter::GRID_STEPS]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::EXECUTE_CALLS]);
+}
+
+TEST(ExecutorMetricsTest, should_count_grid_steps_of_fast_sports_car)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}, {CarType::SPORTS, true, false}));
+
+    // when
+    executor->Execute("ML");
+    executor->Execute("TR");
+
+    // then
+    const ExecutorCounters counters = executor->QueryCounters();
+    ASSERT_EQ(4u + 2u + 2u, counters[ExecutorCounter::GRID_STEPS]);
+    ASSERT_EQ(1u, counters[ExecutorCounter::COMMAND_TR]);
+    ASSERT_EQ(2u, counters[ExecutorCounter::EXECUTE_CALLS]);
+}
+
+TEST(ExecutorMetricsTest, reset_should_clear_executor_counters)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    executor->Execute("MMM");
+
+    // when
+    executor->Reset({0, 0, 'N'});
+
+    // then
+    ASSERT_EQ(0u, executor->QueryCounters()[ExecutorCounter::COMMAND_M]);
+}
+
+TEST(ExecutorMetricsTest, global_counters_should_include_destroyed_executors_and_exited_threads)
+{
+    // given
+    const ExecutorCounters before = SnapshotGlobalCounters();
+
+    // when
+    std::thread worker([] {
+        std::unique_ptr<Executor> executor(Executor::NewExecutor());
+        executor->Execute("MMMMM");
+    });
+    worker.join();
+    {
+        std::unique_ptr<Executor> executor(Executor::NewExecutor());
+        executor->Execute("M");
+    }
+
+    // then
+    const ExecutorCounters after = SnapshotGlobalCounters();
+    ASSERT_EQ(6u, after[ExecutorCounter::COMMAND_M] - before[ExecutorCounter::COMMAND_M]);
+    ASSERT_EQ(2u, after[ExecutorCounter::EXECUTE_CALLS] - before[ExecutorCounter::EXECUTE_CALLS]);
+}
+
+TEST(ExecutorMetricsTest, should_write_prometheus_text_file)
+{
+    // given
+    const std::string path = ::testing::TempDir() + "executor_metrics.prom";
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    executor->Execute("M");
+
+    // when
+    ASSERT_TRUE(WritePrometheus(path));
+
+    // then
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    ASSERT_NE(std::string::npos, text.str().find("# TYPE adas_executor_commands_total counter\n"));
+    ASSERT_NE(std::string::npos, text.str().find("adas_executor_commands_total{opcode=\"M\"} "));
+    ASSERT_NE(std::string::npos, text.str().find("adas_executor_execute_calls_total "));
+    std::remove(path.c_str());
+}
+}  // namespace adas
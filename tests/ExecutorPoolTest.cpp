@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "ExecutorPool.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+TEST(ExecutorPoolTest, should_acquire_executor_with_given_pose)
+{
+    // given
+    ExecutorPool pool(4);
+
+    // when
+    ExecutorPool::Handle executor = pool.Acquire({1, 2, 'W'});
+    executor->Execute("M");
+
+    // then
+    const Pose target{0, 2, 'W'};
+    ASSERT_EQ(target, executor->Query());
+    ASSERT_EQ(1u, pool.InUse());
+}
+
+TEST(ExecutorPoolTest, should_recycle_released_executor_without_growing)
+{
+    // given
+    ExecutorPool pool(2);
+    Executor* first = nullptr;
+    {
+        ExecutorPool::Handle executor = pool.Acquire();
+        executor->Execute("NFB");
+        first = executor.get();
+    }
+
+    // when
+    ExecutorPool::Handle executor = pool.Acquire({0, 0, 'E'});
+    executor->Execute("M");
+
+    // then
+    // 复用同一块内存，且恢复为普通车初始状态
+    ASSERT_EQ(first, executor.get());
+    ASSERT_EQ(2u, pool.Capacity());
+    const Pose target{1, 0, 'E'};
+    ASSERT_EQ(target, executor->Query());
+}
+
+TEST(ExecutorPoolTest, should_allocate_new_slab_when_exhausted)
+{
+    // given
+    ExecutorPool pool(2);
+
+    // when
+    ExecutorPool::Handle a = pool.Acquire();
+    ExecutorPool::Handle b = pool.Acquire();
+    ExecutorPool::Handle c = pool.Acquire();
+
+    // then
+    ASSERT_NE(nullptr, c);
+    ASSERT_EQ(4u, pool.Capacity());
+    ASSERT_EQ(3u, pool.InUse());
+}
+
+TEST(ExecutorPoolTest, reset_should_restore_normal_car_state)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}));
+    executor->Execute("UFBM");
+
+    // when
+    executor->Reset({5, 5, 'N'});
+    executor->Execute("M");
+
+    // then
+    const Pose target{5, 6, 'N'};
+    ASSERT_EQ(target, executor->Query());
+}
+}  // namespace adas
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include "Executor.hpp"
+#include "ExecutorProfiler.hpp"
+
+namespace adas
+{
+namespace
+{
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+class ExecutorProfilerTest : public ::testing::Test
+{
+protected:
+    void SetUp(void) override
+    {
+        ResetProfiling();
+    }
+    void TearDown(void) override
+    {
+        SetProfilingMode(PROFILE_NONE);
+        ResetProfiling();
+    }
+};
+}  // namespace
+
+TEST(LatencyHistogramTest, percentile_should_be_within_one_sixteenth_of_exact_value)
+{
+    // given
+    LatencyHistogram histogram;
+
+    // when
+    for (std::uint64_t value = 1; value <= 10000; ++value) {
+        histogram.Record(value);
+    }
+
+    // then
+    ASSERT_EQ(10000u, histogram.Count());
+    ASSERT_NEAR(5000.0, static_cast<double>(histogram.Percentile(0.5)), 5000.0 / 16);
+    ASSERT_NEAR(9900.0, static_cast<double>(histogram.Percentile(0.99)), 9900.0 / 16);
+    ASSERT_GE(histogram.Max(), 10000u);
+}
+
+TEST(LatencyHistogramTest, bucket_upper_bound_should_contain_value)
+{
+    for (const std::uint64_t value : {0ull, 15ull, 16ull, 31ull, 32ull, 1000ull, 123456789ull, ~0ull}) {
+        const std::size_t index = LatencyHistogram::IndexOf(value);
+        ASSERT_LT(index, LatencyHistogram::BUCKETS);
+        ASSERT_GE(LatencyHistogram::UpperBound(index), value);
+    }
+}
+
+TEST_F(ExecutorProfilerTest, should_not_record_when_profiling_disabled)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+
+    // when
+    executor->Execute("MM");
+
+    // then
+    ASSERT_EQ(0u, SnapshotLatency(CarType::NORMAL).Count());
+}
+
+TEST_F(ExecutorProfilerTest, should_record_latency_by_car_type_at_start_of_execute)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    SetProfilingMode(PROFILE_LATENCY);
+
+    // when
+    executor->Execute("MU");
+    executor->Execute("M");
+    executor->Execute("M");
+
+    // then
+    ASSERT_EQ(1u, SnapshotLatency(CarType::NORMAL).Count());
+    ASSERT_EQ(2u, SnapshotLatency(CarType::BUS).Count());
+    ASSERT_EQ(0u, SnapshotLatency(CarType::SPORTS).Count());
+}
+
+TEST_F(ExecutorProfilerTest, should_write_chrome_trace_with_execute_and_switch_spans)
+{
+    // given
+    const std::string path = ::testing::TempDir() + "executor_trace.json";
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    SetProfilingMode(PROFILE_TRACE);
+
+    // when
+    executor->Execute("NM");
+    ASSERT_TRUE(WriteChromeTrace(path));
+
+    // then
+    const std::string text = ReadFile(path);
+    ASSERT_EQ(0u, text.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    ASSERT_NE(std::string::npos, text.find("\"name\":\"Execute\",\"ph\":\"X\""));
+    ASSERT_NE(std::string::npos, text.find("\"name\":\"CarTypeSwitch\""));
+    // 转移表在注册车型时编译，切换车型只换一个指针
+    ASSERT_EQ(std::string::npos, text.find("\"name\":\"CommandTableRebuild\""));
+    ASSERT_NE(std::string::npos, text.find("\"carType\":\"SPORTS\""));
+    std::remove(path.c_str());
+}
+
+TEST_F(ExecutorProfilerTest, should_write_latency_report_per_car_type)
+{
+    // given
+    const std::string path = ::testing::TempDir() + "executor_latency.txt";
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    SetProfilingMode(PROFILE_LATENCY);
+    executor->Execute("M");
+
+    // when
+    ASSERT_TRUE(WriteLatencyReport(path));
+
+    // then
+    const std::string text = ReadFile(path);
+    ASSERT_EQ(0u, text.find("carType count p50_ns p99_ns p999_ns max_ns\n"));
+    ASSERT_NE(std::string::npos, text.find("\nNORMAL 1 "));
+    ASSERT_NE(std::string::npos, text.find("\nBUS 0 "));
+    std::remove(path.c_str());
+}
+}  // namespace adas
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FleetSimulator.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+TEST(FleetSimulatorTest, tick_should_match_individual_executors)
+{
+    // given
+    std::mt19937 random(31);
+    std::uniform_int_distribution<int> coordinate(-100, 100);
+    std::vector<Pose> poses;
+    std::vector<CarMode> modes;
+    std::vector<std::unique_ptr<Executor>> expected;
+    for (int i = 0; i < 3000; ++i) {
+        poses.push_back(Pose{coordinate(random), coordinate(random), "ESWN"[i % 4]});
+        modes.push_back(CarMode{static_cast<CarType>(i % 3), i % 5 == 0, i % 7 == 0});
+        expected.emplace_back(Executor::NewExecutor(poses.back(), modes.back()));
+    }
+    FleetSimulatorOptions deterministic;
+    deterministic.deterministic = true;
+    FleetSimulatorOptions parallel;
+    parallel.threads = 3;
+    FleetSimulator simulators[2] = {FleetSimulator(poses, modes, deterministic),
+                                    FleetSimulator(poses, modes, parallel)};
+
+    for (std::uint64_t tick = 1; tick <= 5; ++tick) {
+        // when
+        std::vector<std::string> commands(poses.size() - 10);
+        for (std::size_t i = 0; i < commands.size(); ++i) {
+            commands[i] = std::string(static_cast<std::size_t>(random() % 6), "MLRFBTNU"[random() % 8]);
+            expected[i]->Execute(commands[i]);
+        }
+        for (FleetSimulator& simulator : simulators) {
+            simulator.Tick(commands);
+        }
+
+        // then
+        for (const FleetSimulator& simulator : simulators) {
+            const FleetSimulator::Snapshot snapshot = simulator.Read();
+            ASSERT_EQ(tick, snapshot.Tick());
+            ASSERT_EQ(poses.size(), snapshot.Size());
+            for (std::size_t i = 0; i < poses.size(); ++i) {
+                ASSERT_EQ(expected[i]->Query(), snapshot.At(i));
+                ASSERT_EQ(expected[i]->QueryMode().fast, snapshot.Mode(i).fast);
+                ASSERT_EQ(expected[i]->QueryMode().carType, snapshot.Modes()[i].carType);
+            }
+            ASSERT_EQ(tick, simulator.Stats().ticks);
+            ASSERT_LE(simulator.Stats().minNs, simulator.Stats().maxNs);
+        }
+    }
+}
+
+TEST(FleetSimulatorTest, readers_should_always_see_a_whole_tick)
+{
+    // given: 所有车辆每个tick向东一格，同一tick内横坐标都等于tick编号
+    const std::size_t count = 20000;
+    FleetSimulator simulator(std::vector<Pose>(count, Pose{0, 0, 'E'}));
+    const std::vector<std::string> commands(count, "M");
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    // when
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                const FleetSimulator::Snapshot snapshot = simulator.Read();
+                const int expected = static_cast<int>(snapshot.Tick());
+                for (std::size_t v = 0; v < snapshot.Size(); v += 97) {
+                    if (snapshot.X()[v] != expected) {
+                        torn.fetch_add(1);
+                    }
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (int tick = 0; tick < 200; ++tick) {
+        simulator.Tick(commands);
+    }
+    done.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    // then
+    ASSERT_EQ(0, torn.load());
+    ASSERT_EQ(200, simulator.Read().X()[count - 1]);
+    ASSERT_EQ(200u * count, simulator.Stats().commands);
+}
+}  // namespace adas
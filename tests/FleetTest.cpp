@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Fleet.hpp"
+#include "ObstacleMap.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+namespace
+{
+std::vector<VehicleId> BruteForceRect(const Fleet& fleet, const std::vector<VehicleId>& ids, const GridPoint& low,
+                                      const GridPoint& high)
+{
+    std::vector<VehicleId> result;
+    for (const VehicleId id : ids) {
+        const Pose pose = fleet.Vehicle(id).Query();
+        if (pose.x >= low.x && pose.x <= high.x && pose.y >= low.y && pose.y <= high.y) {
+            result.push_back(id);
+        }
+    }
+    return result;
+}
+
+std::vector<VehicleId> BruteForceNearest(const Fleet& fleet, const std::vector<VehicleId>& ids,
+                                         const GridPoint& center, const std::size_t k)
+{
+    std::vector<std::pair<std::uint64_t, VehicleId>> all;
+    for (const VehicleId id : ids) {
+        const Pose pose = fleet.Vehicle(id).Query();
+        const std::int64_t dx = static_cast<std::int64_t>(pose.x) - center.x;
+        const std::int64_t dy = static_cast<std::int64_t>(pose.y) - center.y;
+        all.emplace_back(std::abs(dx) + std::abs(dy), id);
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<VehicleId> result;
+    for (std::size_t i = 0; i < all.size() && i < k; ++i) {
+        result.push_back(all[i].second);
+    }
+    return result;
+}
+}  // namespace
+
+TEST(FleetTest, queries_should_match_brute_force_after_moves)
+{
+    // given
+    std::mt19937 random(17);
+    std::uniform_int_distribution<int> coordinate(-500, 500);
+    std::uniform_int_distribution<int> command(0, 5);
+    Fleet fleet(4);
+    std::vector<VehicleId> ids;
+    for (int i = 0; i < 3000; ++i) {
+        ids.push_back(fleet.Add({coordinate(random), coordinate(random), "ESWN"[i % 4]}));
+    }
+
+    for (int round = 0; round < 5; ++round) {
+        // when: 随机移动、移除和加入车辆
+        for (const VehicleId id : ids) {
+            fleet.Execute(id, std::string(static_cast<std::size_t>(command(random)) * 7, "MMMLRF"[command(random)]));
+        }
+        for (int i = 0; i < 100; ++i) {
+            const std::size_t victim = static_cast<std::size_t>(random()) % ids.size();
+            fleet.Remove(ids[victim]);
+            ids[victim] = fleet.Add({coordinate(random), coordinate(random), 'N'});
+        }
+
+        // then
+        ASSERT_EQ(ids.size(), fleet.Size());
+        for (int query = 0; query < 50; ++query) {
+            const GridPoint a{coordinate(random), coordinate(random)};
+            const GridPoint b{a.x + coordinate(random) / 4, a.y + coordinate(random) / 4};
+            std::vector<VehicleId> actual;
+            fleet.QueryRect(a, b, actual);
+            std::sort(actual.begin(), actual.end());
+            std::vector<VehicleId> expected = BruteForceRect(
+                fleet, ids, {std::min(a.x, b.x), std::min(a.y, b.y)}, {std::max(a.x, b.x), std::max(a.y, b.y)});
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(expected, actual);
+
+            const std::size_t k = static_cast<std::size_t>(query) * 3;
+            fleet.QueryNearest(a, k, actual);
+            ASSERT_EQ(BruteForceNearest(fleet, ids, a, k), actual);
+        }
+    }
+    for (const VehicleId id : ids) {
+        const Pose pose = fleet.Vehicle(id).Query();
+        ASSERT_EQ(pose.x, fleet.Position(id).x);
+        ASSERT_EQ(pose.y, fleet.Position(id).y);
+    }
+}
+
+TEST(FleetTest, removed_id_should_be_reused)
+{
+    // given
+    Fleet fleet;
+    const VehicleId first = fleet.Add({0, 0, 'N'});
+    const VehicleId second = fleet.Add({100, 100, 'N'});
+
+    // when
+    fleet.Remove(first);
+
+    // then
+    ASSERT_FALSE(fleet.Contains(first));
+    ASSERT_EQ(1u, fleet.Size());
+    std::vector<VehicleId> result;
+    fleet.QueryNearest({0, 0}, 5, result);
+    ASSERT_EQ(std::vector<VehicleId>{second}, result);
+    ASSERT_EQ(first, fleet.Add({7, 7, 'E'}));
+    const Pose reused{7, 7, 'E'};
+    ASSERT_EQ(reused, fleet.Vehicle(first).Query());
+}
+
+TEST(FleetTest, nearest_should_search_from_far_outside_the_fleet)
+{
+    // given
+    Fleet fleet(2);
+    const VehicleId near = fleet.Add({1000000, 0, 'N'});
+    fleet.Add({-1000000, 5, 'N'});
+
+    // when
+    std::vector<VehicleId> result;
+    fleet.QueryNearest({2000000000, 0}, 1, result);
+
+    // then
+    ASSERT_EQ(std::vector<VehicleId>{near}, result);
+}
+
+TEST(FleetTest, nearest_should_not_walk_empty_cells_of_sparse_fleet)
+{
+    // given: 两辆车相距很远，中间的格子都是空的
+    Fleet fleet;
+    std::vector<VehicleId> ids{fleet.Add({0, 0, 'N'}), fleet.Add({1000000, 1000000, 'N'})};
+    const GridPoint centers[] = {{0, 0}, {500000, 500000}, {1000000, 999999}, {-3000000, 7}};
+
+    // when
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 100; ++round) {
+        for (const GridPoint& center : centers) {
+            for (std::size_t k = 1; k <= 3; ++k) {
+                std::vector<VehicleId> result;
+                fleet.QueryNearest(center, k, result);
+
+                // then
+                ASSERT_EQ(BruteForceNearest(fleet, ids, center, k), result) << center.x << "," << center.y;
+            }
+        }
+    }
+    // 逐圈遍历空格子时单次查询要数百毫秒
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(FleetTest, obstacle_map_should_apply_to_all_vehicles)
+{
+    // given
+    ObstacleMap map;
+    map.Block({0, 2});
+    Fleet fleet;
+    const VehicleId before = fleet.Add({0, 0, 'N'});
+    fleet.SetObstacleMap(&map);
+    const VehicleId after = fleet.Add({0, 0, 'N'});
+
+    // when
+    fleet.Execute(before, "MMM");
+    fleet.Execute(after, "MMM");
+
+    // then
+    ASSERT_EQ(1, fleet.Position(before).y);
+    ASSERT_EQ(1, fleet.Position(after).y);
+}
+}  // namespace adas
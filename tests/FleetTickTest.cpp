@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Fleet.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+namespace
+{
+std::tuple<VehicleId, VehicleId, CollisionKind, int, int> Key(const Collision& collision)
+{
+    return std::make_tuple(collision.first, collision.second, collision.kind, collision.cell.x, collision.cell.y);
+}
+
+std::vector<std::tuple<VehicleId, VehicleId, CollisionKind, int, int>> Keys(const std::vector<Collision>& collisions)
+{
+    std::vector<std::tuple<VehicleId, VehicleId, CollisionKind, int, int>> keys;
+    for (const Collision& collision : collisions) {
+        keys.push_back(Key(collision));
+    }
+    return keys;
+}
+
+bool Same(const GridPoint& lhs, const GridPoint& rhs)
+{
+    return lhs.x == rhs.x && lhs.y == rhs.y;
+}
+
+// 两两比较所有车辆的起止位置
+std::vector<Collision> BruteForce(const std::vector<VehicleMove>& moves)
+{
+    std::vector<Collision> result;
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        for (std::size_t j = i + 1; j < moves.size(); ++j) {
+            const VehicleMove& a = moves[i];
+            const VehicleMove& b = moves[j];
+            if (Same(a.to, b.to)) {
+                result.push_back(Collision{a.id, b.id, CollisionKind::SAME_CELL, a.to});
+            } else if (Same(a.from, b.to) && Same(a.to, b.from)) {
+                result.push_back(Collision{a.id, b.id, CollisionKind::SWAP, a.to});
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(),
+              [](const Collision& lhs, const Collision& rhs) { return Key(lhs) < Key(rhs); });
+    return result;
+}
+}  // namespace
+
+TEST(FleetTickTest, should_report_same_cell_and_swap)
+{
+    // given
+    Fleet fleet;
+    const VehicleId a = fleet.Add({0, 0, 'N'});
+    const VehicleId b = fleet.Add({0, 1, 'S'});
+    const VehicleId c = fleet.Add({5, 5, 'E'});
+    const VehicleId d = fleet.Add({7, 5, 'W'});
+    const VehicleId e = fleet.Add({6, 5, 'N'});
+    const VehicleId f = fleet.Add({9, 9, 'N'});
+    fleet.Remove(f);
+
+    // when
+    std::vector<Collision> collisions;
+    fleet.Tick({"M", "M", "M", "M", "", "M"}, collisions, 2);
+
+    // then
+    const std::vector<Collision> expected = {
+        {a, b, CollisionKind::SWAP, {0, 1}},
+        {c, d, CollisionKind::SAME_CELL, {6, 5}},
+        {c, e, CollisionKind::SAME_CELL, {6, 5}},
+        {d, e, CollisionKind::SAME_CELL, {6, 5}},
+    };
+    ASSERT_EQ(Keys(expected), Keys(collisions));
+    ASSERT_EQ(1, fleet.Position(a).y);
+    ASSERT_EQ(0, fleet.Position(b).y);
+}
+
+TEST(FleetTickTest, should_match_execute_and_brute_force_for_any_thread_count)
+{
+    std::mt19937 random(23);
+    std::uniform_int_distribution<int> coordinate(-30, 30);
+    std::uniform_int_distribution<int> length(0, 4);
+    const std::string alphabet = "MMMLRBFTRX";
+    Fleet fleets[3] = {Fleet(2), Fleet(2), Fleet(2)};
+    Fleet reference(2);
+    std::vector<VehicleId> ids;
+    for (int i = 0; i < 2000; ++i) {
+        const Pose pose{coordinate(random), coordinate(random), "ESWN"[i % 4]};
+        for (Fleet& fleet : fleets) {
+            fleet.Add(pose);
+        }
+        ids.push_back(reference.Add(pose));
+    }
+    for (int i = 0; i < 2000; i += 7) {
+        for (Fleet& fleet : fleets) {
+            fleet.Remove(ids[i]);
+        }
+        reference.Remove(ids[i]);
+    }
+
+    for (int tick = 0; tick < 10; ++tick) {
+        // given
+        std::vector<std::string> commands(ids.size());
+        for (std::string& command : commands) {
+            for (int n = length(random); n > 0; --n) {
+                command += alphabet[static_cast<std::size_t>(random()) % alphabet.size()];
+            }
+        }
+        std::vector<VehicleMove> moves;
+        for (const VehicleId id : ids) {
+            if (reference.Contains(id)) {
+                const GridPoint from = reference.Position(id);
+                reference.Execute(id, commands[id]);
+                moves.push_back(VehicleMove{from, reference.Position(id), id});
+            }
+        }
+        const std::vector<Collision> expected = BruteForce(moves);
+
+        const unsigned threads[3] = {1, 3, 8};
+        for (int i = 0; i < 3; ++i) {
+            // when
+            std::vector<Collision> collisions;
+            fleets[i].Tick(commands, collisions, threads[i]);
+
+            // then
+            ASSERT_EQ(Keys(expected), Keys(collisions)) << "threads " << threads[i];
+            for (const VehicleId id : ids) {
+                if (reference.Contains(id)) {
+                    ASSERT_EQ(reference.Vehicle(id).Query(), fleets[i].Vehicle(id).Query());
+                }
+            }
+            std::vector<VehicleId> inside;
+            std::vector<VehicleId> expectedInside;
+            fleets[i].QueryRect({-10, -10}, {10, 10}, inside);
+            reference.QueryRect({-10, -10}, {10, 10}, expectedInside);
+            std::sort(inside.begin(), inside.end());
+            std::sort(expectedInside.begin(), expectedInside.end());
+            ASSERT_EQ(expectedInside, inside);
+        }
+    }
+}
+}  // namespace adas
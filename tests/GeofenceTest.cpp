@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+#include "Geofence.hpp"
+#include "LazyExecutor.hpp"
+#include "PoseEq.hpp"
+#include "TestFixtures.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+struct Fence
+{
+    Geofence fence;
+    std::vector<GridPoint> vertices;
+};
+
+Geofence PolygonFence(const std::vector<GridPoint>& vertices)
+{
+    Geofence fence;
+    EXPECT_TRUE(Geofence::Polygon(vertices, fence));
+    return fence;
+}
+
+std::vector<Fence> Fences(void)
+{
+    const std::vector<GridPoint> concave{{-30, -30}, {30, -25}, {10, 0}, {35, 30}, {-25, 35}, {-5, 5}};
+    const std::vector<GridPoint> thin{{-1, -40}, {4, 40}, {-3, 10}};
+    const std::vector<GridPoint> notched{{-20, -20}, {20, -20}, {20, 20}, {3, 20}, {3, 3}, {1, 3}, {1, 20}, {-20, 20}};
+    return {{Geofence::Rectangle({25, 30}, {-20, -15}), {{-20, -15}, {25, -15}, {25, 30}, {-20, 30}}},
+            {PolygonFence(concave), concave},
+            {PolygonFence(thin), thin},
+            {PolygonFence(notched), notched}};
+}
+
+// 逐个格点判断：在某条边上，或向右的射线与边界相交奇数次
+bool InsidePolygon(const std::vector<GridPoint>& vertices, const GridPoint& p)
+{
+    bool inside = false;
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        const GridPoint& a = vertices[i];
+        const GridPoint& b = vertices[(i + 1) % vertices.size()];
+        const std::int64_t cross =
+            std::int64_t(b.x - a.x) * (p.y - a.y) - std::int64_t(b.y - a.y) * (p.x - a.x);
+        if (cross == 0 && std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) && std::min(a.y, b.y) <= p.y &&
+            p.y <= std::max(a.y, b.y)) {
+            return true;
+        }
+        if ((a.y > p.y) != (b.y > p.y)) {
+            // p.x < 交点的x
+            const std::int64_t lhs = std::int64_t(p.x - a.x) * (b.y - a.y);
+            const std::int64_t rhs = std::int64_t(p.y - a.y) * (b.x - a.x);
+            if (b.y > a.y ? lhs < rhs : lhs > rhs) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+// 每条指令的路径先沿原朝向所在的轴走，再沿另一轴走，逐格检查
+bool PathInside(const std::vector<GridPoint>& vertices, const Pose& from, const Pose& to)
+{
+    GridPoint p{from.x, from.y};
+    const bool alongX = from.heading == 'E' || from.heading == 'W';
+    for (int leg = 0; leg < 2; ++leg) {
+        const bool moveX = (leg == 0) == alongX;
+        int& pos = moveX ? p.x : p.y;
+        const int target = moveX ? to.x : to.y;
+        while (pos != target) {
+            pos += pos < target ? 1 : -1;
+            if (!InsidePolygon(vertices, p)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::size_t CommandLength(const std::string& commands, const std::size_t pos)
+{
+    return commands[pos] == 'T' && pos + 1 < commands.size() && commands[pos + 1] == 'R' ? 2 : 1;
+}
+
+// 逐条试执行，第一条会驶出围栏的指令之前停下
+std::size_t ReferenceWithin(Executor& executor, const std::string& commands, const std::vector<GridPoint>& vertices)
+{
+    const Pose start = executor.Query();
+    if (!InsidePolygon(vertices, GridPoint{start.x, start.y})) {
+        return 0;
+    }
+    for (std::size_t pos = 0; pos < commands.size();) {
+        const std::size_t length = CommandLength(commands, pos);
+        const Pose before = executor.Query();
+        std::unique_ptr<Executor> probe(Executor::NewExecutor(before, executor.QueryMode()));
+        probe->Execute(commands.substr(pos, length));
+        if (!PathInside(vertices, before, probe->Query())) {
+            return pos;
+        }
+        executor.Execute(commands.substr(pos, length));
+        pos += length;
+    }
+    return commands.size();
+}
+}  // namespace
+
+TEST(GeofenceTest, polygon_should_match_brute_force_lattice_points)
+{
+    for (const Fence& fence : Fences()) {
+        for (int y = -45; y <= 45; ++y) {
+            for (int x = -45; x <= 45; ++x) {
+                // given
+                const GridPoint p{x, y};
+                const bool expected = InsidePolygon(fence.vertices, p);
+
+                // when
+                const bool inside = fence.fence.Contains(p);
+
+                // then
+                ASSERT_EQ(expected, inside) << x << "," << y;
+                const int directions[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+                for (const auto& dir : directions) {
+                    std::uint64_t steps = 0;
+                    GridPoint q = p;
+                    while (expected && steps < 100 && InsidePolygon(fence.vertices, {q.x + dir[0], q.y + dir[1]})) {
+                        q = GridPoint{q.x + dir[0], q.y + dir[1]};
+                        ++steps;
+                    }
+                    ASSERT_EQ(steps, fence.fence.StepsInside(p, dir[0], dir[1], 100)) << x << "," << y;
+                }
+            }
+        }
+    }
+}
+
+TEST(GeofenceTest, should_refuse_polygons_too_large_to_compile)
+{
+    // given
+    Geofence fence = Geofence::Rectangle({0, 0}, {3, 3});
+    const std::vector<GridPoint> huge{{-2000000000, -2000000000}, {2000000000, -2000000000}, {0, 2000000000}};
+    std::vector<GridPoint> jagged;
+    for (int i = 0; i < 2000; ++i) {
+        jagged.push_back(GridPoint{i * 20, i % 2 == 0 ? 0 : 30000});
+    }
+
+    // when
+    const bool compiled = Geofence::Polygon(huge, fence);
+
+    // then: 失败时围栏不变
+    ASSERT_FALSE(compiled);
+    ASSERT_FALSE(Geofence::Polygon(jagged, fence));
+    ASSERT_TRUE(fence.Contains({3, 3}));
+    ASSERT_FALSE(fence.Contains({4, 3}));
+    ASSERT_FALSE(Geofence().Contains({0, 0}));
+}
+
+TEST(GeofenceTest, should_stop_before_first_command_leaving_fence)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    const Geofence fence = Geofence::Rectangle({0, 0}, {3, 3});
+
+    // when
+    const std::size_t reached = executor->ExecuteWithin("MMMMMRMM", fence);
+
+    // then
+    ASSERT_EQ(3u, reached);
+    const Pose target{0, 3, 'N'};
+    ASSERT_EQ(target, executor->Query());
+    ASSERT_EQ(7u, executor->ExecuteWithin("RMMMRMM", fence));
+    const Pose back{3, 1, 'S'};
+    ASSERT_EQ(back, executor->Query());
+}
+
+TEST(GeofenceTest, should_not_move_when_starting_outside_fence)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({10, 0, 'E'}));
+
+    // when
+    const std::size_t reached = executor->ExecuteWithin("FLR", Geofence::Rectangle({0, 0}, {3, 3}));
+
+    // then
+    ASSERT_EQ(0u, reached);
+    const Pose target{10, 0, 'E'};
+    ASSERT_EQ(target, executor->Query());
+    ASSERT_FALSE(executor->QueryMode().fast);
+}
+
+TEST(GeofenceTest, should_match_step_by_step_reference)
+{
+    WorkloadConfig longRuns;
+    longRuns.seed = 5;
+    longRuns.meanRunLength = 30.0;
+    longRuns.turnRoundRate = 0.05;
+    longRuns.junkRate = 0.01;
+    longRuns.carTypeSwitchRate = 0.01;
+    const std::string corpora[] = {WorkloadGenerator().Generate(1500, 2), WorkloadGenerator(longRuns).Generate(1500, 2),
+                                   std::string(60, 'M') + "RTR" + std::string(80, 'M') + "BLLMMMMMMMMTT"};
+    const CarType types[] = {CarType::NORMAL, CarType::SPORTS, CarType::BUS, TestTruckType()};
+    NullListener listener;
+
+    for (const std::string& commands : corpora) {
+        for (const Fence& fence : Fences()) {
+            for (const CarType carType : types) {
+                for (unsigned flags = 0; flags < 8; ++flags) {
+                    // given
+                    const Pose pose{0, 0, "ESWN"[flags & 3]};
+                    const CarMode mode{carType, (flags & 4) != 0, false};
+                    std::unique_ptr<Executor> expected(Executor::NewExecutor(pose, mode));
+                    std::unique_ptr<Executor> executor(Executor::NewExecutor(pose, mode));
+                    if ((flags & 1) != 0) {
+                        executor->SetListener(&listener);
+                    }
+
+                    // when: 被挡住的指令跳过，从下一条继续
+                    for (std::size_t pos = 0; pos < commands.size();) {
+                        const std::string rest = commands.substr(pos);
+                        const std::size_t reached = executor->ExecuteWithin(rest, fence.fence);
+
+                        // then
+                        ASSERT_EQ(ReferenceWithin(*expected, rest, fence.vertices), reached);
+                        ASSERT_EQ(expected->Query(), executor->Query());
+                        pos += reached < rest.size() ? reached + CommandLength(rest, reached) : reached;
+                    }
+                    ASSERT_EQ(expected->QueryMode().carType, executor->QueryMode().carType);
+                    ASSERT_EQ(expected->QueryStats().distance, executor->QueryStats().distance);
+                }
+            }
+        }
+    }
+}
+
+TEST(GeofenceTest, lazy_executor_should_stop_at_same_position)
+{
+    // given
+    std::unique_ptr<Executor> eager(Executor::NewExecutor());
+    std::unique_ptr<Executor> lazy(LazyExecutor::NewLazyExecutor());
+    const Geofence fence = Geofence::Rectangle({-50, -50}, {50, 50});
+    eager->Execute("MMMMRMM");
+    lazy->Execute("MMMMRMM");
+
+    // when
+    const std::size_t reached = lazy->ExecuteWithin(std::string(100, 'M'), fence);
+
+    // then
+    ASSERT_EQ(eager->ExecuteWithin(std::string(100, 'M'), fence), reached);
+    ASSERT_EQ(48u, reached);
+    ASSERT_EQ(eager->Query(), lazy->Query());
+}
+}  // namespace adas
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+#include "ExecutorListener.hpp"
+#include "ExecutorMetrics.hpp"
+#include "LazyExecutor.hpp"
+#include "PoseEq.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+class CountingListener final : public ExecutorListener
+{
+public:
+    void OnEvents(const ExecutorEvent* events, const std::size_t count) noexcept override
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            moves += events[i].type == ExecutorEventType::MOVE ? events[i].repeat : 0;
+        }
+    }
+
+    unsigned moves{0};
+};
+
+// 把指令流切成长短不一的若干次Execute，含刚好把TR切开的情况
+std::vector<std::string> SplitCommands(const std::string& commands)
+{
+    std::vector<std::string> parts;
+    std::uint32_t seed = 99;
+    for (std::size_t pos = 0; pos < commands.size();) {
+        seed = seed * 1103515245u + 12345u;
+        const std::size_t length = (seed >> 16) % 200;
+        parts.push_back(commands.substr(pos, length));
+        pos += length;
+    }
+    parts.push_back("MT");
+    parts.push_back("RM");
+    return parts;
+}
+}  // namespace
+
+TEST(LazyExecutorTest, execute_should_only_append_until_query)
+{
+    // given
+    std::unique_ptr<LazyExecutor> executor(LazyExecutor::NewLazyExecutor());
+
+    // when
+    executor->Execute("MM");
+    executor->Execute("L");
+
+    // then
+    ASSERT_EQ(3u, executor->PendingBytes());
+    const Pose target{0, 2, 'W'};
+    ASSERT_EQ(target, executor->Query());
+    ASSERT_EQ(0u, executor->PendingBytes());
+}
+
+TEST(LazyExecutorTest, should_match_eager_executor_and_counters)
+{
+    // given
+    WorkloadConfig config;
+    config.junkRate = 0.01;
+    config.turnRoundRate = 0.05;
+    const std::vector<std::string> parts = SplitCommands(WorkloadGenerator(config).Generate(50000, 1));
+    const CarMode mode{CarType::BUS, true, false};
+    std::unique_ptr<Executor> eager(Executor::NewExecutor({1, 2, 'E'}, mode));
+    std::unique_ptr<LazyExecutor> lazy(LazyExecutor::NewLazyExecutor({1, 2, 'E'}, mode, LazyOptions{4096}));
+
+    // when
+    for (const std::string& part : parts) {
+        eager->Execute(part);
+        lazy->Execute(part);
+    }
+    lazy->Flush();
+
+    // then
+    ASSERT_EQ(eager->Query(), lazy->Query());
+    ASSERT_EQ(eager->QueryMode().carType, lazy->QueryMode().carType);
+    ASSERT_EQ(eager->QueryMode().fast, lazy->QueryMode().fast);
+    ASSERT_EQ(eager->QueryMode().reverse, lazy->QueryMode().reverse);
+    const ExecutorCounters expected = eager->QueryCounters();
+    const ExecutorCounters actual = lazy->QueryCounters();
+    for (std::size_t i = 0; i < ExecutorCounters::SIZE; ++i) {
+        ASSERT_EQ(expected.values[i], actual.values[i]) << "counter " << i;
+    }
+}
+
+TEST(LazyExecutorTest, pending_log_should_stay_within_bound)
+{
+    // given
+    std::unique_ptr<LazyExecutor> executor(LazyExecutor::NewLazyExecutor({0, 0, 'N'}, CarMode{}, LazyOptions{16}));
+
+    // when
+    for (int i = 0; i < 100; ++i) {
+        executor->Execute("MMM");
+        ASSERT_LE(executor->PendingBytes(), 16u);
+    }
+    executor->Execute(std::string(40, 'M'));
+
+    // then
+    ASSERT_LE(executor->PendingBytes(), 16u);
+    const Pose target{0, 340, 'N'};
+    ASSERT_EQ(target, executor->Query());
+}
+
+TEST(LazyExecutorTest, listener_should_receive_events_when_log_is_executed)
+{
+    // given
+    std::unique_ptr<LazyExecutor> executor(LazyExecutor::NewLazyExecutor());
+    CountingListener listener;
+    executor->SetListener(&listener);
+
+    // when
+    executor->Execute("MMLM");
+    const unsigned before = listener.moves;
+    executor->Flush();
+
+    // then
+    ASSERT_EQ(0u, before);
+    ASSERT_EQ(3u, listener.moves);
+}
+}  // namespace adas
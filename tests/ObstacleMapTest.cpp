@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include "Executor.hpp"
+#include "ExecutorMetrics.hpp"
+#include "Geofence.hpp"
+#include "LazyExecutor.hpp"
+#include "ObstacleMap.hpp"
+#include "PoseEq.hpp"
+#include "TestFixtures.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+// 原点附近随机撒障碍，跨越负坐标的块
+ObstacleMap RandomMap(const std::uint32_t seed, const int count)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> coordinate(-150, 150);
+    ObstacleMap map;
+    for (int i = 0; i < count; ++i) {
+        const GridPoint cell{coordinate(random), coordinate(random)};
+        if (cell.x != 0 || cell.y != 0) {
+            map.Block(cell);
+        }
+    }
+    return map;
+}
+
+struct ReferenceState
+{
+    Pose pose;
+    CarMode mode;
+    std::uint64_t steps;
+};
+
+std::size_t CommandLength(const std::string& commands, const std::size_t pos)
+{
+    return commands[pos] == 'T' && pos + 1 < commands.size() && commands[pos + 1] == 'R' ? 2 : 1;
+}
+
+// 逐格执行：每条指令的路径先沿原朝向所在的轴走，再沿另一轴走，每段走到障碍前为止。
+// fence非空时在第一条会驶出围栏的指令前停下
+std::size_t ReferenceRun(ReferenceState& state, const std::string& commands, const ObstacleMap& map,
+                         const Geofence* fence = nullptr)
+{
+    if (fence != nullptr && !fence->Contains({state.pose.x, state.pose.y})) {
+        return 0;
+    }
+    for (std::size_t pos = 0; pos < commands.size();) {
+        const std::size_t length = CommandLength(commands, pos);
+        std::unique_ptr<Executor> probe(Executor::NewExecutor(state.pose, state.mode));
+        probe->Execute(commands.substr(pos, length));
+        const Pose target = probe->Query();
+
+        GridPoint p{state.pose.x, state.pose.y};
+        std::uint64_t steps = 0;
+        const bool alongX = state.pose.heading == 'E' || state.pose.heading == 'W';
+        for (int leg = 0; leg < 2; ++leg) {
+            const bool moveX = (leg == 0) == alongX;
+            const int delta = moveX ? target.x - state.pose.x : target.y - state.pose.y;
+            const int sign = delta > 0 ? 1 : -1;
+            for (int i = 0; i < std::abs(delta); ++i) {
+                const GridPoint next{p.x + (moveX ? sign : 0), p.y + (moveX ? 0 : sign)};
+                if (map.Blocked(next)) {
+                    break;
+                }
+                if (fence != nullptr && !fence->Contains(next)) {
+                    return pos;
+                }
+                p = next;
+                ++steps;
+            }
+        }
+        state = ReferenceState{Pose{p.x, p.y, target.heading}, probe->QueryMode(), state.steps + steps};
+        pos += length;
+    }
+    return commands.size();
+}
+}  // namespace
+
+TEST(ObstacleMapTest, should_block_and_unblock_cells_in_negative_tiles)
+{
+    // given
+    ObstacleMap map;
+
+    // when
+    map.Block({-1, -1});
+    map.Block({-64, 63});
+    map.Block({-65, 63});
+    map.Unblock({-64, 63});
+
+    // then
+    ASSERT_TRUE(map.Blocked({-1, -1}));
+    ASSERT_FALSE(map.Blocked({-64, 63}));
+    ASSERT_TRUE(map.Blocked({-65, 63}));
+    ASSERT_FALSE(map.Blocked({0, 0}));
+    ASSERT_EQ(3u, map.TileCount());
+}
+
+TEST(ObstacleMapTest, free_steps_should_match_cell_by_cell_scan)
+{
+    const ObstacleMap map = RandomMap(3, 400);
+    const int directions[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    for (int y = -170; y <= 170; y += 7) {
+        for (int x = -170; x <= 170; x += 3) {
+            for (const auto& dir : directions) {
+                // given
+                std::uint64_t expected = 0;
+                while (expected < 250 && !map.Blocked({x + dir[0] * static_cast<int>(expected + 1),
+                                                       y + dir[1] * static_cast<int>(expected + 1)})) {
+                    ++expected;
+                }
+
+                // when
+                const std::uint64_t free = map.FreeSteps({x, y}, dir[0], dir[1], 250);
+
+                // then
+                ASSERT_EQ(expected, free) << x << "," << y << " dir " << dir[0] << "," << dir[1];
+            }
+        }
+    }
+}
+
+TEST(ObstacleMapTest, move_should_stop_in_front_of_obstacle)
+{
+    // given
+    ObstacleMap map;
+    map.Block({0, 3});
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    executor->SetObstacleMap(&map);
+
+    // when
+    executor->Execute("MMMMRM");
+
+    // then
+    const Pose target{1, 2, 'E'};
+    ASSERT_EQ(target, executor->Query());
+    const ExecutorCounters counters = executor->QueryCounters();
+    ASSERT_EQ(5u, counters[ExecutorCounter::COMMAND_M]);
+    ASSERT_EQ(3u, counters[ExecutorCounter::GRID_STEPS]);
+}
+
+TEST(ObstacleMapTest, reset_should_detach_map)
+{
+    // given
+    ObstacleMap map;
+    map.Block({0, 1});
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    executor->SetObstacleMap(&map);
+
+    // when
+    executor->Reset({0, 0, 'N'});
+    executor->Execute("M");
+
+    // then
+    const Pose target{0, 1, 'N'};
+    ASSERT_EQ(target, executor->Query());
+}
+
+TEST(ObstacleMapTest, should_match_cell_by_cell_reference)
+{
+    WorkloadConfig longRuns;
+    longRuns.seed = 9;
+    longRuns.meanRunLength = 40.0;
+    longRuns.turnRoundRate = 0.05;
+    longRuns.junkRate = 0.01;
+    longRuns.carTypeSwitchRate = 0.01;
+    const std::string corpora[] = {WorkloadGenerator().Generate(1500, 4), WorkloadGenerator(longRuns).Generate(1500, 4),
+                                   std::string(200, 'M') + "RTR" + std::string(300, 'M') + "BLLMMMMMMMMTT"};
+    const CarType types[] = {CarType::NORMAL, CarType::SPORTS, CarType::BUS, TestTruckType()};
+    const ObstacleMap map = RandomMap(7, 3000);
+    NullListener listener;
+
+    for (const std::string& commands : corpora) {
+        for (const CarType carType : types) {
+            for (unsigned flags = 0; flags < 16; ++flags) {
+                // given
+                const Pose pose{0, 0, "ESWN"[flags & 3]};
+                const CarMode mode{carType, (flags & 4) != 0, (flags & 8) != 0};
+                ReferenceState expected{pose, mode, 0};
+                ReferenceRun(expected, commands, map);
+                std::unique_ptr<Executor> executor(Executor::NewExecutor(pose, mode));
+                executor->SetObstacleMap(&map);
+                if ((flags & 1) != 0) {
+                    executor->SetListener(&listener);
+                }
+
+                // when
+                executor->Execute(commands);
+
+                // then
+                ASSERT_EQ(expected.pose, executor->Query());
+                ASSERT_EQ(expected.mode.carType, executor->QueryMode().carType);
+                ASSERT_EQ(expected.mode.fast, executor->QueryMode().fast);
+                ASSERT_EQ(expected.mode.reverse, executor->QueryMode().reverse);
+                ASSERT_EQ(expected.steps, executor->QueryStats().distance);
+            }
+        }
+    }
+}
+
+TEST(ObstacleMapTest, execute_within_should_respect_obstacles_and_fence)
+{
+    // given
+    const ObstacleMap map = RandomMap(5, 2000);
+    const Geofence fence = Geofence::Rectangle({-60, -40}, {50, 70});
+    WorkloadConfig config;
+    config.meanRunLength = 20.0;
+    const std::string commands = WorkloadGenerator(config).Generate(3000, 6);
+    ReferenceState expected{{0, 0, 'N'}, CarMode{}, 0};
+    std::unique_ptr<Executor> executor(LazyExecutor::NewLazyExecutor());
+    executor->SetObstacleMap(&map);
+
+    // when: 被挡住的指令跳过，从下一条继续
+    for (std::size_t pos = 0; pos < commands.size();) {
+        const std::string rest = commands.substr(pos);
+        const std::size_t reached = executor->ExecuteWithin(rest, fence);
+
+        // then
+        ASSERT_EQ(ReferenceRun(expected, rest, map, &fence), reached);
+        ASSERT_EQ(expected.pose, executor->Query());
+        pos += reached < rest.size() ? reached + CommandLength(rest, reached) : reached;
+    }
+    ASSERT_EQ(expected.steps, executor->QueryStats().distance);
+}
+}  // namespace adas
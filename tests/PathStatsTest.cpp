@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Executor.hpp"
+#include "LazyExecutor.hpp"
+#include "PoseEq.hpp"
+#include "StateMachineEvaluator.hpp"
+#include "TestFixtures.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+// 逐条执行并在每条指令后查询位姿。每条指令的路径最多拐一个弯，
+// 拐点在两端点的外接矩形内，行驶格数等于两端点的曼哈顿距离
+PathStats Reference(const Pose& pose, const CarMode& mode, const std::string& commands)
+{
+    std::unique_ptr<Executor> executor(Executor::NewExecutor(pose, mode));
+    PathStats stats{0, pose.x, pose.y, pose.x, pose.y, 0, 0};
+    Pose last = pose;
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const bool turnRound = commands[i] == 'T' && i + 1 < commands.size() && commands[i + 1] == 'R';
+        executor->Execute(commands.substr(i, turnRound ? 2 : 1));
+        i += turnRound ? 1 : 0;
+        const Pose current = executor->Query();
+        stats.distance += std::abs(current.x - last.x) + std::abs(current.y - last.y);
+        stats.minX = std::min(stats.minX, current.x);
+        stats.minY = std::min(stats.minY, current.y);
+        stats.maxX = std::max(stats.maxX, current.x);
+        stats.maxY = std::max(stats.maxY, current.y);
+        last = current;
+    }
+    stats.dx = last.x - pose.x;
+    stats.dy = last.y - pose.y;
+    return stats;
+}
+
+void ExpectSameStats(const PathStats& expected, const PathStats& actual)
+{
+    ASSERT_EQ(expected.distance, actual.distance);
+    ASSERT_EQ(expected.minX, actual.minX);
+    ASSERT_EQ(expected.minY, actual.minY);
+    ASSERT_EQ(expected.maxX, actual.maxX);
+    ASSERT_EQ(expected.maxY, actual.maxY);
+    ASSERT_EQ(expected.dx, actual.dx);
+    ASSERT_EQ(expected.dy, actual.dy);
+}
+
+std::vector<std::string> Corpora(void)
+{
+    WorkloadConfig longRuns;
+    longRuns.seed = 11;
+    longRuns.meanRunLength = 50.0;
+    longRuns.carTypeSwitchRate = 0.001;
+    longRuns.turnRoundRate = 0.02;
+    return {WorkloadGenerator().Generate(3000, 1), WorkloadGenerator(longRuns).Generate(3000, 1),
+            std::string(200, 'M') + "B" + std::string(300, 'M') + std::string(64, 'R') + "F" + std::string(130, 'L')};
+}
+}  // namespace
+
+TEST(PathStatsTest, new_executor_should_start_with_empty_path)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({4, -7, 'E'}));
+
+    // when
+    const PathStats stats = executor->QueryStats();
+
+    // then
+    ExpectSameStats(PathStats{0, 4, -7, 4, -7, 0, 0}, stats);
+}
+
+TEST(PathStatsTest, stats_should_match_command_by_command_reference)
+{
+    // given
+    const EvaluatorIsa saved = GetEvaluatorIsa();
+    const CarType types[] = {CarType::NORMAL, CarType::SPORTS, CarType::BUS, TestTruckType()};
+    const EvaluatorIsa isas[] = {EvaluatorIsa::SCALAR, EvaluatorIsa::SSSE3, EvaluatorIsa::AVX2};
+
+    for (const std::string& commands : Corpora()) {
+        for (const CarType carType : types) {
+            for (unsigned flags = 0; flags < 4; ++flags) {
+                const Pose pose{5, -3, "ESWN"[flags]};
+                const CarMode mode{carType, (flags & 1) != 0, (flags & 2) != 0};
+                const PathStats expected = Reference(pose, mode, commands);
+                for (const EvaluatorIsa isa : isas) {
+                    SetEvaluatorIsa(isa);
+                    std::unique_ptr<Executor> executor(Executor::NewExecutor(pose, mode));
+
+                    // when
+                    executor->Execute(commands);
+
+                    // then
+                    ExpectSameStats(expected, executor->QueryStats());
+                }
+            }
+        }
+    }
+    SetEvaluatorIsa(saved);
+}
+
+TEST(PathStatsTest, reset_stats_should_restart_from_current_position)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor());
+    executor->Execute("MMMRMM");
+
+    // when
+    executor->ResetStats();
+    executor->Execute("BMMM");
+
+    // then
+    const Pose target{-1, 3, 'E'};
+    ASSERT_EQ(target, executor->Query());
+    ExpectSameStats(PathStats{3, -1, 3, 2, 3, -3, 0}, executor->QueryStats());
+    executor->Reset({0, 0, 'N'});
+    ExpectSameStats(PathStats{0, 0, 0, 0, 0, 0, 0}, executor->QueryStats());
+}
+
+TEST(PathStatsTest, lazy_executor_should_report_pending_commands)
+{
+    // given
+    std::unique_ptr<Executor> eager(Executor::NewExecutor());
+    std::unique_ptr<Executor> lazy(LazyExecutor::NewLazyExecutor());
+    const std::string commands = WorkloadGenerator().Generate(2000, 3);
+
+    // when
+    for (std::size_t pos = 0; pos < commands.size(); pos += 7) {
+        eager->Execute(commands.substr(pos, 7));
+        lazy->Execute(commands.substr(pos, 7));
+        if (pos == 700) {
+            eager->ResetStats();
+            lazy->ResetStats();
+        }
+    }
+
+    // then
+    ExpectSameStats(eager->QueryStats(), lazy->QueryStats());
+}
+}  // namespace adas
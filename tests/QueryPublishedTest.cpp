@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include "ConcurrentExecutor.hpp"
+#include "Executor.hpp"
+#include "Geofence.hpp"
+#include "LazyExecutor.hpp"
+#include "PoseEq.hpp"
+
+namespace adas
+{
+TEST(QueryPublishedTest, should_publish_once_per_call)
+{
+    // given
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'N'}, CarMode{CarType::SPORTS, false, false}));
+    ASSERT_EQ(0u, executor->QueryPublished().version);
+
+    // when
+    executor->Execute("MMF");
+    const std::string commands = "RMMMM";
+    ExecuteCursor cursor(commands);
+    executor->ExecuteSome(cursor, 2);
+
+    // then: ExecuteSome执行到一半也发布
+    PublishedState published = executor->QueryPublished();
+    ASSERT_EQ(2u, published.version);
+    ASSERT_EQ(executor->Query(), published.pose);
+    ASSERT_EQ(CarType::SPORTS, published.mode.carType);
+    ASSERT_TRUE(published.mode.fast);
+    ASSERT_FALSE(published.mode.reverse);
+
+    executor->ExecuteWithin("BM", Geofence::Rectangle({-100, -100}, {100, 100}));
+    executor->Reset({-5, 7, 'W'}, CarMode{CarType::BUS, false, true});
+    published = executor->QueryPublished();
+    ASSERT_EQ(4u, published.version);
+    const Pose reset{-5, 7, 'W'};
+    ASSERT_EQ(reset, published.pose);
+    ASSERT_EQ(CarType::BUS, published.mode.carType);
+    ASSERT_TRUE(published.mode.reverse);
+}
+
+TEST(QueryPublishedTest, lazy_executor_should_publish_when_log_runs)
+{
+    // given
+    std::unique_ptr<LazyExecutor> executor(LazyExecutor::NewLazyExecutor());
+
+    // when
+    executor->Execute("MM");
+    const PublishedState before = executor->QueryPublished();
+    executor->Flush();
+
+    // then
+    const Pose origin{0, 0, 'N'};
+    const Pose moved{0, 2, 'N'};
+    ASSERT_EQ(origin, before.pose);
+    ASSERT_EQ(moved, executor->QueryPublished().pose);
+}
+
+TEST(QueryPublishedTest, readers_should_never_see_torn_state)
+{
+    // given: 每批"MF"切换一次加速状态，第k批后x为(3k-1)/2(k为奇数)或3k/2(k为偶数)，且加速与k的奇偶一致
+    ConcurrentExecutor executor({0, 0, 'E'});
+    const std::uint64_t batches = 20000;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    // when
+    std::thread reader([&] {
+        while (!done.load()) {
+            const PublishedState state = executor.Query();
+            const std::uint64_t k = state.version;
+            const std::uint64_t x = k % 2 == 1 ? (3 * k - 1) / 2 : 3 * k / 2;
+            if (static_cast<std::uint64_t>(state.pose.x) != x || state.mode.fast != (k % 2 == 1)) {
+                torn.fetch_add(1);
+            }
+        }
+    });
+    for (std::uint64_t i = 0; i < batches; ++i) {
+        executor.Submit("MF");
+        executor.Drain();
+    }
+    done.store(true);
+    reader.join();
+
+    // then
+    ASSERT_EQ(0, torn.load());
+    ASSERT_EQ(batches, executor.Query().version);
+    ASSERT_EQ(static_cast<int>(3 * batches / 2), executor.Query().pose.x);
+}
+}  // namespace adas
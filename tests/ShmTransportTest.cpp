@@ -0,0 +1,335 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PoseEq.hpp"
+#include "ShmTransport.hpp"
+
+namespace adas
+{
+namespace
+{
+constexpr std::uint64_t TIMEOUT_NS = 5000000000ull;
+
+// 在后台线程上运行的服务，析构时停止
+class RunningServer final
+{
+public:
+    RunningServer(const std::string& name, const ShmTransportOptions& options) : server(name, options)
+    {
+        created = server.Create();
+        if (created) {
+            loop = std::thread([this] { server.Run(); });
+        }
+    }
+    ~RunningServer()
+    {
+        Stop();
+    }
+
+    void Stop(void)
+    {
+        if (loop.joinable()) {
+            server.Stop();
+            loop.join();
+        }
+    }
+
+    ShmCommandServer server;
+    bool created;
+    std::thread loop;
+};
+
+std::string SegmentName(const char* name)
+{
+    return "/training_shm_test_" + std::to_string(::getpid()) + "_" + name;
+}
+
+std::vector<Response> ReceiveAll(ShmCommandClient& client, const std::size_t count)
+{
+    std::vector<Response> responses(count);
+    std::size_t received = 0;
+    while (received < count) {
+        const std::size_t taken = client.Receive(responses.data() + received, count - received, TIMEOUT_NS);
+        if (taken == 0) {
+            break;
+        }
+        received += taken;
+    }
+    responses.resize(received);
+    return responses;
+}
+
+// 像出错或恶意的客户端一样直接改写0号槽位的请求环。偏移与src/ShmRing.hpp中的布局一致：
+// 段头占128字节，槽位头占320字节，请求环的head在槽位头第64字节
+class SlotWriter final
+{
+public:
+    explicit SlotWriter(const std::string& name)
+    {
+        const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+        struct stat status;
+        if (fd >= 0 && ::fstat(fd, &status) == 0) {
+            size = static_cast<std::size_t>(status.st_size);
+            void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            base = mapped == MAP_FAILED ? nullptr : static_cast<char*>(mapped);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    ~SlotWriter()
+    {
+        if (base != nullptr) {
+            ::munmap(base, size);
+        }
+    }
+
+    std::atomic<std::uint64_t>& RequestHead(void) const
+    {
+        return *reinterpret_cast<std::atomic<std::uint64_t>*>(base + 128 + 64);
+    }
+    std::uint64_t RingBytes(void) const
+    {
+        std::uint64_t ringBytes;
+        std::memcpy(&ringBytes, base + 16, sizeof(ringBytes));
+        return ringBytes;
+    }
+    // 在环内position处写一个请求头
+    void WriteHeader(const std::uint64_t position, const RequestHeader& header) const
+    {
+        std::memcpy(base + 128 + 320 + (position & (RingBytes() - 1)), &header, sizeof(header));
+    }
+
+    char* base{nullptr};
+    std::size_t size{0};
+};
+}  // namespace
+
+TEST(ShmTransportTest, should_reply_with_poses_in_request_order)
+{
+    // given
+    const std::string name = SegmentName("order");
+    RunningServer running(name, ShmTransportOptions{});
+    ASSERT_TRUE(running.created);
+    ShmCommandClient client;
+    ASSERT_TRUE(client.Attach(name));
+    const CarMode sports{CarType::SPORTS, false, false};
+
+    // when
+    ASSERT_TRUE(client.SubmitReset(7, 1, {1, 2, 'E'}, sports));
+    ASSERT_TRUE(client.SubmitExecute(7, 2, "MMFM"));
+    ASSERT_TRUE(client.SubmitExecute(9, 3, "RM"));
+    ASSERT_TRUE(client.Submit(FrameType::QUERY, 8, 4));
+    ASSERT_TRUE(client.Submit(FrameType::REMOVE, 7, 5));
+    ASSERT_TRUE(client.Submit(FrameType::QUERY, 7, 6));
+    const std::vector<Response> responses = ReceiveAll(client, 6);
+
+    // then
+    ASSERT_EQ(6u, responses.size());
+    for (std::uint64_t i = 0; i < responses.size(); ++i) {
+        ASSERT_EQ(i + 1, responses[i].tag);
+    }
+    std::unique_ptr<Executor> seven(Executor::NewExecutor({1, 2, 'E'}, sports));
+    seven->Execute("MMFM");
+    std::unique_ptr<Executor> nine(Executor::NewExecutor());
+    nine->Execute("RM");
+    ASSERT_EQ(CarType::SPORTS, ModeOf(responses[0]).carType);
+    ASSERT_EQ(seven->Query(), PoseOf(responses[1]));
+    ASSERT_EQ(nine->Query(), PoseOf(responses[2]));
+    ASSERT_EQ(static_cast<std::uint16_t>(FrameStatus::UNKNOWN_VEHICLE), responses[3].status);
+    ASSERT_EQ(seven->Query(), PoseOf(responses[4]));
+    ASSERT_EQ(static_cast<std::uint16_t>(FrameStatus::UNKNOWN_VEHICLE), responses[5].status);
+    ASSERT_EQ(0u, client.Receive(nullptr, 0));
+}
+
+TEST(ShmTransportTest, clients_should_not_lose_frames_when_rings_wrap_and_fill)
+{
+    // given: 环很小，帧经常跨过环尾，请求和应答环都会写满
+    const std::string name = SegmentName("wrap");
+    ShmTransportOptions options;
+    options.slots = 4;
+    options.ringBytes = 256;
+    RunningServer running(name, options);
+    ASSERT_TRUE(running.created);
+    const int clients = 4;
+    const std::uint64_t frames = 3000;
+
+    // when
+    std::vector<std::thread> threads;
+    std::vector<std::uint64_t> ordered(clients, 0);
+    std::vector<Pose> last(clients, Pose{0, 0, 'N'});
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            ShmCommandClient client;
+            if (!client.Attach(name)) {
+                return;
+            }
+            const std::string commands(static_cast<std::size_t>(c + 1), 'M');
+            std::uint64_t submitted = 0;
+            std::uint64_t received = 0;
+            Response responses[8];
+            while (received < frames) {
+                while (submitted < frames && client.SubmitExecute(static_cast<std::uint64_t>(c), submitted, commands)) {
+                    ++submitted;
+                }
+                const std::size_t taken = client.Receive(responses, 8, TIMEOUT_NS);
+                if (taken == 0) {
+                    return;
+                }
+                for (std::size_t i = 0; i < taken; ++i, ++received) {
+                    ordered[c] += responses[i].tag == received ? 1 : 0;
+                    last[c] = PoseOf(responses[i]);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // then
+    for (int c = 0; c < clients; ++c) {
+        ASSERT_EQ(frames, ordered[c]) << "client " << c;
+        const Pose target{0, static_cast<int>(frames) * (c + 1), 'N'};
+        ASSERT_EQ(target, last[c]);
+    }
+
+    // when: 占满所有槽位
+    std::vector<std::unique_ptr<ShmCommandClient>> attached;
+    for (unsigned i = 0; i < options.slots; ++i) {
+        attached.emplace_back(new ShmCommandClient());
+        while (!attached.back()->Attach(name)) {
+            std::this_thread::yield();  // 等服务端回收上面断开的槽位
+        }
+    }
+    ShmCommandClient extra;
+
+    // then
+    ASSERT_FALSE(extra.Attach(name));
+    ASSERT_EQ(EBUSY, errno);
+    attached.front()->Detach();
+    while (!extra.Attach(name)) {
+        std::this_thread::yield();
+    }
+}
+
+TEST(ShmTransportTest, should_serve_client_in_another_process)
+{
+    // given
+    const std::string name = SegmentName("fork");
+    RunningServer running(name, ShmTransportOptions{});
+    ASSERT_TRUE(running.created);
+    std::unique_ptr<Executor> expected(Executor::NewExecutor({3, 4, 'S'}));
+    expected->Execute("MMRMMBMM");
+
+    // when
+    const pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        ShmCommandClient client;
+        Response response{};
+        const bool ok = client.Attach(name) && client.SubmitReset(42, 0, {3, 4, 'S'}) &&
+                        client.Receive(&response, 1, TIMEOUT_NS) == 1 && client.SubmitExecute(42, 1, "MMRMMBMM") &&
+                        client.Receive(&response, 1, TIMEOUT_NS) == 1 && response.tag == 1 &&
+                        PoseOf(response) == expected->Query();
+        client.Detach();
+        ::_exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(child, ::waitpid(child, &status, 0));
+    running.Stop();
+
+    // then
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+    ASSERT_EQ(1u, running.server.Stats().accepted);
+    ASSERT_EQ(1u, running.server.Vehicles());
+}
+TEST(ShmTransportTest, should_drop_corrupt_ring_indices_and_oversized_frames)
+{
+    // given: 不运行消费循环，手动Poll
+    const std::string name = SegmentName("corrupt");
+    ShmTransportOptions options;
+    options.slots = 1;
+    options.ringBytes = 256;
+    ShmCommandServer server(name, options);
+    ASSERT_TRUE(server.Create());
+    ShmCommandClient client;
+    ASSERT_TRUE(client.Attach(name));
+    SlotWriter writer(name);
+    ASSERT_NE(nullptr, writer.base);
+    ASSERT_TRUE(client.SubmitExecute(1, 0, "M"));
+    ASSERT_EQ(sizeof(RequestHeader) + 1, writer.RequestHead().load());  // 确认偏移没有算错
+    ASSERT_EQ(1u, server.Poll());
+    Response response{};
+    ASSERT_EQ(1u, client.Receive(&response, 1));
+
+    // when: head超出tail一个环以上
+    const std::uint64_t tail = writer.RequestHead().load();
+    writer.WriteHeader(tail, RequestHeader{1, static_cast<std::uint16_t>(FrameType::EXECUTE), 0, 1, 1});
+    writer.RequestHead().store(tail + 10 * writer.RingBytes());
+
+    // then
+    ASSERT_EQ(0u, server.Poll());
+    ASSERT_EQ(1u, server.Stats().badFrames);
+
+    // when: 帧长没有超过MAX_FRAME_PAYLOAD，但超过了环容量，head与帧长一致
+    const std::uint64_t next = writer.RequestHead().load();
+    writer.WriteHeader(next, RequestHeader{4096, static_cast<std::uint16_t>(FrameType::EXECUTE), 0, 1, 2});
+    writer.RequestHead().store(next + sizeof(RequestHeader) + 4096);
+
+    // then
+    ASSERT_EQ(0u, server.Poll());
+    ASSERT_EQ(2u, server.Stats().badFrames);
+    ASSERT_EQ(0u, client.Receive(&response, 1));
+
+    // when: 丢弃损坏的字节后槽位照常可用
+    ASSERT_TRUE(client.SubmitExecute(1, 3, "MM"));
+    ASSERT_EQ(1u, server.Poll());
+
+    // then
+    ASSERT_EQ(1u, client.Receive(&response, 1));
+    ASSERT_EQ(3u, response.tag);
+    ASSERT_EQ(Pose({0, 3, 'N'}), PoseOf(response));
+}
+
+TEST(ShmTransportTest, should_count_frames_with_wrong_payload_length)
+{
+    // given
+    const std::string name = SegmentName("length");
+    ShmTransportOptions options;
+    options.slots = 1;
+    ShmCommandServer server(name, options);
+    ASSERT_TRUE(server.Create());
+    ShmCommandClient client;
+    ASSERT_TRUE(client.Attach(name));
+    ASSERT_TRUE(client.SubmitReset(1, 0, {0, 0, 'N'}));
+    const char payload[sizeof(ResetPayload) + 1] = {};
+
+    // when: QUERY、REMOVE不带负载，RESET的负载必须恰好是ResetPayload
+    ASSERT_TRUE(client.Submit(FrameType::QUERY, 1, 1, payload, 1));
+    ASSERT_TRUE(client.Submit(FrameType::REMOVE, 1, 2, payload, 1));
+    ASSERT_TRUE(client.Submit(FrameType::RESET, 1, 3, payload, sizeof(payload)));
+    ASSERT_EQ(4u, server.Poll());
+
+    // then: 连接保持，车辆不受影响
+    Response responses[4]{};
+    ASSERT_EQ(4u, client.Receive(responses, 4));
+    for (std::size_t i = 1; i < 4; ++i) {
+        ASSERT_EQ(static_cast<std::uint16_t>(FrameStatus::BAD_FRAME), responses[i].status);
+        ASSERT_EQ(i, responses[i].tag);
+    }
+    ASSERT_EQ(3u, server.Stats().badFrames);
+    ASSERT_EQ(1u, server.Vehicles());
+}
+}  // namespace adas
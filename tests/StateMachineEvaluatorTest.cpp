@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DifferentialHarness.hpp"
+#include "Executor.hpp"
+#include "ExecutorMetrics.hpp"
+#include "PoseEq.hpp"
+#include "StateMachineEvaluator.hpp"
+#include "TestFixtures.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+const EvaluatorIsa ALL_ISAS[] = {EvaluatorIsa::SCALAR, EvaluatorIsa::SSSE3, EvaluatorIsa::AVX2};
+
+// 测试结束后恢复进程级的实现选择
+class IsaGuard final
+{
+public:
+    IsaGuard(void) noexcept : saved(GetEvaluatorIsa())
+    {
+    }
+    ~IsaGuard() noexcept
+    {
+        SetEvaluatorIsa(saved);
+    }
+
+private:
+    EvaluatorIsa saved;
+};
+
+struct Outcome
+{
+    Pose pose;
+    CarMode mode;
+    ExecutorCounters counters;
+};
+
+Outcome ExecuteWith(const EvaluatorIsa isa, const EngineState& initial, const std::string& commands)
+{
+    SetEvaluatorIsa(isa);
+    std::unique_ptr<Executor> executor(Executor::NewExecutor(initial.pose, initial.mode));
+    executor->Execute(commands);
+    return Outcome{executor->Query(), executor->QueryMode(), executor->QueryCounters()};
+}
+
+// 随机字母表偏向TR、未知字符和车型切换，覆盖块边界上的各种组合
+std::string RandomCommands(std::uint32_t seed, const std::size_t length)
+{
+    static const char alphabet[] = "MMMMLRFBNUTRTRTTXRM";
+    std::string commands;
+    while (commands.size() < length) {
+        seed = seed * 1103515245u + 12345u;
+        commands.push_back(alphabet[(seed >> 16) % (sizeof(alphabet) - 1)]);
+    }
+    return commands;
+}
+
+std::vector<std::string> Corpora(void)
+{
+    WorkloadConfig longRuns;
+    longRuns.seed = 7;
+    longRuns.meanRunLength = 40.0;
+    longRuns.carTypeSwitchRate = 0.0005;
+    longRuns.turnRoundRate = 0.02;
+    longRuns.junkRate = 0.01;
+    std::string boundary = std::string(63, 'M') + "TR" + std::string(62, 'L') + "T" + std::string(64, 'F') + "RTR";
+    // 整块相同的指令按闭式结果折叠
+    std::string uniform = "F" + std::string(300, 'M') + std::string(130, 'L') + "B" + std::string(200, 'X') +
+                          std::string(129, 'R') + std::string(64, 'B') + "U" + std::string(190, 'M');
+    return {WorkloadGenerator().Generate(20000, 1), WorkloadGenerator(longRuns).Generate(20000, 1),
+            RandomCommands(1, 5000), RandomCommands(2, 777), boundary, uniform};
+}
+}  // namespace
+
+TEST(StateMachineEvaluatorTest, set_isa_should_fall_back_to_what_cpu_supports)
+{
+    // given
+    IsaGuard guard;
+
+    // when
+    const EvaluatorIsa effective = SetEvaluatorIsa(EvaluatorIsa::AVX2);
+
+    // then
+    ASSERT_LE(static_cast<unsigned>(effective), static_cast<unsigned>(BestEvaluatorIsa()));
+    ASSERT_EQ(effective, GetEvaluatorIsa());
+    ASSERT_EQ(EvaluatorIsa::SCALAR, SetEvaluatorIsa(EvaluatorIsa::SCALAR));
+}
+
+TEST(StateMachineEvaluatorTest, every_isa_should_match_byte_loop)
+{
+    // given
+    IsaGuard guard;
+    const CarType types[] = {CarType::NORMAL, CarType::SPORTS, CarType::BUS, TestTruckType()};
+
+    for (const std::string& commands : Corpora()) {
+        for (const CarType carType : types) {
+            for (unsigned flags = 0; flags < 4; ++flags) {
+                const EngineState initial{{3, -2, "NESW"[flags]}, {carType, (flags & 1) != 0, (flags & 2) != 0}};
+
+                // when
+                const Outcome expected = ExecuteWith(EvaluatorIsa::SCALAR, initial, commands);
+
+                // then
+                for (const EvaluatorIsa isa : ALL_ISAS) {
+                    const Outcome actual = ExecuteWith(isa, initial, commands);
+                    ASSERT_EQ(expected.pose, actual.pose) << static_cast<unsigned>(isa);
+                    ASSERT_EQ(expected.mode.carType, actual.mode.carType);
+                    ASSERT_EQ(expected.mode.fast, actual.mode.fast);
+                    ASSERT_EQ(expected.mode.reverse, actual.mode.reverse);
+                    for (std::size_t i = 0; i < ExecutorCounters::SIZE; ++i) {
+                        ASSERT_EQ(expected.counters.values[i], actual.counters.values[i]) << "counter " << i;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(StateMachineEvaluatorTest, vectorized_execute_should_match_reference)
+{
+    // given
+    IsaGuard guard;
+    const EngineState initial{{0, 0, 'N'}, CarMode{}};
+
+    for (const std::string& commands : Corpora()) {
+        // when
+        const Outcome actual = ExecuteWith(BestEvaluatorIsa(), initial, commands);
+
+        // then
+        const EngineState expected = RunReference(initial, commands);
+        ASSERT_EQ(expected.pose, actual.pose);
+        ASSERT_TRUE(SameState(expected, EngineState{actual.pose, actual.mode}));
+    }
+}
+}  // namespace adas
@@ -0,0 +1,32 @@
+#include "TestFixtures.hpp"
+#include <gtest/gtest.h>
+
+namespace adas
+{
+CarType RegisterTestVehicleType(const std::string& name, const VehicleSpec& spec)
+{
+    CarType type = CarType::NORMAL;
+    if (!FindCarType(name, type)) {
+        VehicleSpec named = spec;
+        named.name = name;
+        std::string error;
+        EXPECT_TRUE(RegisterVehicleTypes({named}, error)) << error;
+        FindCarType(name, type);
+    }
+    return type;
+}
+
+CarType TestTruckType(void)
+{
+    VehicleSpec truck;
+    truck.move[0] = 3;
+    truck.move[1] = 15;
+    truck.turnBefore[0] = 2;
+    truck.turnBefore[1] = 15;
+    truck.turnAfter[0] = 1;
+    truck.turnAfter[1] = 15;
+    truck.onN = "NORMAL";
+    truck.onU = "BUS";
+    return RegisterTestVehicleType("TEST_TRUCK", truck);
+}
+}  // namespace adas
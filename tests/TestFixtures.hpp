@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "ExecutorListener.hpp"
+#include "VehicleTypes.hpp"
+
+namespace adas
+{
+// 向进程级车型表注册测试车型，同名车型已注册时直接返回它。车型表最多MAX_CAR_TYPES种且不能删除，
+// 步数无关紧要的测试应共用TestTruckType，不要各自注册
+CarType RegisterTestVehicleType(const std::string& name, const VehicleSpec& spec);
+
+// 转弯前后都要走的车型，一条指令的路径不是直线；加速时每段走15格，覆盖8位累加的最小组长
+CarType TestTruckType(void);
+
+// 什么都不做的监听器，安装后执行走带事件的路径
+class NullListener final : public ExecutorListener
+{
+public:
+    void OnEvents(const ExecutorEvent*, const std::size_t) noexcept override
+    {
+    }
+};
+}  // namespace adas
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PoseEq.hpp"
+#include "VehicleRegistry.hpp"
+
+namespace adas
+{
+TEST(VehicleRegistryTest, should_insert_find_and_remove_by_id_and_name)
+{
+    // given
+    VehicleRegistry registry(2);
+
+    // when
+    for (std::uint64_t id = 0; id < 1000; ++id) {
+        ASSERT_TRUE(registry.Insert(id * 7919, {static_cast<int>(id), 0, 'N'}));
+    }
+    ASSERT_TRUE(registry.Insert("truck-1", {1, 2, 'E'}, CarMode{CarType::BUS, false, false}));
+    ASSERT_TRUE(registry.Insert("", {3, 4, 'S'}));
+    ASSERT_FALSE(registry.Insert(7919, {0, 0, 'N'}));
+    ASSERT_FALSE(registry.Insert("truck-1", {0, 0, 'N'}));
+    for (std::uint64_t id = 0; id < 1000; id += 2) {
+        ASSERT_TRUE(registry.Remove(id * 7919));
+    }
+    ASSERT_FALSE(registry.Remove(0));
+    ASSERT_FALSE(registry.Remove("truck-2"));
+
+    // then
+    const VehicleRegistry::Guard guard;
+    ASSERT_EQ(502u, registry.Size());
+    for (std::uint64_t id = 0; id < 1000; ++id) {
+        Executor* executor = registry.Find(guard, id * 7919);
+        if (id % 2 == 0) {
+            ASSERT_EQ(nullptr, executor);
+        } else {
+            ASSERT_NE(nullptr, executor);
+            const Pose pose{static_cast<int>(id), 0, 'N'};
+            ASSERT_EQ(pose, executor->Query());
+        }
+    }
+    ASSERT_EQ(CarType::BUS, registry.Find(guard, "truck-1")->QueryMode().carType);
+    const Pose empty{3, 4, 'S'};
+    ASSERT_EQ(empty, registry.Find(guard, "")->Query());
+    ASSERT_EQ(nullptr, registry.Find(guard, "truck-2"));
+}
+
+TEST(VehicleRegistryTest, readers_should_never_see_reused_executors)
+{
+    // given: 每个编号的执行器位姿都是(编号, 0)；写者反复移除再插入，被回收的执行器会以别的编号复用
+    VehicleRegistry registry(1);
+    const std::uint64_t ids = 512;
+    for (std::uint64_t id = 0; id < ids; ++id) {
+        registry.Insert(id, {static_cast<int>(id), 0, 'N'});
+    }
+    std::atomic<bool> done{false};
+    std::atomic<int> wrong{0};
+
+    // when
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&registry, &done, &wrong, r] {
+            for (std::uint64_t i = static_cast<std::uint64_t>(r); !done.load(); i += 7) {
+                const VehicleRegistry::Guard guard;
+                const std::uint64_t id = i % ids;
+                const Executor* executor = registry.Find(guard, id);
+                if (executor != nullptr && executor->QueryPublished().pose.x != static_cast<int>(id)) {
+                    wrong.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (int round = 0; round < 200; ++round) {
+        for (std::uint64_t id = static_cast<std::uint64_t>(round) % 3; id < ids; id += 3) {
+            ASSERT_TRUE(registry.Remove(id));
+            ASSERT_TRUE(registry.Insert(id, {static_cast<int>(id), 0, 'N'}));
+        }
+    }
+    done.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    // then
+    ASSERT_EQ(0, wrong.load());
+    ASSERT_EQ(ids, registry.Size());
+}
+}  // namespace adas
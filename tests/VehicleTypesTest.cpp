@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include "Executor.hpp"
+#include "ExecutorMetrics.hpp"
+#include "PoseEq.hpp"
+#include "VehicleTypes.hpp"
+
+namespace adas
+{
+namespace
+{
+// 卡车：加速不提速，转向前后各走一格，只能通过U切换回普通车
+const char TRUCK_CONFIG[] =
+    "# test vehicles\n"
+    "[TRUCK]\n"
+    "move = 1 1\n"
+    "turn_before = 1 1\n"
+    "turn_after = 1 1\n"
+    "on_n = -\n"
+    "on_u = NORMAL\n"
+    "\n"
+    "[TRAILER]\n"
+    "move = 0 0      # 不能自行移动\n"
+    "turn_before = 0 0\n"
+    "on_n = TRUCK\n"
+    "on_u = TRUCK\n";
+
+CarType TypeNamed(const std::string& name)
+{
+    CarType type = CarType::NORMAL;
+    EXPECT_TRUE(FindCarType(name, type)) << name;
+    return type;
+}
+
+void RegisterTestTypes(void)
+{
+    CarType type;
+    if (FindCarType("TRUCK", type)) {
+        return;
+    }
+    std::vector<VehicleSpec> specs;
+    std::string error;
+    ASSERT_TRUE(ParseVehicleTypes(TRUCK_CONFIG, specs, error)) << error;
+    ASSERT_TRUE(RegisterVehicleTypes(specs, error)) << error;
+}
+}  // namespace
+
+TEST(VehicleTypesTest, builtin_types_should_be_registered_in_enum_order)
+{
+    ASSERT_STREQ("NORMAL", CarTypeName(CarType::NORMAL));
+    ASSERT_STREQ("SPORTS", CarTypeName(CarType::SPORTS));
+    ASSERT_STREQ("BUS", CarTypeName(CarType::BUS));
+    ASSERT_EQ(CarType::BUS, TypeNamed("BUS"));
+}
+
+TEST(VehicleTypesTest, custom_type_should_follow_its_config)
+{
+    // given
+    RegisterTestTypes();
+    const CarType truck = TypeNamed("TRUCK");
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'N'}, {truck, false, false}));
+
+    // when
+    executor->Execute("MFMLN");
+
+    // then
+    ASSERT_EQ(Pose({-1, 3, 'W'}), executor->Query());
+    ASSERT_EQ(truck, executor->QueryMode().carType);
+    ASSERT_TRUE(executor->QueryMode().fast);
+    ASSERT_EQ(1u, executor->QueryCounters()[ExecutorCounter::N_REFUSED_IN_BUS]);
+    ASSERT_EQ(4u, executor->QueryCounters()[ExecutorCounter::GRID_STEPS]);
+}
+
+TEST(VehicleTypesTest, custom_types_should_switch_between_each_other_and_builtins)
+{
+    // given
+    RegisterTestTypes();
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'N'}, {TypeNamed("TRAILER"), true, true}));
+
+    // when
+    executor->Execute("MN");
+    const CarMode afterN = executor->QueryMode();
+    executor->Execute("UM");
+
+    // then
+    ASSERT_EQ(TypeNamed("TRUCK"), afterN.carType);
+    ASSERT_FALSE(afterN.fast);
+    ASSERT_FALSE(afterN.reverse);
+    ASSERT_EQ(Pose({0, 1, 'N'}), executor->Query());
+    ASSERT_EQ(CarType::NORMAL, executor->QueryMode().carType);
+}
+
+TEST(VehicleTypesTest, should_load_types_from_file)
+{
+    // given
+    const std::string path = ::testing::TempDir() + "vehicles.ini";
+    std::ofstream(path) << "[CRANE]\nmove = 3 5\non_u = BUS\n";
+    std::string error;
+
+    // when
+    const bool loaded = LoadVehicleTypes(path, error);
+
+    // then
+    ASSERT_TRUE(loaded) << error;
+    std::unique_ptr<Executor> executor(Executor::NewExecutor({0, 0, 'E'}, {TypeNamed("CRANE"), true, false}));
+    executor->Execute("M");
+    ASSERT_EQ(Pose({5, 0, 'E'}), executor->Query());
+    std::remove(path.c_str());
+}
+
+TEST(VehicleTypesTest, should_reject_invalid_configs_without_registering_anything)
+{
+    std::vector<VehicleSpec> specs;
+    std::string error;
+    ASSERT_FALSE(ParseVehicleTypes("move = 1 1\n", specs, error));
+    ASSERT_FALSE(ParseVehicleTypes("[X]\nspeed = 3\n", specs, error));
+    ASSERT_FALSE(ParseVehicleTypes("[X]\nmove = 1\n", specs, error));
+
+    // given
+    specs.clear();
+    ASSERT_TRUE(ParseVehicleTypes("[GOOD]\non_u = NORMAL\n[BAD]\non_u = NOWHERE\n", specs, error)) << error;
+    const std::size_t before = CarTypeCount();
+
+    // when
+    const bool registered = RegisterVehicleTypes(specs, error);
+
+    // then
+    ASSERT_FALSE(registered);
+    ASSERT_NE(std::string::npos, error.find("NOWHERE"));
+    ASSERT_EQ(before, CarTypeCount());
+    CarType type;
+    ASSERT_FALSE(FindCarType("GOOD", type));
+}
+
+TEST(VehicleTypesTest, should_reject_duplicate_and_oversized_types)
+{
+    std::string error;
+    VehicleSpec normal;
+    normal.name = "NORMAL";
+    normal.onU = "BUS";
+    ASSERT_FALSE(RegisterVehicleTypes({normal}, error));
+
+    VehicleSpec fast;
+    fast.name = "ROCKET";
+    fast.move[1] = MAX_VEHICLE_STEPS + 1;
+    fast.onU = "NORMAL";
+    ASSERT_FALSE(RegisterVehicleTypes({fast}, error));
+}
+}  // namespace adas
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "WorkloadGenerator.hpp"
+
+namespace adas
+{
+namespace
+{
+WorkloadConfig SmallChunks(void)
+{
+    WorkloadConfig config;
+    config.seed = 42;
+    config.chunkSize = 4096;
+    config.junkRate = 0.01;
+    return config;
+}
+}  // namespace
+
+TEST(WorkloadGeneratorTest, should_generate_same_commands_regardless_of_threads)
+{
+    // given
+    const WorkloadGenerator generator(SmallChunks());
+
+    // when
+    const std::string single = generator.Generate(100000, 1);
+    const std::string parallel = generator.Generate(100000, 4);
+
+    // then
+    ASSERT_EQ(100000u, single.size());
+    ASSERT_EQ(single, parallel);
+}
+
+TEST(WorkloadGeneratorTest, should_generate_different_commands_for_different_seeds)
+{
+    // given
+    WorkloadConfig config = SmallChunks();
+    const WorkloadGenerator first(config);
+    config.seed = 43;
+    const WorkloadGenerator second(config);
+
+    // when
+    const std::string a = first.Generate(1000, 1);
+    const std::string b = second.Generate(1000, 1);
+
+    // then
+    ASSERT_NE(a, b);
+}
+
+TEST(WorkloadGeneratorTest, should_only_generate_enabled_opcodes)
+{
+    // given
+    WorkloadConfig config;
+    config.mix = OpcodeMix{1, 0, 1, 0, 0};
+    config.carTypeSwitchRate = 0;
+    config.turnRoundRate = 0;
+    config.junkRate = 0;
+
+    // when
+    const std::string commands = WorkloadGenerator(config).Generate(10000, 1);
+
+    // then
+    ASSERT_EQ(std::string::npos, commands.find_first_not_of("MR"));
+    ASSERT_NE(std::string::npos, commands.find('M'));
+    ASSERT_NE(std::string::npos, commands.find('R'));
+}
+
+TEST(WorkloadGeneratorTest, should_follow_configured_run_length_and_rates)
+{
+    // given
+    WorkloadConfig config;
+    config.meanRunLength = 4.0;
+    config.carTypeSwitchRate = 0.01;
+    config.busShare = 1.0;
+    config.turnRoundRate = 0;
+    config.junkRate = 0;
+
+    // when
+    const std::string commands = WorkloadGenerator(config).Generate(1 << 20, 1);
+
+    // then
+    std::size_t opcodes = 0;
+    std::size_t runs = 0;
+    char previous = '\0';
+    for (const char c : commands) {
+        if (c == 'U') {
+            continue;
+        }
+        ++opcodes;
+        runs += (c != previous) ? 1 : 0;
+        previous = c;
+    }
+    const double meanRun = static_cast<double>(opcodes) / runs;
+    const double switchRate = static_cast<double>(std::count(commands.begin(), commands.end(), 'U')) / commands.size();
+    ASSERT_NEAR(4.0, meanRun, 0.2);
+    ASSERT_NEAR(0.01, switchRate, 0.002);
+    ASSERT_EQ(std::string::npos, commands.find('N'));
+}
+
+TEST(WorkloadGeneratorTest, should_never_split_turn_round)
+{
+    // given
+    WorkloadConfig config = SmallChunks();
+    config.turnRoundRate = 0.3;
+
+    // when
+    const std::string commands = WorkloadGenerator(config).Generate(50000, 2);
+
+    // then
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        if (commands[i] == 'T') {
+            ASSERT_LT(i + 1, commands.size());
+            ASSERT_EQ('R', commands[i + 1]);
+        }
+    }
+}
+
+TEST(WorkloadGeneratorTest, should_write_same_commands_to_file)
+{
+    // given
+    const WorkloadGenerator generator(SmallChunks());
+    const std::string path = "workload_generator_test.txt";
+
+    // when
+    const bool written = generator.WriteFile(path, 30000, 3);
+
+    // then
+    ASSERT_TRUE(written);
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    ASSERT_EQ(generator.Generate(30000, 1), content.str());
+    std::remove(path.c_str());
+}
+}  // namespace adas
@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "DifferentialHarness.hpp"
+
+namespace
+{
+[[noreturn]] void Usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--cases=N] [--max-length=N] [--seed=N] [--threads=N] [--generated-share=P]\n"
+                 "       %s --commands=STRING [--pose=x,y,heading] [--mode=NORMAL|SPORTS|BUS[,fast][,reverse]]\n",
+                 program, program);
+    std::exit(2);
+}
+
+adas::CarMode ParseMode(const std::string& text)
+{
+    adas::CarMode mode;
+    mode.carType = text.compare(0, 6, "SPORTS") == 0 ? adas::CarType::SPORTS
+                   : text.compare(0, 3, "BUS") == 0  ? adas::CarType::BUS
+                                                     : adas::CarType::NORMAL;
+    mode.fast = text.find(",fast") != std::string::npos;
+    mode.reverse = text.find(",reverse") != std::string::npos;
+    return mode;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    adas::DifferentialOptions options;
+    adas::EngineState initial{{0, 0, 'N'}, adas::CarMode{}};
+    std::string commands;
+    bool single = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = std::strchr(arg, '=');
+        if (value == nullptr) {
+            Usage(argv[0]);
+        }
+        ++value;
+        if (std::strncmp(arg, "--cases=", 8) == 0) {
+            options.cases = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(arg, "--max-length=", 13) == 0) {
+            options.maxLength = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(arg, "--threads=", 10) == 0) {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strncmp(arg, "--generated-share=", 18) == 0) {
+            options.generatedShare = std::atof(value);
+        } else if (std::strncmp(arg, "--commands=", 11) == 0) {
+            commands = value;
+            single = true;
+        } else if (std::strncmp(arg, "--pose=", 7) == 0) {
+            char heading = 'N';
+            if (std::sscanf(value, "%d,%d,%c", &initial.pose.x, &initial.pose.y, &heading) != 3) {
+                Usage(argv[0]);
+            }
+            initial.pose.heading = heading;
+        } else if (std::strncmp(arg, "--mode=", 7) == 0) {
+            initial.mode = ParseMode(value);
+        } else {
+            Usage(argv[0]);
+        }
+    }
+
+    const adas::DifferentialHarness harness = adas::DifferentialHarness::WithBuiltinEngines();
+    if (single) {
+        const std::vector<adas::Divergence> divergences = harness.Check(initial, commands);
+        for (const adas::Divergence& divergence : divergences) {
+            std::fputs(adas::FormatDivergence(divergence).c_str(), stdout);
+        }
+        return divergences.empty() ? 0 : 1;
+    }
+
+    std::string names;
+    for (const std::string& name : harness.EngineNames()) {
+        names += (names.empty() ? "" : ", ") + name;
+    }
+    std::printf("engines: %s\n", names.c_str());
+    const auto start = std::chrono::steady_clock::now();
+    const adas::DifferentialReport report = harness.Run(options);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%llu cases, %llu commands checked in %.1f s (%.0f commands/s)\n",
+                static_cast<unsigned long long>(report.cases), static_cast<unsigned long long>(report.commands),
+                seconds, seconds > 0 ? report.commands / seconds : 0.0);
+    for (const adas::Divergence& divergence : report.divergences) {
+        std::fputs(adas::FormatDivergence(divergence).c_str(), stdout);
+    }
+    return report.divergences.empty() ? 0 : 1;
+}
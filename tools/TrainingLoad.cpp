@@ -0,0 +1,267 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "CommandProtocol.hpp"
+#include "ExecutorProfiler.hpp"
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+// 各帧的指令从这段预先生成的指令流中截取
+constexpr std::size_t POOL_SIZE = 1 << 20;
+
+struct Options
+{
+    std::string unixPath;
+    std::uint16_t port{7878};
+    unsigned connections{64};
+    unsigned vehicles{16};   // 每个连接轮流驱动的车辆数，编号互不重叠
+    std::size_t batch{256};  // 每帧的指令数
+    unsigned pipeline{4};    // 每个连接未收到应答的帧数上限
+    double seconds{5.0};
+    std::uint64_t seed{1};
+};
+
+struct Client
+{
+    int fd;
+    unsigned index;
+    std::string out;
+    std::size_t outBegin{0};
+    std::vector<char> in;
+    std::size_t inEnd{0};
+    unsigned inflight{0};
+    std::uint64_t sent{0};
+};
+
+struct Totals
+{
+    std::uint64_t frames{0};
+    std::uint64_t commands{0};
+    std::uint64_t errors{0};
+    std::uint64_t inflight{0};
+    adas::LatencyHistogram latency;
+};
+
+[[noreturn]] void Usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--unix=path | --port=N] [--connections=N] [--vehicles=N] [--batch=N]\n"
+                 "          [--pipeline=N] [--seconds=X] [--seed=N]\n",
+                 program);
+    std::exit(2);
+}
+
+Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = std::strchr(arg, '=');
+        if (value == nullptr) {
+            Usage(argv[0]);
+        }
+        ++value;
+        if (std::strncmp(arg, "--unix=", 7) == 0) {
+            options.unixPath = value;
+        } else if (std::strncmp(arg, "--port=", 7) == 0) {
+            options.port = static_cast<std::uint16_t>(std::atoi(value));
+        } else if (std::strncmp(arg, "--connections=", 14) == 0) {
+            options.connections = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strncmp(arg, "--vehicles=", 11) == 0) {
+            options.vehicles = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strncmp(arg, "--batch=", 8) == 0) {
+            options.batch = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(arg, "--pipeline=", 11) == 0) {
+            options.pipeline = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strncmp(arg, "--seconds=", 10) == 0) {
+            options.seconds = std::atof(value);
+        } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else {
+            Usage(argv[0]);
+        }
+    }
+    if (options.connections == 0 || options.vehicles == 0 || options.pipeline == 0 || options.batch == 0 ||
+        options.batch > POOL_SIZE / 2 || options.batch > adas::MAX_FRAME_PAYLOAD) {
+        Usage(argv[0]);
+    }
+    return options;
+}
+
+std::uint64_t NowNs(void) noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// 阻塞地建立连接，之后转为非阻塞
+int Connect(const Options& options)
+{
+    int fd = -1;
+    int result = -1;
+    if (options.unixPath.empty()) {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        result = ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    } else {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        options.unixPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        result = ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    }
+    if (result != 0) {
+        ::close(fd);
+        return -1;
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// tag中放发送时刻，应答回来时直接算出往返时间
+void Refill(Client& client, const Options& options, const std::string& pool, Totals& totals)
+{
+    while (client.inflight < options.pipeline) {
+        const std::uint64_t vehicle =
+            static_cast<std::uint64_t>(client.index) * options.vehicles + client.sent % options.vehicles + 1;
+        const std::uint64_t slice = client.index * 7919ull + client.sent;
+        const std::size_t offset = static_cast<std::size_t>(slice * options.batch % (POOL_SIZE - options.batch));
+        adas::AppendRequest(client.out, adas::FrameType::EXECUTE, vehicle, NowNs(), pool.data() + offset,
+                            options.batch);
+        ++client.inflight;
+        ++client.sent;
+        ++totals.inflight;
+    }
+}
+
+bool Send(Client& client)
+{
+    while (client.outBegin < client.out.size()) {
+        const ssize_t sent = ::send(client.fd, client.out.data() + client.outBegin,
+                                    client.out.size() - client.outBegin, MSG_NOSIGNAL);
+        if (sent < 0) {
+            // 发不出去的部分等下次收到应答或超时再发
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        client.outBegin += static_cast<std::size_t>(sent);
+    }
+    client.out.clear();
+    client.outBegin = 0;
+    return true;
+}
+
+bool Receive(Client& client, const Options& options, Totals& totals)
+{
+    const ssize_t received = ::recv(client.fd, client.in.data() + client.inEnd, client.in.size() - client.inEnd, 0);
+    if (received <= 0) {
+        // 服务端关闭连接视为出错
+        return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    }
+    client.inEnd += static_cast<std::size_t>(received);
+    const std::uint64_t now = NowNs();
+    std::size_t begin = 0;
+    for (; client.inEnd - begin >= sizeof(adas::Response); begin += sizeof(adas::Response)) {
+        adas::Response response;
+        std::memcpy(&response, client.in.data() + begin, sizeof(response));
+        totals.latency.Record(now - response.tag);
+        ++totals.frames;
+        totals.commands += options.batch;
+        totals.errors += response.status != static_cast<std::uint16_t>(adas::FrameStatus::OK) ? 1 : 0;
+        --client.inflight;
+        --totals.inflight;
+    }
+    std::memmove(client.in.data(), client.in.data() + begin, client.inEnd - begin);
+    client.inEnd -= begin;
+    return true;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const Options options = ParseOptions(argc, argv);
+    adas::WorkloadConfig config;
+    config.seed = options.seed;
+    const std::string pool = adas::WorkloadGenerator(config).Generate(POOL_SIZE, 1);
+
+    const int epollFd = ::epoll_create1(0);
+    std::vector<Client> clients(options.connections);
+    for (unsigned i = 0; i < options.connections; ++i) {
+        Client& client = clients[i];
+        client.fd = Connect(options);
+        if (client.fd < 0) {
+            std::perror("connect");
+            return 1;
+        }
+        client.index = i;
+        client.in.resize(64 * 1024);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+    }
+
+    Totals totals;
+    const std::uint64_t start = NowNs();
+    const std::uint64_t deadline = start + static_cast<std::uint64_t>(options.seconds * 1e9);
+    for (Client& client : clients) {
+        Refill(client, options, pool, totals);
+        Send(client);
+    }
+    // 到时后不再发送新帧，收完在途的应答
+    std::vector<epoll_event> events(options.connections);
+    while (totals.inflight > 0) {
+        const bool sending = NowNs() < deadline;
+        const int ready = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 100);
+        for (int i = 0; i < ready; ++i) {
+            Client& client = clients[events[i].data.u32];
+            if (!Receive(client, options, totals)) {
+                std::fprintf(stderr, "connection %u closed\n", client.index);
+                return 1;
+            }
+            if (sending) {
+                Refill(client, options, pool, totals);
+            }
+            if (!Send(client)) {
+                std::perror("send");
+                return 1;
+            }
+        }
+        if (ready <= 0) {
+            for (Client& client : clients) {
+                Send(client);
+            }
+        }
+    }
+    const double seconds = static_cast<double>(NowNs() - start) / 1e9;
+
+    std::printf("%llu frames, %llu commands in %.2f s: %.0f commands/s, %.0f frames/s, %llu errors\n",
+                static_cast<unsigned long long>(totals.frames), static_cast<unsigned long long>(totals.commands),
+                seconds, static_cast<double>(totals.commands) / seconds, static_cast<double>(totals.frames) / seconds,
+                static_cast<unsigned long long>(totals.errors));
+    std::printf("round trip us: p50 %.1f p99 %.1f p999 %.1f max %.1f\n", totals.latency.Percentile(0.5) / 1e3,
+                totals.latency.Percentile(0.99) / 1e3, totals.latency.Percentile(0.999) / 1e3,
+                totals.latency.Max() / 1e3);
+    for (const Client& client : clients) {
+        ::close(client.fd);
+    }
+    ::close(epollFd);
+    return totals.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "CommandServer.hpp"
+#include "ShmTransport.hpp"
+
+namespace
+{
+adas::CommandServer* running = nullptr;
+adas::ShmCommandServer* runningShm = nullptr;
+
+[[noreturn]] void Usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--unix=path | --port=N] [--max-connections=N]\n"
+                 "       %s --shm=name [--slots=N] [--ring-bytes=N]\n",
+                 program, program);
+    std::exit(2);
+}
+
+void OnSignal(int)
+{
+    if (running != nullptr) {
+        running->Stop();
+    }
+    if (runningShm != nullptr) {
+        runningShm->Stop();
+    }
+}
+
+void PrintStats(const adas::CommandServerStats& stats, const std::size_t vehicles)
+{
+    std::printf("%llu connections (%llu rejected), %llu frames, %llu command bytes, %llu bad frames, %zu vehicles\n",
+                static_cast<unsigned long long>(stats.accepted), static_cast<unsigned long long>(stats.rejected),
+                static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.commandBytes),
+                static_cast<unsigned long long>(stats.badFrames), vehicles);
+}
+
+void InstallSignals(void)
+{
+    struct sigaction action{};
+    action.sa_handler = OnSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+// 共享内存传输，客户端用ShmCommandClient按名字连接
+int RunShm(const std::string& name, const adas::ShmTransportOptions& options)
+{
+    adas::ShmCommandServer server(name, options);
+    if (!server.Create()) {
+        std::perror("shm_open");
+        return 1;
+    }
+    runningShm = &server;
+    InstallSignals();
+    std::printf("serving shared memory %s\n", name.c_str());
+    std::fflush(stdout);
+    server.Run();
+    runningShm = nullptr;
+    PrintStats(server.Stats(), server.Vehicles());
+    return 0;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    adas::CommandServerOptions options;
+    options.port = 7878;
+    std::string shm;
+    adas::ShmTransportOptions shmOptions;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = std::strchr(arg, '=');
+        if (value == nullptr) {
+            Usage(argv[0]);
+        }
+        ++value;
+        if (std::strncmp(arg, "--unix=", 7) == 0) {
+            options.unixPath = value;
+        } else if (std::strncmp(arg, "--port=", 7) == 0) {
+            options.port = static_cast<std::uint16_t>(std::atoi(value));
+        } else if (std::strncmp(arg, "--max-connections=", 18) == 0) {
+            options.maxConnections = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(arg, "--shm=", 6) == 0) {
+            shm = value;
+        } else if (std::strncmp(arg, "--slots=", 8) == 0) {
+            shmOptions.slots = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strncmp(arg, "--ring-bytes=", 13) == 0) {
+            shmOptions.ringBytes = std::strtoull(value, nullptr, 10);
+        } else {
+            Usage(argv[0]);
+        }
+    }
+
+    if (!shm.empty()) {
+        return RunShm(shm, shmOptions);
+    }
+
+    adas::CommandServer server(options);
+    if (!server.Listen()) {
+        std::perror("listen");
+        return 1;
+    }
+    running = &server;
+    InstallSignals();
+    if (options.unixPath.empty()) {
+        std::printf("listening on 127.0.0.1:%u\n", static_cast<unsigned>(server.Port()));
+    } else {
+        std::printf("listening on %s\n", options.unixPath.c_str());
+    }
+    std::fflush(stdout);
+
+    const bool clean = server.Run();
+    running = nullptr;
+    PrintStats(server.Stats(), server.Vehicles());
+    if (!clean) {
+        std::perror("epoll_wait");
+        return 1;
+    }
+    return 0;
+}
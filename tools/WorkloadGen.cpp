@@ -0,0 +1,113 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "WorkloadGenerator.hpp"
+
+namespace
+{
+struct Options
+{
+    adas::WorkloadConfig config;
+    std::uint64_t length{1 << 20};
+    unsigned threads{0};
+    std::string output;  // 为空时写到标准输出
+};
+
+[[noreturn]] void Usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--length=N[K|M|G]] [--seed=N] [--mix=M,L,R,F,B] [--run-length=X]\n"
+                 "          [--switch-rate=P] [--bus-share=P] [--tr-rate=P] [--junk-rate=P]\n"
+                 "          [--threads=N] [--output=path]\n",
+                 program);
+    std::exit(1);
+}
+
+std::uint64_t ParseLength(const char* text)
+{
+    char* end = nullptr;
+    std::uint64_t value = std::strtoull(text, &end, 10);
+    switch (*end) {
+    case 'K':
+        value <<= 10;
+        break;
+    case 'M':
+        value <<= 20;
+        break;
+    case 'G':
+        value <<= 30;
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+bool ParseMix(const char* text, adas::OpcodeMix& mix)
+{
+    double* weights[] = {&mix.move, &mix.left, &mix.right, &mix.fast, &mix.back};
+    for (double* weight : weights) {
+        char* end = nullptr;
+        *weight = std::strtod(text, &end);
+        if (end == text) {
+            return false;
+        }
+        text = (*end == ',') ? end + 1 : end;
+    }
+    return *text == '\0';
+}
+
+Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const std::size_t equal = arg.find('=');
+        if (equal == std::string::npos) {
+            Usage(argv[0]);
+        }
+        const std::string name = arg.substr(0, equal);
+        const char* value = argv[i] + equal + 1;
+        if (name == "--length") {
+            options.length = ParseLength(value);
+        } else if (name == "--seed") {
+            options.config.seed = std::strtoull(value, nullptr, 10);
+        } else if (name == "--mix") {
+            if (!ParseMix(value, options.config.mix)) {
+                Usage(argv[0]);
+            }
+        } else if (name == "--run-length") {
+            options.config.meanRunLength = std::atof(value);
+        } else if (name == "--switch-rate") {
+            options.config.carTypeSwitchRate = std::atof(value);
+        } else if (name == "--bus-share") {
+            options.config.busShare = std::atof(value);
+        } else if (name == "--tr-rate") {
+            options.config.turnRoundRate = std::atof(value);
+        } else if (name == "--junk-rate") {
+            options.config.junkRate = std::atof(value);
+        } else if (name == "--threads") {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (name == "--output") {
+            options.output = value;
+        } else {
+            Usage(argv[0]);
+        }
+    }
+    return options;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const Options options = ParseOptions(argc, argv);
+    const adas::WorkloadGenerator generator(options.config);
+    const bool written = options.output.empty() ? generator.Write(stdout, options.length, options.threads)
+                                                : generator.WriteFile(options.output, options.length, options.threads);
+    if (!written) {
+        std::fprintf(stderr, "failed to write %llu commands\n", static_cast<unsigned long long>(options.length));
+        return 1;
+    }
+    return 0;
+}